@@ -0,0 +1,212 @@
+#pragma once
+// Frame reader of `LinBusListener`. Member templates for the PID handler (`Handler`) and the checksum model
+// (`CLASSIC`), so both are resolved at compile time on the UART path. Include this header in the translation unit
+// that calls `use_lin_reader_`.
+#include "LinBusListener.h"
+#include "helpers.h"
+
+#ifndef QUEUE_WAIT_DONT_BLOCK
+#define QUEUE_WAIT_DONT_BLOCK (TickType_t) 0
+#endif
+
+namespace esphome {
+namespace truma_inetbox {
+
+// Add a seed to an inverted `data_checksum` result (sum with carry, same as adding it byte by byte).
+static inline u_int8_t checksum_add(u_int8_t sum, u_int8_t seed) {
+  uint16_t result = (uint16_t) sum + seed;
+  return result >= 256 ? result - 255 : result;
+}
+
+#ifdef USE_RP2040
+template<typename Handler, bool CLASSIC> void LinBusListener::read_rx_ring_() {
+  LIN_RX_BYTE *rx;
+  while ((rx = this->rx_ring_.read_slot()) != nullptr) {
+    if (rx->lin_break) {
+      // A break always starts a new frame, even if the previous one did not run into the timeout.
+      this->current_state_ = READ_STATE_BREAK;
+    }
+    this->read_lin_frame_<Handler, CLASSIC>(rx->data, rx->time);
+    this->last_data_recieved_ = rx->time;
+    this->rx_ring_.release();
+  }
+}
+#else
+template<typename Handler, bool CLASSIC>
+void LinBusListener::read_lin_bytes_(const u_int8_t *buf, size_t len, uint32_t current, uint32_t step) {
+  for (size_t i = 0; i < len; i++) {
+    this->read_lin_frame_<Handler, CLASSIC>(buf[i], current);
+    this->last_data_recieved_ = current;
+    current += step;
+  }
+}
+#endif  // USE_RP2040
+
+template<typename Handler, bool CLASSIC> void LinBusListener::read_lin_frame_(u_int8_t buf, uint32_t current) {
+  QUEUE_LOG_MSG log_msg = QUEUE_LOG_MSG();
+
+  // Wrap safe, `micros()` wraps after ~71 minutes.
+  if (this->current_state_ == READ_STATE_DATA && current - this->last_data_recieved_ > this->time_per_first_byte_) {
+    // timeout occured. This byte starts the next frame.
+    this->current_state_ = READ_STATE_BREAK;
+  }
+
+  switch (this->current_state_) {
+    case READ_STATE_BREAK:
+      // Check if there was an unanswered message before break.
+      if (this->current_PID_with_parity_ != 0x00 && this->current_PID_ != 0x00 && this->current_data_valid) {
+        if (this->current_data_count_ < 8) {
+          log_msg.current_PID = this->current_PID_;
+          if (this->current_PID_order_answered_) {
+            // Expectation is that I can see an echo of my data from the lin driver chip.
+            log_msg.type = QUEUE_LOG_MSG_TYPE::ERROR_READ_LIN_FRAME_UNABLE_TO_ANSWER;
+          } else {
+            log_msg.type = QUEUE_LOG_MSG_TYPE::ERROR_READ_LIN_FRAME_LOST_MSG;
+            for (u_int8_t i = 0; i < this->current_data_count_; i++) {
+              log_msg.data[i] = this->current_data_[i];
+            }
+            log_msg.len = this->current_data_count_;
+          }
+          TRUMA_LOGE_ISR(log_msg);
+        }
+      }
+
+      // Reset current state
+      this->current_state_reset_();
+
+      // First is Break expected. Arduino platform does not relay BREAK if send as special.
+      if (buf != LIN_BREAK && buf != LIN_SYNC) {
+        log_msg.type = QUEUE_LOG_MSG_TYPE::VV_READ_LIN_FRAME_BREAK_EXPECTED;
+        log_msg.current_PID = buf;
+        TRUMA_LOGVV_ISR(log_msg);
+      } else {
+        if (buf == LIN_BREAK) {
+          // ESP_LOGVV(TAG, "%02X BREAK received.", buf);
+          this->current_state_ = READ_STATE_SYNC;
+        } else if (buf == LIN_SYNC) {
+          // ESP_LOGVV(TAG, "%02X SYNC found.", buf);
+          this->current_state_ = READ_STATE_SID;
+        }
+      }
+      break;
+    case READ_STATE_SYNC:
+      // Second is Sync expected
+      if (buf != LIN_SYNC) {
+        log_msg.type = QUEUE_LOG_MSG_TYPE::VV_READ_LIN_FRAME_SYNC_EXPECTED;
+        log_msg.current_PID = buf;
+        TRUMA_LOGVV_ISR(log_msg);
+        this->current_state_ = buf == LIN_BREAK ? READ_STATE_SYNC : READ_STATE_BREAK;
+      } else {
+        // ESP_LOGVV(TAG, "%02X SYNC found.", buf);
+        this->current_state_ = READ_STATE_SID;
+      }
+      break;
+    case READ_STATE_SID:
+      this->pid_recieved_ = current;
+      this->current_PID_with_parity_ = buf;
+      this->current_PID_ = this->current_PID_with_parity_ & 0x3F;
+      if (!CLASSIC) {
+        if (this->current_PID_with_parity_ != (this->current_PID_ | (addr_parity(this->current_PID_) << 6))) {
+          log_msg.type = QUEUE_LOG_MSG_TYPE::WARN_READ_LIN_FRAME_SID_CRC;
+          log_msg.current_PID = this->current_PID_with_parity_;
+          TRUMA_LOGW_ISR(log_msg);
+          this->current_data_valid = false;
+        }
+      }
+
+      // Decide the checksum model once per frame. Diagnostic frames always use the classic checksum.
+      this->current_checksum_classic_ =
+          CLASSIC || this->current_PID_ == DIAGNOSTIC_FRAME_MASTER || this->current_PID_ == DIAGNOSTIC_FRAME_SLAVE;
+
+      if (this->current_data_valid) {
+        // Should I response to this PID order? Resolved at compile time for `Handler`.
+        this->pid_handlers_[this->current_PID_].requests++;
+        const LinBusResponse *response = static_cast<Handler *>(this)->lin_response_(this->current_PID_);
+        if (response != nullptr) {
+          this->write_lin_response_(response);
+        }
+      }
+
+      // Even on error read data.
+      this->current_state_ = READ_STATE_DATA;
+      break;
+    case READ_STATE_DATA:
+      this->current_data_[this->current_data_count_] = buf;
+      this->current_data_count_++;
+
+      if (this->current_data_count_ >= sizeof(this->current_data_)) {
+        // End of data reached. There cannot be more than 9 bytes in a LIN frame.
+        this->current_state_ = READ_STATE_ACT;
+      }
+      break;
+    default:
+      break;
+  }
+
+  if (this->current_state_ == READ_STATE_ACT && this->current_data_count_ > 1) {
+    u_int8_t data_length = this->current_data_count_ - 1;
+    u_int8_t data_CRC = this->current_data_[this->current_data_count_ - 1];
+    // Only logged.
+    [[maybe_unused]] bool message_source_know = false;
+    bool message_from_master = true;
+
+    // Sum the data once, the PID variants below only add their seed.
+    u_int8_t data_sum = ~data_checksum(this->current_data_, data_length, 0);
+
+    if (this->current_checksum_classic_) {
+      if (data_CRC != (u_int8_t) ~data_sum) {
+        log_msg.type = QUEUE_LOG_MSG_TYPE::WARN_READ_LIN_FRAME_LINv1_CRC;
+        TRUMA_LOGW_ISR(log_msg);
+        this->current_data_valid = false;
+      }
+      if (this->current_PID_ == DIAGNOSTIC_FRAME_MASTER) {
+        message_source_know = true;
+        message_from_master = true;
+      } else if (this->current_PID_ == DIAGNOSTIC_FRAME_SLAVE) {
+        message_source_know = true;
+        message_from_master = false;
+      }
+    } else {
+      u_int8_t data_CRC_master = ~checksum_add(data_sum, this->current_PID_);
+      u_int8_t data_CRC_slave = ~checksum_add(data_sum, this->current_PID_with_parity_);
+      if (data_CRC != data_CRC_master && data_CRC != data_CRC_slave) {
+        log_msg.type = QUEUE_LOG_MSG_TYPE::WARN_READ_LIN_FRAME_LINv2_CRC;
+        TRUMA_LOGW_ISR(log_msg);
+        this->current_data_valid = false;
+      }
+      message_source_know = true;
+      if (data_CRC == data_CRC_slave) {
+        message_from_master = false;
+      }
+    }
+
+#ifdef ESPHOME_LOG_HAS_VERBOSE
+    log_msg.type = QUEUE_LOG_MSG_TYPE::VERBOSE_READ_LIN_FRAME_MSG;
+    log_msg.current_PID = this->current_PID_;
+    for (u_int8_t i = 0; i < this->current_data_count_; i++) {
+      log_msg.data[i] = this->current_data_[i];
+    }
+    log_msg.len = this->current_data_count_;
+    log_msg.current_data_valid = this->current_data_valid;
+    log_msg.message_source_know = message_source_know;
+    log_msg.message_from_master = message_from_master;
+    TRUMA_LOGV_ISR(log_msg);
+#endif  // ESPHOME_LOG_HAS_VERBOSE
+
+    if (this->current_data_valid && message_from_master) {
+      // Fill the ring entry in place. If it is full the message is counted as dropped.
+      QUEUE_LIN_MSG *lin_msg = this->lin_msg_ring_.write_slot();
+      if (lin_msg != nullptr) {
+        lin_msg->current_PID = this->current_PID_;
+        lin_msg->len = this->current_data_count_ - 1;
+        memcpy(lin_msg->data, this->current_data_, lin_msg->len);
+        this->lin_msg_ring_.commit();
+        this->notify_event_task_(LIN_EVENT_LIN_MSG);
+      }
+    }
+    this->current_state_ = READ_STATE_BREAK;
+  }
+}
+
+}  // namespace truma_inetbox
+}  // namespace esphome
@@ -1,4 +1,5 @@
 #include "LinBusListener.h"
+#include "LinBusFrameReader.h"
 #include "esphome/core/helpers.h"
 #include "esphome/core/log.h"
 #include "helpers.h"
@@ -22,11 +23,8 @@ namespace truma_inetbox {
 
 static const char *const TAG = "truma_inetbox.LinBusListener";
 
-#define LIN_BREAK 0x00
-#define LIN_SYNC 0x55
-#define DIAGNOSTIC_FRAME_MASTER 0x3c
-#define DIAGNOSTIC_FRAME_SLAVE 0x3d
-#define QUEUE_WAIT_DONT_BLOCK (TickType_t) 0
+// Bytes fetched from the UART buffer per `read_array` call. A full LIN frame (sync, PID, 8 data, CRC) fits.
+#define LIN_RX_BATCH 16
 
 void LinBusListener::dump_config() {
   ESP_LOGCONFIG(TAG, "LinBusListener:");
@@ -35,6 +33,7 @@ void LinBusListener::dump_config() {
   LOG_UPDATE_INTERVAL(this);
   ESP_LOGCONFIG(TAG, "  LIN checksum Version: %d", this->lin_checksum_ == LIN_CHECKSUM::LIN_CHECKSUM_VERSION_1 ? 1 : 2);
   ESP_LOGCONFIG(TAG, "  Observer mode: %s", YESNO(this->observer_mode_));
+  ESP_LOGCONFIG(TAG, "  Response space: %u us", (unsigned) this->response_space_us_);
   this->check_uart_settings(9600, 2, esphome::uart::UART_CONFIG_PARITY_NONE, 8);
 }
 
@@ -54,16 +53,22 @@ void LinBusListener::setup() {
     this->fault_pin_->setup();
   }
 
+  this->select_lin_reader_();
+
   // call device specific function
   this->setup_framework();
 
 #if ESPHOME_LOG_LEVEL > ESPHOME_LOG_LEVEL_NONE
   assert(this->log_queue_ != 0);
 
-  // Register interval to submit log messages
+#ifdef USE_RP2040
+  // No event task on RP2040. Register interval to submit log messages.
   this->set_interval("logmsg", 50, [this]() { this->process_log_queue(QUEUE_WAIT_DONT_BLOCK); });
+#endif  // USE_RP2040
 #endif  // ESPHOME_LOG_LEVEL > ESPHOME_LOG_LEVEL_NONE
 
+  this->set_interval("response_offsets", 60 * 1000 /* 1 minute */, [this]() { this->log_response_offsets_(); });
+
   if (this->cs_pin_ != nullptr) {
     // Enable LIN driver if not in oberserver mode.
     this->cs_pin_->digital_write(!this->observer_mode_);
@@ -72,51 +77,90 @@ void LinBusListener::setup() {
 
 void LinBusListener::update() { this->check_for_lin_fault_(); }
 
-void LinBusListener::write_lin_answer_(const u_int8_t *data, u_int8_t len) {
-  QUEUE_LOG_MSG log_msg = QUEUE_LOG_MSG();
-  if (!this->can_write_lin_answer_) {
-    log_msg.type = QUEUE_LOG_MSG_TYPE::ERROR_LIN_ANSWER_CAN_WRITE_LIN_ANSWER;
-    TRUMA_LOGE(log_msg);
-    return;
-  }
-  this->can_write_lin_answer_ = false;
-  if (len > 8) {
-    log_msg.type = QUEUE_LOG_MSG_TYPE::ERROR_LIN_ANSWER_TOO_LONG;
-    TRUMA_LOGE(log_msg);
-    return;
-  }
+void LinBusListener::select_lin_reader_() { this->use_lin_reader_<LinBusListener>(); }
 
-  u_int8_t data_CRC = 0;
-  if (this->lin_checksum_ == LIN_CHECKSUM::LIN_CHECKSUM_VERSION_1 || this->current_PID_ == DIAGNOSTIC_FRAME_SLAVE) {
+void LinBusListener::register_lin_response_(u_int8_t pid, lin_response_provider_t provider) {
+  this->pid_handlers_[pid & 0x3F].provider = provider;
+}
+
+bool LinBusListener::prepare_lin_response_(LinBusResponse *response, u_int8_t pid, const u_int8_t *data,
+                                           u_int8_t len) const {
+  if (len > sizeof(response->data)) {
+    ESP_LOGE(TAG, "LIN answer cannot be longer than 8 bytes.");
+    return false;
+  }
+  pid &= 0x3F;
+  memcpy(response->data, data, len);
+  response->len = len;
+  if (this->lin_checksum_ == LIN_CHECKSUM::LIN_CHECKSUM_VERSION_1 || pid == DIAGNOSTIC_FRAME_MASTER ||
+      pid == DIAGNOSTIC_FRAME_SLAVE) {
     // LIN checksum V1
-    data_CRC = data_checksum(data, len, 0);
+    response->crc = data_checksum(data, len, 0);
   } else {
     // LIN checksum V2
-    data_CRC = data_checksum(data, len, this->current_PID_with_parity_);
+    response->crc = data_checksum(data, len, pid | (addr_parity(pid) << 6));
   }
+  return true;
+}
 
-  // I am answering too quick ~50-60us after stop bit. Normal communication has a ~100us pause (second stop bits).
-  // The heater is answering after ~500-600us.
-  // If there is any issue I might have to add a delay here.
-  // Check when last byte was read from buffer and wait at least one baud time.
-  // It is working when I answer quicker.
-
+void LinBusListener::write_lin_response_(const LinBusResponse *response) {
   if (!this->observer_mode_) {
+    // Real devices answer ~500-600us after the PID stop bit, I would answer after ~50-60us. Hold the answer until
+    // the configured response space has passed. The slot is short (config limits it to 1ms), so busy wait instead of
+    // a task delay that is only accurate to a tick. On ESP-IDF this blocks the UART task of all LIN buses; the UART
+    // driver buffers the bytes of the other bus meanwhile and their arrival is estimated in `onReceive_`.
+    uint32_t elapsed = micros() - this->pid_recieved_;
+    if (elapsed < this->response_space_us_) {
+      delayMicroseconds(this->response_space_us_ - elapsed);
+    }
+
     this->current_PID_order_answered_ = true;
-    this->write_array(data, len);
-    this->write(data_CRC);
+    this->write_array(response->data, response->len);
+    // The answer is in the TX FIFO and goes out now. This is the achieved response space.
+    uint32_t offset = micros() - this->pid_recieved_;
+    this->write(response->crc);
+
+    this->response_offsets_.add(offset);
+    LinBusPidHandler *handler = &this->pid_handlers_[this->current_PID_];
+    handler->answers++;
+    if (offset > handler->max_response_us) {
+      handler->max_response_us = offset;
+    }
   }
 
+  QUEUE_LOG_MSG log_msg = QUEUE_LOG_MSG();
   log_msg.type = QUEUE_LOG_MSG_TYPE::VERBOSE_LIN_ANSWER_RESPONSE;
   log_msg.current_PID = this->current_PID_;
-  for (u_int8_t i = 0; i < len; i++) {
-    log_msg.data[i] = data[i];
-  }
-  log_msg.data[len] = data_CRC;
-  log_msg.len = len++;
+  memcpy(log_msg.data, response->data, response->len);
+  log_msg.data[response->len] = response->crc;
+  log_msg.len = response->len + 1;
   TRUMA_LOGV(log_msg);
 }
 
+void LinBusListener::log_response_offsets_() {
+  const LinBusResponseHistogram &hist = this->response_offsets_;
+  uint32_t count = hist.count;
+  if (count == this->response_offsets_reported_) {
+    return;
+  }
+  this->response_offsets_reported_ = count;
+  char line[TRUMA_RESPONSE_HISTOGRAM_BUCKETS * 11 + 1];
+  size_t pos = 0;
+  for (u_int8_t i = 0; i < TRUMA_RESPONSE_HISTOGRAM_BUCKETS && pos < sizeof(line); i++) {
+    pos += snprintf(&line[pos], sizeof(line) - pos, " %u", (unsigned) hist.buckets[i]);
+  }
+  ESP_LOGD(TAG, "Response offset (%u answers, avg %u us, max %u us, %u us buckets):%s", (unsigned) count,
+           (unsigned) (hist.sum_us / count), (unsigned) hist.max_us, (unsigned) TRUMA_RESPONSE_HISTOGRAM_BUCKET_US,
+           line);
+  for (u_int8_t pid = 0; pid < 64; pid++) {
+    const LinBusPidHandler &handler = this->pid_handlers_[pid];
+    if (handler.answers > 0) {
+      ESP_LOGD(TAG, "  PID %02X: %u requests, %u answers, max %u us", pid, (unsigned) handler.requests,
+               (unsigned) handler.answers, (unsigned) handler.max_response_us);
+    }
+  }
+}
+
 bool LinBusListener::check_for_lin_fault_() {
   // Check if Lin Bus is faulty.
   if (this->fault_pin_ != nullptr) {
@@ -152,204 +196,121 @@ bool LinBusListener::check_for_lin_fault_() {
   }
 }
 
-void LinBusListener::onReceive_() {
-  if (!this->check_for_lin_fault_()) {
-    while (this->available()) {
-      this->read_lin_frame_();
-      this->last_data_recieved_ = micros();
-    }
+#ifndef USE_RP2040
+void LinBusListener::onReceive_(uint32_t received) {
+  if (this->check_for_lin_fault_()) {
+    return;
   }
-}
-
-void LinBusListener::read_lin_frame_() {
-  u_int8_t buf;
-  QUEUE_LOG_MSG log_msg = QUEUE_LOG_MSG();
-
-  switch (this->current_state_) {
-    case READ_STATE_BREAK:
-      // Check if there was an unanswered message before break.
-      if (this->current_PID_with_parity_ != 0x00 && this->current_PID_ != 0x00 && this->current_data_valid) {
-        if (this->current_data_count_ < 8) {
-          log_msg.current_PID = this->current_PID_;
-          if (this->current_PID_order_answered_) {
-            // Expectation is that I can see an echo of my data from the lin driver chip.
-            log_msg.type = QUEUE_LOG_MSG_TYPE::ERROR_READ_LIN_FRAME_UNABLE_TO_ANSWER;
-          } else {
-            log_msg.type = QUEUE_LOG_MSG_TYPE::ERROR_READ_LIN_FRAME_LOST_MSG;
-            for (u_int8_t i = 0; i < this->current_data_count_; i++) {
-              log_msg.data[i] = this->current_data_[i];
-            }
-            log_msg.len = this->current_data_count_;
-          }
-          TRUMA_LOGE_ISR(log_msg);
-        }
-      }
-
-      // Reset current state
-      this->current_state_reset_();
-
-      // First is Break expected. Arduino platform does not relay BREAK if send as special.
-      if (!this->read_byte(&buf) || (buf != LIN_BREAK && buf != LIN_SYNC)) {
-        log_msg.type = QUEUE_LOG_MSG_TYPE::VV_READ_LIN_FRAME_BREAK_EXPECTED;
-        log_msg.current_PID = buf;
-        TRUMA_LOGVV_ISR(log_msg);
-      } else {
-        if (buf == LIN_BREAK) {
-          // ESP_LOGVV(TAG, "%02X BREAK received.", buf);
-          this->current_state_ = READ_STATE_SYNC;
-        } else if (buf == LIN_SYNC) {
-          // ESP_LOGVV(TAG, "%02X SYNC found.", buf);
-          this->current_state_ = READ_STATE_SID;
-        }
-      }
-      break;
-    case READ_STATE_SYNC:
-      // Second is Sync expected
-      if (!this->read_byte(&buf) || buf != LIN_SYNC) {
-        log_msg.type = QUEUE_LOG_MSG_TYPE::VV_READ_LIN_FRAME_SYNC_EXPECTED;
-        log_msg.current_PID = buf;
-        TRUMA_LOGVV_ISR(log_msg);
-        this->current_state_ = buf == LIN_BREAK ? READ_STATE_SYNC : READ_STATE_BREAK;
-      } else {
-        // ESP_LOGVV(TAG, "%02X SYNC found.", buf);
-        this->current_state_ = READ_STATE_SID;
-      }
-      break;
-    case READ_STATE_SID:
-      this->read_byte(&(this->current_PID_with_parity_));
-      this->current_PID_ = this->current_PID_with_parity_ & 0x3F;
-      if (this->lin_checksum_ == LIN_CHECKSUM::LIN_CHECKSUM_VERSION_2) {
-        if (this->current_PID_with_parity_ != (this->current_PID_ | (addr_parity(this->current_PID_) << 6))) {
-          log_msg.type = QUEUE_LOG_MSG_TYPE::WARN_READ_LIN_FRAME_SID_CRC;
-          log_msg.current_PID = this->current_PID_with_parity_;
-          TRUMA_LOGW_ISR(log_msg);
-          this->current_data_valid = false;
-        }
-      }
-
-      if (this->current_data_valid) {
-        this->can_write_lin_answer_ = true;
-
-        // Should I response to this PID order? Ask the handling class.
-        this->answer_lin_order_(this->current_PID_);
-        this->can_write_lin_answer_ = false;
-      }
-
-      // Even on error read data.
-      this->current_state_ = READ_STATE_DATA;
-      break;
-    case READ_STATE_DATA: {
-      auto current = micros();
-      if (current > (this->last_data_recieved_ + this->time_per_first_byte_)) {
-        // timeout occured.
-        this->current_state_ = READ_STATE_BREAK;
+  // Drain the UART in batches. `available()` and `read_byte()` each take the UART component lock, doing that per
+  // byte costs two lock round trips per LIN byte in the highest priority task.
+  u_int8_t buf[LIN_RX_BATCH];
+  const uint32_t byte_time = this->time_per_baud_ * this->frame_length_;
+  int available = this->available();
+  while (available > 0) {
+    // The waiting bytes arrived back to back, the last one just before `received`. Estimate the arrival of each byte
+    // from there, so the PID time does not depend on its position in the batch. If the reader was late and the bus
+    // idle meanwhile, the estimate is late, never early.
+    uint32_t current = received - (available - 1) * byte_time;
+    if ((int32_t) (current - this->last_data_recieved_) < 0) {
+      // Not before the bytes already read.
+      current = this->last_data_recieved_;
+    }
+    while (available > 0) {
+      size_t len = available > LIN_RX_BATCH ? LIN_RX_BATCH : available;
+      if (!this->read_array(buf, len)) {
         return;
       }
-      this->read_byte(&buf);
-      this->current_data_[this->current_data_count_] = buf;
-      this->current_data_count_++;
+      (this->*lin_reader_)(buf, len, current, byte_time);
+      current += len * byte_time;
+      available -= len;
+    }
+    // Bytes that arrived while reading.
+    received = micros();
+    available = this->available();
+  }
+}
+#endif  // USE_RP2040
 
-      if (this->current_data_count_ >= sizeof(this->current_data_)) {
-        // End of data reached. There cannot be more than 9 bytes in a LIN frame.
-        this->current_state_ = READ_STATE_ACT;
-      }
+void LinBusListener::clear_uart_buffer_() {
+#ifdef USE_RP2040
+  // The UART IRQ moves the bytes into `rx_ring_`. Only its consumer may drop them.
+  this->rx_ring_flush_ = true;
+#endif  // USE_RP2040
+  u_int8_t buffer[LIN_RX_BATCH];
+  int available;
+  while ((available = this->available()) > 0) {
+    if (!this->read_array(buffer, available > LIN_RX_BATCH ? LIN_RX_BATCH : available)) {
       break;
     }
-    default:
-      break;
   }
+}
 
-  if (this->current_state_ == READ_STATE_ACT && this->current_data_count_ > 1) {
-    u_int8_t data_length = this->current_data_count_ - 1;
-    u_int8_t data_CRC = this->current_data_[this->current_data_count_ - 1];
-    bool message_source_know = false;
-    bool message_from_master = true;
-
-    if (this->lin_checksum_ == LIN_CHECKSUM::LIN_CHECKSUM_VERSION_1 ||
-        (this->current_PID_ == DIAGNOSTIC_FRAME_MASTER || this->current_PID_ == DIAGNOSTIC_FRAME_SLAVE)) {
-      if (data_CRC != data_checksum(this->current_data_, data_length, 0)) {
-        log_msg.type = QUEUE_LOG_MSG_TYPE::WARN_READ_LIN_FRAME_LINv1_CRC;
-        TRUMA_LOGW_ISR(log_msg);
-        this->current_data_valid = false;
-      }
-      if (this->current_PID_ == DIAGNOSTIC_FRAME_MASTER) {
-        message_source_know = true;
-        message_from_master = true;
-      } else if (this->current_PID_ == DIAGNOSTIC_FRAME_SLAVE) {
-        message_source_know = true;
-        message_from_master = false;
-      }
-    } else {
-      u_int8_t data_CRC_master = data_checksum(this->current_data_, data_length, this->current_PID_);
-      u_int8_t data_CRC_slave = data_checksum(this->current_data_, data_length, this->current_PID_with_parity_);
-      if (data_CRC != data_CRC_master && data_CRC != data_CRC_slave) {
-        log_msg.type = QUEUE_LOG_MSG_TYPE::WARN_READ_LIN_FRAME_LINv2_CRC;
-        TRUMA_LOGW_ISR(log_msg);
-        this->current_data_valid = false;
-      }
-      message_source_know = true;
-      if (data_CRC == data_CRC_slave) {
-        message_from_master = false;
-      }
-    }
+void LinBusListener::process_lin_msg_queue() {
+  QUEUE_LIN_MSG *lin_msg;
+  while ((lin_msg = this->lin_msg_ring_.read_slot()) != nullptr) {
+    this->lin_message_recieved_(lin_msg->current_PID, lin_msg->data, lin_msg->len);
+    this->lin_msg_ring_.release();
+  }
+  this->lin_messages_processed_();
+}
 
-#ifdef ESPHOME_LOG_HAS_VERBOSE
-    log_msg.type = QUEUE_LOG_MSG_TYPE::VERBOSE_READ_LIN_FRAME_MSG;
-    log_msg.current_PID = this->current_PID_;
-    for (u_int8_t i = 0; i < this->current_data_count_; i++) {
-      log_msg.data[i] = this->current_data_[i];
+void LinBusListener::process_events(TickType_t xTicksToWait) {
+  // Drain first: anything queued before the event task started has no notification.
+  uint32_t events = LIN_EVENT_LIN_MSG | LIN_EVENT_LOG_MSG;
+  do {
+    // Log first, the LIN message handlers log as well and should come after the bus messages.
+    if (events & LIN_EVENT_LOG_MSG) {
+      this->process_log_queue(QUEUE_WAIT_DONT_BLOCK);
     }
-    log_msg.len = this->current_data_count_;
-    log_msg.current_data_valid = this->current_data_valid;
-    log_msg.message_source_know = message_source_know;
-    log_msg.message_from_master = message_from_master;
-    TRUMA_LOGV_ISR(log_msg);
-#endif  // ESPHOME_LOG_HAS_VERBOSE
-
-    if (this->current_data_valid && message_from_master) {
-      QUEUE_LIN_MSG lin_msg;
-      lin_msg.current_PID = this->current_PID_;
-      lin_msg.len = this->current_data_count_ - 1;
-      for (u_int8_t i = 0; i < lin_msg.len; i++) {
-        lin_msg.data[i] = this->current_data_[i];
-      }
-      xQueueSendFromISR(this->lin_msg_queue_, (void *) &lin_msg, QUEUE_WAIT_DONT_BLOCK);
+    if (events & LIN_EVENT_LIN_MSG) {
+      this->process_lin_msg_queue();
     }
-    this->current_state_ = READ_STATE_BREAK;
-  }
+    // Bits set while draining stay pending, so nothing is missed between the drain and the wait.
+  } while (xTaskNotifyWait(0, UINT32_MAX, &events, xTicksToWait) == pdTRUE);
 }
 
-void LinBusListener::clear_uart_buffer_() {
-  u_int8_t buffer;
-  while (this->available() && this->read_byte(&buffer)) {
+#if ESPHOME_LOG_LEVEL > ESPHOME_LOG_LEVEL_NONE
+// `format_hex_pretty` into a caller buffer instead of a heap allocated `std::string`: "AA.BB.CC (3)".
+static const char *format_hex_pretty_to(char *buf, size_t buf_len, const u_int8_t *data, u_int8_t len) {
+  static const char *const HEX_CHARS = "0123456789ABCDEF";
+  size_t pos = 0;
+  buf[0] = '\0';
+  if (len == 0) {
+    return buf;
   }
-}
-
-void LinBusListener::process_lin_msg_queue(TickType_t xTicksToWait) {
-  QUEUE_LIN_MSG lin_msg;
-  while (xQueueReceive(this->lin_msg_queue_, &lin_msg, xTicksToWait) == pdPASS) {
-    this->lin_message_recieved_(lin_msg.current_PID, lin_msg.data, lin_msg.len);
+  // Keep room for "." + 2 digits and the " (nn)" suffix.
+  for (u_int8_t i = 0; i < len && pos + 3 + 6 < buf_len; i++) {
+    if (i > 0) {
+      buf[pos++] = '.';
+    }
+    buf[pos++] = HEX_CHARS[data[i] >> 4];
+    buf[pos++] = HEX_CHARS[data[i] & 0x0F];
   }
+  snprintf(buf + pos, buf_len - pos, " (%u)", len);
+  return buf;
 }
+#endif  // ESPHOME_LOG_LEVEL > ESPHOME_LOG_LEVEL_NONE
 
 void LinBusListener::process_log_queue(TickType_t xTicksToWait) {
 #if ESPHOME_LOG_LEVEL > ESPHOME_LOG_LEVEL_NONE
   QUEUE_LOG_MSG log_msg;
+  // 9 data bytes as "AA." plus " (9)"
+  char hex[40];
+  uint32_t dropped = this->log_msg_dropped_;
+  if (dropped != this->log_msg_dropped_reported_) {
+    ESP_LOGW(TAG, "%u log messages dropped (log queue full).", (unsigned) (dropped - this->log_msg_dropped_reported_));
+    this->log_msg_dropped_reported_ = dropped;
+  }
   while (xQueueReceive(this->log_queue_, &log_msg, xTicksToWait) == pdPASS) {
     auto current_PID = log_msg.current_PID;
     switch (log_msg.type) {
-      case QUEUE_LOG_MSG_TYPE::ERROR_LIN_ANSWER_CAN_WRITE_LIN_ANSWER:
-        ESP_LOGE(TAG, "Cannot answer LIN because there is no open order from master.");
-        break;
-      case QUEUE_LOG_MSG_TYPE::ERROR_LIN_ANSWER_TOO_LONG:
-        ESP_LOGE(TAG, "LIN answer cannot be longer than 8 bytes.");
-        break;
       case QUEUE_LOG_MSG_TYPE::VERBOSE_LIN_ANSWER_RESPONSE:
         if (!this->observer_mode_) {
-          ESP_LOGV(TAG, "RESPONSE %02X %s", current_PID, format_hex_pretty(log_msg.data, log_msg.len).c_str());
+          ESP_LOGV(TAG, "RESPONSE %02X %s", current_PID,
+                   format_hex_pretty_to(hex, sizeof(hex), log_msg.data, log_msg.len));
         } else {
           ESP_LOGV(TAG, "RESPONSE %02X %s - NOT SEND (OBSERVER MODE)", current_PID,
-                   format_hex_pretty(log_msg.data, log_msg.len).c_str());
+                   format_hex_pretty_to(hex, sizeof(hex), log_msg.data, log_msg.len));
         }
         break;
       case QUEUE_LOG_MSG_TYPE::ERROR_CHECK_FOR_LIN_FAULT_DETECTED:
@@ -366,7 +327,7 @@ void LinBusListener::process_log_queue(TickType_t xTicksToWait) {
           ESP_LOGV(TAG, "PID %02X      order no answer", current_PID);
         } else if (log_msg.len < 8) {
           ESP_LOGW(TAG, "PID %02X      %s partial data received", current_PID,
-                   format_hex_pretty(log_msg.data, log_msg.len).c_str());
+                   format_hex_pretty_to(hex, sizeof(hex), log_msg.data, log_msg.len));
         }
         break;
       case QUEUE_LOG_MSG_TYPE::VV_READ_LIN_FRAME_BREAK_EXPECTED:
@@ -389,11 +350,13 @@ void LinBusListener::process_log_queue(TickType_t xTicksToWait) {
         if (current_PID == 0x20 || current_PID == 0x21 || current_PID == 0x22 ||
             ((current_PID == DIAGNOSTIC_FRAME_MASTER || current_PID == DIAGNOSTIC_FRAME_SLAVE) &&
              log_msg.data[0] == 0x01 /* ID of heater */)) {
-          ESP_LOGVV(TAG, "PID %02X      %s %s %s", current_PID_, format_hex_pretty(log_msg.data, log_msg.len).c_str(),
+          ESP_LOGVV(TAG, "PID %02X      %s %s %s", current_PID,
+                    format_hex_pretty_to(hex, sizeof(hex), log_msg.data, log_msg.len),
                     log_msg.message_source_know ? (log_msg.message_from_master ? " - MASTER" : " - SLAVE") : "",
                     log_msg.current_data_valid ? "" : "INVALID");
         } else {
-          ESP_LOGV(TAG, "PID %02X      %s %s %S", current_PID_, format_hex_pretty(log_msg.data, log_msg.len).c_str(),
+          ESP_LOGV(TAG, "PID %02X      %s %s %s", current_PID,
+                   format_hex_pretty_to(hex, sizeof(hex), log_msg.data, log_msg.len),
                    log_msg.message_source_know ? (log_msg.message_from_master ? " - MASTER" : " - SLAVE") : "",
                    log_msg.current_data_valid ? "" : "INVALID");
         }
@@ -405,11 +368,8 @@ void LinBusListener::process_log_queue(TickType_t xTicksToWait) {
 #endif  // ESPHOME_LOG_LEVEL > ESPHOME_LOG_LEVEL_NONE
 }
 
-#undef LIN_BREAK
-#undef LIN_SYNC
-#undef DIAGNOSTIC_FRAME_MASTER
-#undef DIAGNOSTIC_FRAME_SLAVE
 #undef QUEUE_WAIT_DONT_BLOCK
+#undef LIN_RX_BATCH
 
 }  // namespace truma_inetbox
 }  // namespace esphome
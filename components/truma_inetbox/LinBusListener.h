@@ -1,26 +1,63 @@
 #pragma once
 
 #include "LinBusLog.h"
+#include "LinBusRingBuffer.h"
 #include "esphome/core/component.h"
 #include "esphome/components/uart/uart.h"
 
-#ifdef USE_ESP32
+#if defined(USE_ESP32) || defined(USE_HOST)
 #include <freertos/FreeRTOS.h>
 #include <freertos/semphr.h>
-#endif  // USE_ESP32
+#endif  // USE_ESP32 || USE_HOST
 #ifdef USE_RP2040
 #include <hardware/uart.h>
 #include <FreeRTOS.h>
 #include <semphr.h>
 #include <queue.h>
+#include <task.h>
 #endif  // USE_RP2040
 
+// Received LIN messages waiting for the LIN message task. Must be a power of two.
+// A multi PDU request (up to 64 bytes) arrives as a burst of 11 frames on 0x3C.
 #ifndef  TRUMA_MSG_QUEUE_LENGTH
-#define TRUMA_MSG_QUEUE_LENGTH 6
+#define TRUMA_MSG_QUEUE_LENGTH 16
 #endif
+// Log messages from the UART task. Verbose logging queues up to 3 entries per frame (frame, response, lost message)
+// and the event task runs at low priority, so leave room for a multi PDU burst.
 #ifndef  TRUMA_LOG_QUEUE_LENGTH
-#define TRUMA_LOG_QUEUE_LENGTH 6
+#define TRUMA_LOG_QUEUE_LENGTH 32
+#endif
+// Diagnostic responses waiting for the master to poll them. Must be a power of two.
+// The largest multi frame answer (48 bytes) needs 9 entries.
+#ifndef  TRUMA_UPDATE_QUEUE_LENGTH
+#define TRUMA_UPDATE_QUEUE_LENGTH 16
+#endif
+#ifdef USE_ESP32_FRAMEWORK_ESP_IDF
+// LIN buses served by the shared UART reactor and LIN event task.
+#ifndef  TRUMA_MAX_LIN_BUSES
+#define TRUMA_MAX_LIN_BUSES 2
 #endif
+// Length of the UART event queue created by the ESPHome UART component (`uart_driver_install`).
+#ifndef  TRUMA_UART_EVENT_QUEUE_LENGTH
+#define TRUMA_UART_EVENT_QUEUE_LENGTH 20
+#endif
+#endif  // USE_ESP32_FRAMEWORK_ESP_IDF
+#ifdef USE_RP2040
+// Bytes received by the UART IRQ waiting for the core 1 loop. Must be a power of two.
+#ifndef  TRUMA_RX_RING_LENGTH
+#define TRUMA_RX_RING_LENGTH 64
+#endif
+#endif  // USE_RP2040
+// Width of one bucket in the response offset histogram.
+#ifndef  TRUMA_RESPONSE_HISTOGRAM_BUCKET_US
+#define TRUMA_RESPONSE_HISTOGRAM_BUCKET_US 100
+#endif
+#define TRUMA_RESPONSE_HISTOGRAM_BUCKETS 16
+
+#define LIN_BREAK 0x00
+#define LIN_SYNC 0x55
+#define DIAGNOSTIC_FRAME_MASTER 0x3c
+#define DIAGNOSTIC_FRAME_SLAVE 0x3d
 
 namespace esphome {
 namespace truma_inetbox {
@@ -33,6 +70,55 @@ struct QUEUE_LIN_MSG {
   u_int8_t len;
 };
 
+// Time between the received PID byte and the start of my answer. The last bucket collects everything above.
+// Written by the UART task without lock, only used as diagnostic.
+struct LinBusResponseHistogram {
+  uint32_t buckets[TRUMA_RESPONSE_HISTOGRAM_BUCKETS] = {};
+  uint32_t count = 0;
+  uint64_t sum_us = 0;
+  uint32_t max_us = 0;
+
+  void add(uint32_t offset_us) {
+    uint32_t bucket = offset_us / TRUMA_RESPONSE_HISTOGRAM_BUCKET_US;
+    this->buckets[bucket < TRUMA_RESPONSE_HISTOGRAM_BUCKETS ? bucket : TRUMA_RESPONSE_HISTOGRAM_BUCKETS - 1]++;
+    this->count++;
+    this->sum_us += offset_us;
+    if (offset_us > this->max_us) {
+      this->max_us = offset_us;
+    }
+  }
+};
+
+// Answer for one PID with the checksum calculated ahead of time (`prepare_lin_response_`), so the UART task only
+// has to write it out.
+struct LinBusResponse {
+  u_int8_t data[8];
+  u_int8_t len;
+  u_int8_t crc;
+};
+
+class LinBusListener;
+// Returns the answer for the PID just received or nullptr to stay silent. Called in the UART task, the answer must
+// stay valid until the call returns.
+typedef const LinBusResponse *(*lin_response_provider_t)(LinBusListener *listener);
+
+struct LinBusPidHandler {
+  lin_response_provider_t provider = nullptr;
+  // Written by the UART task without lock, only used as diagnostic.
+  uint32_t requests = 0;
+  uint32_t answers = 0;
+  uint32_t max_response_us = 0;
+};
+
+#ifdef USE_RP2040
+// One byte captured by the UART RX IRQ.
+struct LIN_RX_BYTE {
+  uint32_t time;  // micros() when the IRQ read the byte
+  u_int8_t data;
+  bool lin_break;  // UART reported a break (RSR BE) for this byte
+};
+#endif  // USE_RP2040
+
 class LinBusListener : public PollingComponent, public uart::UARTDevice {
  public:
   float get_setup_priority() const override { return setup_priority::DATA; }
@@ -45,25 +131,93 @@ class LinBusListener : public PollingComponent, public uart::UARTDevice {
   void set_cs_pin(GPIOPin *pin) { this->cs_pin_ = pin; }
   void set_fault_pin(GPIOPin *pin) { this->fault_pin_ = pin; }
   void set_observer_mode(bool val) { this->observer_mode_ = val; }
+  // Pause between the PID byte and my answer. 0 answers as soon as possible.
+  void set_response_space(uint32_t val) { this->response_space_us_ = val; }
   bool get_lin_bus_fault() { return fault_on_lin_bus_reported_ > 3; }
+  // Messages lost because the LIN message task did not keep up.
+  uint32_t get_lin_msg_dropped() const { return this->lin_msg_ring_.overflow_count(); }
+  // Log messages lost because the log queue was full.
+  uint32_t get_log_msg_dropped() const { return this->log_msg_dropped_; }
+  // Received bytes lost because the LIN reader did not keep up with the UART IRQ (RP2040). The ESP32 UART driver
+  // buffers the bytes itself, always 0 there.
+  uint32_t get_uart_rx_dropped() const {
+#ifdef USE_RP2040
+    return this->rx_ring_.overflow_count();
+#else
+    return 0;
+#endif  // USE_RP2040
+  }
+  // Achieved response offsets, see `set_response_space`.
+  const LinBusResponseHistogram &get_response_offsets() const { return this->response_offsets_; }
 
-  void process_lin_msg_queue(TickType_t xTicksToWait);
+  void process_lin_msg_queue();
   void process_log_queue(TickType_t xTicksToWait);
+  // Wait for notifications from the UART side and drain the LIN message ring and the log queue.
+  void process_events(TickType_t xTicksToWait);
 
 #ifdef USE_RP2040
-  // Return is the expected wait time till next data check is recommended.
-  u_int32_t onSerialEvent();
+  // Process the bytes captured by the UART IRQ. Called from the core 1 loop.
+  void onSerialEvent();
+  // UART RX IRQ handler body.
+  void on_uart_irq();
 #endif  // USE_RP2040
+#ifdef USE_HOST
+  // Host build (tests/truma_inetbox): no UART task, the test feeds the UART and calls this. `received` is the time
+  // the UART event was taken.
+  void onReceive() { this->onReceive_(micros()); }
+  void onReceive(uint32_t received) { this->onReceive_(received); }
+#endif  // USE_HOST
 
  protected:
   LIN_CHECKSUM lin_checksum_ = LIN_CHECKSUM::LIN_CHECKSUM_VERSION_2;
   GPIOPin *cs_pin_ = nullptr;
   GPIOPin *fault_pin_ = nullptr;
   bool observer_mode_ = false;
+  uint32_t response_space_us_ = 0;
 
-  void write_lin_answer_(const u_int8_t *data, u_int8_t len);
+  // Notification bits for the event task.
+  static const uint32_t LIN_EVENT_LIN_MSG = 1 << 0;
+  static const uint32_t LIN_EVENT_LOG_MSG = 1 << 1;
+  void notify_event_task_(uint32_t events) {
+#ifdef USE_ESP32
+    if (this->eventTaskHandle_ != nullptr) {
+      xTaskNotify(this->eventTaskHandle_, events, eSetBits);
+    }
+#else
+    (void) events;
+#endif  // USE_ESP32
+  }
+
+  // Answer `pid` with the response returned by `provider`. Register before the frames should be answered.
+  void register_lin_response_(u_int8_t pid, lin_response_provider_t provider);
+  // Answer for `pid` from the providers registered with `register_lin_response_`. Called by the frame reader of
+  // `LinBusListener`. A derived class can hide it with its own `lin_response_` and select a reader for itself in
+  // `select_lin_reader_` (`use_lin_reader_<Derived>`), the PID dispatch is then inlined into the UART path. It must
+  // befriend `LinBusListener` if its `lin_response_` is not public, and it answers every PID itself: the providers
+  // registered here (e.g. 0x3D by `LinBusProtocol`) are not consulted any more.
+  const LinBusResponse *lin_response_(u_int8_t pid) {
+    lin_response_provider_t provider = this->pid_handlers_[pid].provider;
+    return provider != nullptr ? provider(this) : nullptr;
+  }
+  // Called by `setup` once the configuration is set.
+  virtual void select_lin_reader_();
+  // Select the frame reader for `Handler` and the configured checksum. Needs LinBusFrameReader.h.
+  template<typename Handler> void use_lin_reader_() {
+#ifdef USE_RP2040
+    this->lin_reader_ = this->lin_checksum_ == LIN_CHECKSUM::LIN_CHECKSUM_VERSION_1
+                            ? &LinBusListener::read_rx_ring_<Handler, true>
+                            : &LinBusListener::read_rx_ring_<Handler, false>;
+#else
+    this->lin_reader_ = this->lin_checksum_ == LIN_CHECKSUM::LIN_CHECKSUM_VERSION_1
+                            ? &LinBusListener::read_lin_bytes_<Handler, true>
+                            : &LinBusListener::read_lin_bytes_<Handler, false>;
+#endif  // USE_RP2040
+  }
+  // Copy `data` into `response` and calculate the checksum for `pid`. Returns false if `len` is above 8.
+  bool prepare_lin_response_(LinBusResponse *response, u_int8_t pid, const u_int8_t *data, u_int8_t len) const;
   bool check_for_lin_fault_();
-  virtual bool answer_lin_order_(const u_int8_t pid) = 0;
+  // Called by `process_lin_msg_queue` after the received messages have been handled.
+  virtual void lin_messages_processed_() {}
   virtual void lin_message_recieved_(const u_int8_t pid, const u_int8_t *message, u_int8_t length) = 0;
 
  private:
@@ -82,7 +236,8 @@ class LinBusListener : public PollingComponent, public uart::UARTDevice {
   u_int32_t time_per_byte_;
 
   u_int8_t fault_on_lin_bus_reported_ = 0;
-  bool can_write_lin_answer_ = false;
+  // Indexed by PID (without parity bits).
+  LinBusPidHandler pid_handlers_[64];
 
   enum read_state {
     READ_STATE_BREAK,
@@ -95,33 +250,60 @@ class LinBusListener : public PollingComponent, public uart::UARTDevice {
   u_int8_t current_PID_with_parity_ = 0x00;
   u_int8_t current_PID_ = 0x00;
   bool current_PID_order_answered_ = false;
+  // Classic (LIN 1.x) checksum for the current frame: configured or diagnostic frame.
+  bool current_checksum_classic_ = false;
   bool current_data_valid = true;
   u_int8_t current_data_count_ = 0;
   // up to 8 byte data frame + CRC
   u_int8_t current_data_[9] = {};
   // // Time when the last LIN data was available.
   uint32_t last_data_recieved_ = 0;
+  // Estimated arrival of the PID byte of the current frame (end of its stop bit). Reference for the response space.
+  uint32_t pid_recieved_ = 0;
+  LinBusResponseHistogram response_offsets_;
+  uint32_t response_offsets_reported_ = 0;
+  void log_response_offsets_();
+  void write_lin_response_(const LinBusResponse *response);
 
   void current_state_reset_() {
     this->current_state_ = READ_STATE_BREAK;
     this->current_PID_with_parity_ = 0x00;
     this->current_PID_ = 0x00;
     this->current_PID_order_answered_ = false;
+    this->current_checksum_classic_ = false;
     this->current_data_valid = true;
     this->current_data_count_ = 0;
     memset(this->current_data_, 0, sizeof(this->current_data_));
   };
-  void onReceive_();
-  void read_lin_frame_();
+#ifndef USE_RP2040
+  // Read everything the UART has. `received`: time the UART event / callback was taken, the last waiting byte
+  // arrived just before.
+  void onReceive_(uint32_t received);
+#endif  // USE_RP2040
+  // Frame reader, see LinBusFrameReader.h. `Handler::lin_response_` answers the PIDs, `CLASSIC` selects the classic
+  // checksum (LIN 1.x) for all frames.
+  template<typename Handler, bool CLASSIC> void read_lin_frame_(u_int8_t buf, uint32_t current);
+#ifdef USE_RP2040
+  // Process the bytes captured by the UART IRQ.
+  template<typename Handler, bool CLASSIC> void read_rx_ring_();
+  typedef void (LinBusListener::*lin_reader_t)();
+#else
+  // Process `len` bytes received back to back, the first at `current`, one every `step`.
+  template<typename Handler, bool CLASSIC>
+  void read_lin_bytes_(const u_int8_t *buf, size_t len, uint32_t current, uint32_t step);
+  typedef void (LinBusListener::*lin_reader_t)(const u_int8_t *buf, size_t len, uint32_t current, uint32_t step);
+#endif  // USE_RP2040
+  // Reader instance picked by `select_lin_reader_`.
+  lin_reader_t lin_reader_ = nullptr;
   void clear_uart_buffer_();
   void setup_framework();
 
-  uint8_t lin_msg_static_queue_storage[TRUMA_MSG_QUEUE_LENGTH * sizeof(QUEUE_LIN_MSG)];
-  StaticQueue_t lin_msg_static_queue_;
-  QueueHandle_t lin_msg_queue_ =
-      xQueueCreateStatic(/* uxQueueLength */ TRUMA_MSG_QUEUE_LENGTH,
-                         /* uxItemSize */ sizeof(QUEUE_LIN_MSG),
-                         /* pucQueueStorageBuffer */ lin_msg_static_queue_storage, &lin_msg_static_queue_);
+  // Filled in place by `read_lin_frame_`, drained by `process_lin_msg_queue`.
+  LinBusRingBuffer<QUEUE_LIN_MSG, TRUMA_MSG_QUEUE_LENGTH> lin_msg_ring_;
+  // Written from several tasks without lock, only used as diagnostic.
+  uint32_t log_msg_dropped_ = 0;
+  uint32_t log_msg_dropped_reported_ = 0;
+
 
 #if ESPHOME_LOG_LEVEL > ESPHOME_LOG_LEVEL_NONE
   uint8_t log_static_queue_storage[TRUMA_LOG_QUEUE_LENGTH * sizeof(QUEUE_LOG_MSG)];
@@ -133,16 +315,28 @@ class LinBusListener : public PollingComponent, public uart::UARTDevice {
 #endif
 
 #ifdef USE_ESP32
-  TaskHandle_t eventTaskHandle_;
+  TaskHandle_t eventTaskHandle_ = nullptr;
   static void eventTask_(void *args);
 #endif  // USE_ESP32
 #ifdef USE_ESP32_FRAMEWORK_ESP_IDF
-  TaskHandle_t uartEventTaskHandle_;
+  // One UART task waits on the event queues of all instances (queue set) and one event task drains the LIN message
+  // rings and log queues of all instances. A second LIN bus does not cost two more tasks.
+  QueueHandle_t uart_event_queue_ = nullptr;
+  static LinBusListener *listeners_[TRUMA_MAX_LIN_BUSES];
+  static volatile u_int8_t listener_count_;
+  static QueueSetHandle_t uart_event_queue_set_;
+  static TaskHandle_t uartEventTaskHandle_;
+  static TaskHandle_t sharedEventTaskHandle_;
   static void uartEventTask_(void *args);
+  void on_uart_event_(uint32_t received);
 #endif  // USE_ESP32_FRAMEWORK_ESP_IDF
 #ifdef USE_RP2040
   u_int8_t uart_number_ = 0;
   uart_inst_t *uart_ = nullptr;
+  // Filled by the UART IRQ (core 0), drained by `onSerialEvent` (core 1).
+  LinBusRingBuffer<LIN_RX_BYTE, TRUMA_RX_RING_LENGTH> rx_ring_;
+  // Set by `clear_uart_buffer_`, the ring is flushed by its consumer.
+  volatile bool rx_ring_flush_ = false;
 #endif  // USE_RP2040
 };
 
@@ -41,7 +41,7 @@ void LinBusListener::setup_framework() {
   uart_intr.txfifo_empty_intr_thresh = 10;  // UART_EMPTY_THRESH_DEFAULT
   uart_intr_config(uart_num, &uart_intr);
 
-  hw_serial->onReceive([this]() { this->onReceive_(); }, false);
+  hw_serial->onReceive([this]() { this->onReceive_(micros()); }, false);
   hw_serial->onReceiveError([this](hardwareSerial_error_t val) {
     // Ignore any data present in buffer
     this->clear_uart_buffer_();
@@ -73,7 +73,7 @@ void LinBusListener::setup_framework() {
 void LinBusListener::eventTask_(void *args) {
   LinBusListener *instance = (LinBusListener *) args;
   for (;;) {
-    instance->process_lin_msg_queue(QUEUE_WAIT_BLOCKING);
+    instance->process_events(QUEUE_WAIT_BLOCKING);
   }
 }
 
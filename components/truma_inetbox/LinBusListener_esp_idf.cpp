@@ -16,6 +16,7 @@ namespace truma_inetbox {
 static const char *const TAG = "truma_inetbox.LinBusListener";
 
 #define QUEUE_WAIT_BLOCKING (portTickType) portMAX_DELAY
+#define QUEUE_WAIT_DONT_BLOCK (TickType_t) 0
 
 void LinBusListener::setup_framework() {
   // uartSetFastReading
@@ -35,51 +36,93 @@ void LinBusListener::setup_framework() {
   uart_intr.txfifo_empty_intr_thresh = 10;  // UART_EMPTY_THRESH_DEFAULT
   uart_intr_config(uart_num, &uart_intr);
 
-  // Creating UART event Task
-  xTaskCreatePinnedToCore(LinBusListener::uartEventTask_,
-                          "uart_event_task",                      // name
-                          ARDUINO_SERIAL_EVENT_TASK_STACK_SIZE,   // stack size (in words)
-                          this,                                   // input params
-                          24,                                     // priority
-                          &this->uartEventTaskHandle_,            // handle
-                          ARDUINO_SERIAL_EVENT_TASK_RUNNING_CORE  // core
-  );
-  if (this->uartEventTaskHandle_ == NULL) {
-    ESP_LOGE(TAG, " -- UART%d Event Task not created!", uart_num);
+  if (listener_count_ >= TRUMA_MAX_LIN_BUSES) {
+    ESP_LOGE(TAG, " -- UART%d not served, raise TRUMA_MAX_LIN_BUSES (%d)!", uart_num, TRUMA_MAX_LIN_BUSES);
+    this->mark_failed();
+    return;
   }
 
-  // Creating LIN msg event Task
-  xTaskCreatePinnedToCore(LinBusListener::eventTask_,
-                          "lin_event_task",                       // name
-                          ARDUINO_SERIAL_EVENT_TASK_STACK_SIZE,   // stack size (in words)
-                          this,                                   // input params
-                          2,                                      // priority
-                          &this->eventTaskHandle_,                // handle
-                          ARDUINO_SERIAL_EVENT_TASK_RUNNING_CORE  // core
-  );
-
-  if (this->eventTaskHandle_ == NULL) {
-    ESP_LOGE(TAG, " -- LIN message Task not created!");
+  if (uart_event_queue_set_ == nullptr) {
+    // Must hold every event of all member queues.
+    uart_event_queue_set_ = xQueueCreateSet(TRUMA_MAX_LIN_BUSES * TRUMA_UART_EVENT_QUEUE_LENGTH);
   }
+  this->uart_event_queue_ = *uartComp->get_uart_event_queue();
+  // Only empty queues can join a set. Dropping pending events is fine, the next UART_DATA event drains the whole
+  // UART buffer. The RX interrupt is off meanwhile, an event posted between reset and add would make the add fail.
+  // Bytes received meanwhile wait in the FIFO and raise the interrupt once it is enabled again.
+  uart_disable_rx_intr(uart_num);
+  xQueueReset(this->uart_event_queue_);
+  bool added =
+      uart_event_queue_set_ != nullptr && xQueueAddToSet(this->uart_event_queue_, uart_event_queue_set_) == pdPASS;
+  uart_enable_rx_intr(uart_num);
+  if (!added) {
+    ESP_LOGE(TAG, " -- UART%d event queue not added to queue set!", uart_num);
+    this->mark_failed();
+    return;
+  }
+  // Publish the instance before the UART task can select its queue.
+  listeners_[listener_count_] = this;
+  listener_count_ = listener_count_ + 1;
+
+  if (uartEventTaskHandle_ == nullptr) {
+    // Creating UART event Task (shared by all instances)
+    xTaskCreatePinnedToCore(LinBusListener::uartEventTask_,
+                            "uart_event_task",                      // name
+                            ARDUINO_SERIAL_EVENT_TASK_STACK_SIZE,   // stack size (in words)
+                            nullptr,                                // input params
+                            24,                                     // priority
+                            &uartEventTaskHandle_,                  // handle
+                            ARDUINO_SERIAL_EVENT_TASK_RUNNING_CORE  // core
+    );
+    if (uartEventTaskHandle_ == NULL) {
+      ESP_LOGE(TAG, " -- UART Event Task not created!");
+    }
+  }
+
+  if (sharedEventTaskHandle_ == nullptr) {
+    // Creating LIN msg event Task (shared by all instances)
+    xTaskCreatePinnedToCore(LinBusListener::eventTask_,
+                            "lin_event_task",                       // name
+                            ARDUINO_SERIAL_EVENT_TASK_STACK_SIZE,   // stack size (in words)
+                            nullptr,                                // input params
+                            2,                                      // priority
+                            &sharedEventTaskHandle_,                // handle
+                            ARDUINO_SERIAL_EVENT_TASK_RUNNING_CORE  // core
+    );
+    if (sharedEventTaskHandle_ == NULL) {
+      ESP_LOGE(TAG, " -- LIN message Task not created!");
+    }
+  }
+  this->eventTaskHandle_ = sharedEventTaskHandle_;
 }
 
-void LinBusListener::uartEventTask_(void *args) {
-  LinBusListener *instance = (LinBusListener *) args;
-  auto uartComp = static_cast<ESPHOME_UART *>(instance->parent_);
-  auto uart_num = uartComp->get_hw_serial_number();
-  auto uartEventQueue = uartComp->get_uart_event_queue();
+void LinBusListener::on_uart_event_(uint32_t received) {
   uart_event_t event;
+  // The queue set holds one entry per queued event, so exactly one event is waiting.
+  if (xQueueReceive(this->uart_event_queue_, (void *) &event, 0)) {
+    if (event.type == UART_DATA) {
+      this->onReceive_(received);
+    } else if (event.type == UART_BREAK) {
+      // If the break is valid the `onReceive` is called first and the break is handeld. Therfore the expectation is
+      // that the state should be in waiting for `SYNC`.
+      if (this->current_state_ != READ_STATE_SYNC) {
+        this->current_state_ = READ_STATE_BREAK;
+      }
+    }
+  }
+}
+
+void LinBusListener::uartEventTask_(void *args) {
   for (;;) {
-    // Waiting for UART event.
-    if (xQueueReceive(*uartEventQueue, (void *) &event, QUEUE_WAIT_BLOCKING)) {
-      if (event.type == UART_DATA && instance->available() > 0) {
-        instance->onReceive_();
-      } else if (event.type == UART_BREAK) {
-        // If the break is valid the `onReceive` is called first and the break is handeld. Therfore the expectation is
-        // that the state should be in waiting for `SYNC`.
-        if (instance->current_state_ != READ_STATE_SYNC) {
-          instance->current_state_ = READ_STATE_BREAK;
-        }
+    // Waiting for UART event on any LIN bus.
+    QueueSetMemberHandle_t member = xQueueSelectFromSet(uart_event_queue_set_, QUEUE_WAIT_BLOCKING);
+    // The UART ISR posts an event per received byte (`rxfifo_full_thresh` 1). Take the time first, it is the
+    // reference for the response space.
+    uint32_t received = micros();
+    for (u_int8_t i = 0; i < listener_count_; i++) {
+      if (listeners_[i]->uart_event_queue_ == member) {
+        listeners_[i]->on_uart_event_(received);
+        break;
       }
     }
   }
@@ -87,16 +130,33 @@ void LinBusListener::uartEventTask_(void *args) {
 }
 
 void LinBusListener::eventTask_(void *args) {
-  LinBusListener *instance = (LinBusListener *) args;
+  uint32_t events;
   for (;;) {
-    instance->process_lin_msg_queue(QUEUE_WAIT_BLOCKING);
+    // Drain first: anything queued before the event task started has no notification.
+    // The notification bits do not tell which instance queued, checking an empty queue is cheap.
+    // Log first, the LIN message handlers log as well and should come after the bus messages.
+    for (u_int8_t i = 0; i < listener_count_; i++) {
+      listeners_[i]->process_log_queue(QUEUE_WAIT_DONT_BLOCK);
+    }
+    for (u_int8_t i = 0; i < listener_count_; i++) {
+      listeners_[i]->process_lin_msg_queue();
+    }
+    // Bits set while draining stay pending, so nothing is missed between the drain and the wait.
+    xTaskNotifyWait(0, UINT32_MAX, &events, QUEUE_WAIT_BLOCKING);
   }
 }
 
+LinBusListener *LinBusListener::listeners_[TRUMA_MAX_LIN_BUSES] = {};
+volatile u_int8_t LinBusListener::listener_count_ = 0;
+QueueSetHandle_t LinBusListener::uart_event_queue_set_ = nullptr;
+TaskHandle_t LinBusListener::uartEventTaskHandle_ = nullptr;
+TaskHandle_t LinBusListener::sharedEventTaskHandle_ = nullptr;
+
 }  // namespace truma_inetbox
 }  // namespace esphome
 
 #undef QUEUE_WAIT_BLOCKING
+#undef QUEUE_WAIT_DONT_BLOCK
 #undef ESPHOME_UART
 
 #endif  // USE_ESP32_FRAMEWORK_ESP_IDF
\ No newline at end of file
@@ -9,11 +9,14 @@
 #endif // CUSTOM_ESPHOME_UART
 #include "esphome/components/uart/uart_component_rp2040.h"
 #include <SerialUART.h>
+#include <hardware/irq.h>
 
 // Instance 1 for UART port 0
 static esphome::truma_inetbox::LinBusListener *LIN_BUS_LISTENER_INSTANCE_1 = nullptr;
 // Instance 2 for UART port 1
 static esphome::truma_inetbox::LinBusListener *LIN_BUS_LISTENER_INSTANCE_2 = nullptr;
+// Task running `loop1`, woken by the UART IRQs.
+static TaskHandle_t LIN_BUS_LISTENER_LOOP1_TASK = nullptr;
 
 namespace esphome {
 namespace truma_inetbox {
@@ -21,6 +24,20 @@ namespace truma_inetbox {
 static const char *const TAG = "truma_inetbox.LinBusListener";
 
 #define QUEUE_WAIT_DONT_BLOCK (TickType_t) 0
+// Wake up `loop1` at least this often, even without UART data (LIN fault pin, queued LIN messages).
+#define LOOP1_IDLE_WAIT_MS 100
+
+static void lin_uart0_irq() {
+  if (LIN_BUS_LISTENER_INSTANCE_1 != nullptr) {
+    LIN_BUS_LISTENER_INSTANCE_1->on_uart_irq();
+  }
+}
+
+static void lin_uart1_irq() {
+  if (LIN_BUS_LISTENER_INSTANCE_2 != nullptr) {
+    LIN_BUS_LISTENER_INSTANCE_2->on_uart_irq();
+  }
+}
 
 void LinBusListener::setup_framework() {
   auto uartComp = static_cast<ESPHOME_UART *>(this->parent_);
@@ -44,49 +61,63 @@ void LinBusListener::setup_framework() {
   }
 
   if (this->uart_ != nullptr) {
-    // Turn off FIFO's - we want to do this character by character
+    // Turn off FIFO's - the IRQ fires per character, so the PID byte is seen one character time after it arrived
+    // instead of after the FIFO timeout (32 bit times).
     uart_set_fifo_enabled(this->uart_, false);
+
+    // Replace the SerialUART RX IRQ. Bytes are timestamped and queued in `rx_ring_` instead of the SerialUART buffer.
+    auto irq_num = this->uart_ == uart0 ? UART0_IRQ : UART1_IRQ;
+    irq_set_enabled(irq_num, false);
+    auto current_handler = irq_get_exclusive_handler(irq_num);
+    if (current_handler != nullptr) {
+      irq_remove_handler(irq_num, current_handler);
+    }
+    irq_set_exclusive_handler(irq_num, this->uart_ == uart0 ? lin_uart0_irq : lin_uart1_irq);
+    uart_set_irq_enables(this->uart_, true, false);
+    irq_set_enabled(irq_num, true);
   }
 }
 
-u_int32_t LinBusListener::onSerialEvent() {
-  this->onReceive_();
-
-  if (this->uart_ != nullptr) {
+void LinBusListener::on_uart_irq() {
+  auto hw = uart_get_hw(this->uart_);
+  while (uart_is_readable(this->uart_)) {
+    auto data = (u_int8_t) (hw->dr & 0xFF);
     // Receive Status Register/Error Clear Register, UARTRSR/UARTECR
-    // 0x00000004 [2]     : BE (0): Break error
-    auto receive_status_register = uart_get_hw(this->uart_)->rsr;
-
-    if ((receive_status_register & UART_UARTRSR_BE_BITS) == UART_UARTRSR_BE_BITS) {
-      ESP_LOGVV(TAG, "UART%d RX break.", this->uart_number_);
-      // If the break is valid the `onReceive` is called first and the break is handeld. Therfore the expectation is
-      // that the state should be in waiting for `SYNC`.
-      if (this->current_state_ != READ_STATE_BREAK || this->current_state_ != READ_STATE_SYNC) {
-        this->current_state_ = READ_STATE_SYNC;
-      }
-
+    // 0x00000004 [2]     : BE (0): Break error. Valid for the character just read from DR.
+    bool lin_break = (hw->rsr & UART_UARTRSR_BE_BITS) == UART_UARTRSR_BE_BITS;
+    if (lin_break) {
       // Clear Receive Status Register
-      hw_clear_bits(&uart_get_hw(this->uart_)->rsr, UART_UARTRSR_BE_BITS);
+      hw_clear_bits(&hw->rsr, UART_UARTRSR_BE_BITS);
+    }
+
+    LIN_RX_BYTE *rx = this->rx_ring_.write_slot();
+    if (rx != nullptr) {
+      rx->time = micros();
+      rx->data = data;
+      rx->lin_break = lin_break;
+      this->rx_ring_.commit();
     }
   }
 
-  if (this->current_state_ == READ_STATE_BREAK) {
-    // Next is a break. CP Plus has an inter data break of ~35ms
-    auto current = micros();
-    if ((this->last_data_recieved_ + (1000 * 1000 /* 1 second */)) < current) {
-      // I have not recieved data for a while. Sleep deeper
-      return 750;
-    } else if ((this->last_data_recieved_ + (50 * 1000 /* 0.1 second */)) < current) {
-      // I have not recieved data for a while. Sleep deep
-      return 50;
-    } else {
-      // Expecting a SYNC.
-      return 10;
+  if (LIN_BUS_LISTENER_LOOP1_TASK != nullptr) {
+    BaseType_t higher_priority_task_woken = pdFALSE;
+    vTaskNotifyGiveFromISR(LIN_BUS_LISTENER_LOOP1_TASK, &higher_priority_task_woken);
+    portYIELD_FROM_ISR(higher_priority_task_woken);
+  }
+}
+
+void LinBusListener::onSerialEvent() {
+  if (this->rx_ring_flush_) {
+    this->rx_ring_flush_ = false;
+    LIN_RX_BYTE rx;
+    while (this->rx_ring_.pop(&rx)) {
     }
-  } else {
-    // Expecting a byte.
-    return 1;
   }
+  if (this->check_for_lin_fault_()) {
+    return;
+  }
+
+  (this->*lin_reader_)();
 }
 
 }  // namespace truma_inetbox
@@ -97,27 +128,30 @@ extern void loop1() {
     // Wait for setup_framework to finish.
     delay(100);
   } else {
-    u_int32_t sleep1 = 0xFFFFFFFF;
-    u_int32_t sleep2 = 0xFFFFFFFF;
+    if (LIN_BUS_LISTENER_LOOP1_TASK == nullptr) {
+      LIN_BUS_LISTENER_LOOP1_TASK = xTaskGetCurrentTaskHandle();
+    }
     if (LIN_BUS_LISTENER_INSTANCE_1 != nullptr) {
-      sleep1 = LIN_BUS_LISTENER_INSTANCE_1->onSerialEvent();
+      LIN_BUS_LISTENER_INSTANCE_1->onSerialEvent();
     }
     if (LIN_BUS_LISTENER_INSTANCE_2 != nullptr) {
-      sleep2 = LIN_BUS_LISTENER_INSTANCE_2->onSerialEvent();
+      LIN_BUS_LISTENER_INSTANCE_2->onSerialEvent();
     }
     // TODO: Reconsider processing lin messages here.
     // They contain blocking log messages.
     if (LIN_BUS_LISTENER_INSTANCE_1 != nullptr) {
-      LIN_BUS_LISTENER_INSTANCE_1->process_lin_msg_queue(QUEUE_WAIT_DONT_BLOCK);
+      LIN_BUS_LISTENER_INSTANCE_1->process_lin_msg_queue();
     }
     if (LIN_BUS_LISTENER_INSTANCE_2 != nullptr) {
-      LIN_BUS_LISTENER_INSTANCE_2->process_lin_msg_queue(QUEUE_WAIT_DONT_BLOCK);
+      LIN_BUS_LISTENER_INSTANCE_2->process_lin_msg_queue();
     }
-    delay(sleep1 > sleep2 ? sleep2 : sleep1);
+    // Sleep until the UART IRQ has new bytes. A notification given while processing is kept.
+    ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(LOOP1_IDLE_WAIT_MS));
   }
 }
 
 #undef QUEUE_WAIT_DONT_BLOCK
+#undef LOOP1_IDLE_WAIT_MS
 #undef ESPHOME_UART
 
 #endif  // USE_RP2040
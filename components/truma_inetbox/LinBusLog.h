@@ -2,9 +2,21 @@
 
 #include "esphome/core/log.h"
 
-#define truma_log(_log_msg_) xQueueSend(this->log_queue_, (void *) &_log_msg_, QUEUE_WAIT_DONT_BLOCK);
+// Queue the message and wake the event task. A burst of messages sets the same notification bit, so the event task
+// drains them in one go once the (higher priority) producer yields.
+#define truma_log(_log_msg_) \
+  if (xQueueSend(this->log_queue_, (void *) &_log_msg_, QUEUE_WAIT_DONT_BLOCK) != pdPASS) { \
+    this->log_msg_dropped_++; \
+  } else { \
+    this->notify_event_task_(LIN_EVENT_LOG_MSG); \
+  }
 
-#define truma_logfromisr(_log_msg_) xQueueSendFromISR(this->log_queue_, (void *) &_log_msg_, QUEUE_WAIT_DONT_BLOCK);
+#define truma_logfromisr(_log_msg_) \
+  if (xQueueSendFromISR(this->log_queue_, (void *) &_log_msg_, QUEUE_WAIT_DONT_BLOCK) != pdPASS) { \
+    this->log_msg_dropped_++; \
+  } else { \
+    this->notify_event_task_(LIN_EVENT_LOG_MSG); \
+  }
 
 #if ESPHOME_LOG_LEVEL >= ESPHOME_LOG_LEVEL_VERY_VERBOSE
 #define TRUMA_LOGVV(_log_msg_) truma_log(_log_msg_)
@@ -48,8 +60,6 @@
 
 enum class QUEUE_LOG_MSG_TYPE {
   UNKNOWN,
-  ERROR_LIN_ANSWER_CAN_WRITE_LIN_ANSWER,
-  ERROR_LIN_ANSWER_TOO_LONG,
   VERBOSE_LIN_ANSWER_RESPONSE,
   ERROR_CHECK_FOR_LIN_FAULT_DETECTED,
   INFO_CHECK_FOR_LIN_FAULT_FIXED,
@@ -1,6 +1,7 @@
 #include "LinBusProtocol.h"
 #include <array>
 #include "esphome/core/log.h"
+#include "esphome/core/hal.h"
 #include "esphome/core/helpers.h"
 
 namespace esphome {
@@ -8,8 +9,6 @@ namespace truma_inetbox {
 
 static const char *const TAG = "truma_inetbox.LinBusProtocol";
 
-#define DIAGNOSTIC_FRAME_MASTER 0x3c
-#define DIAGNOSTIC_FRAME_SLAVE 0x3d
 #define LIN_NAD_BROADCAST 0x7F
 #define LIN_SID_RESPONSE 0x40
 #define LIN_SID_ASSIGN_NAD 0xB0
@@ -18,25 +17,36 @@ static const char *const TAG = "truma_inetbox.LinBusProtocol";
 #define LIN_SID_READ_BY_IDENTIFIER_RESPONSE (LIN_SID_READ_BY_IDENTIFIER | LIN_SID_RESPONSE)
 #define LIN_SID_HEARTBEAT 0xB9
 #define LIN_SID_HEARTBEAT_RESPONSE (LIN_SID_HEARTBEAT | LIN_SID_RESPONSE)
+// Frames of a multi frame response queued ahead of the master. The rest is generated while the master fetches them.
+#define TRANSPORT_FRAMES_AHEAD 2
 
 void LinBusProtocol::lin_reset_device(){
     // clear any messages in send queue of LinBus Protocol handler.
-  while (!this->updates_to_send_.empty()) {
-    this->updates_to_send_.pop();
-  }
+  this->updates_to_send_.flush();
+  this->updates_queued_ = 0;
+  this->transport_.reset();
 }
 
-bool LinBusProtocol::answer_lin_order_(const u_int8_t pid) {
+void LinBusProtocol::setup() {
   // Send requested answer
-  if (pid == DIAGNOSTIC_FRAME_SLAVE) {
-    if (!this->updates_to_send_.empty()) {
-      auto update_to_send_ = this->updates_to_send_.front();
-      this->updates_to_send_.pop();
-      this->write_lin_answer_(update_to_send_.data(), (u_int8_t) update_to_send_.size());
-      return true;
-    }
+  this->register_lin_response_(DIAGNOSTIC_FRAME_SLAVE, [](LinBusListener *listener) -> const LinBusResponse * {
+    return static_cast<LinBusProtocol *>(listener)->lin_update_response_();
+  });
+  this->set_interval("transport_counters", 60 * 1000 /* 1 minute */, [this]() { this->log_transport_counters_(); });
+  LinBusListener::setup();
+}
+
+void LinBusProtocol::prepare_update_msg_(const std::array<u_int8_t, 8> &message) {
+  // Checksum is calculated here, not in the UART task.
+  LinBusResponse *slot = this->updates_to_send_.write_slot();
+  if (slot == nullptr) {
+    ESP_LOGW(TAG, "Send queue full (%u), response %s dropped (%u total).", (unsigned) this->updates_to_send_.capacity(),
+             format_hex_pretty(message.data(), message.size()).c_str(),
+             (unsigned) this->updates_to_send_.overflow_count());
+    return;
   }
-  return false;
+  this->prepare_lin_response_(slot, DIAGNOSTIC_FRAME_SLAVE, message.data(), (u_int8_t) message.size());
+  this->updates_to_send_.commit();
 }
 
 void LinBusProtocol::lin_message_recieved_(const u_int8_t pid, const u_int8_t *message, u_int8_t length) {
@@ -66,23 +76,20 @@ void LinBusProtocol::lin_message_recieved_(const u_int8_t pid, const u_int8_t *m
       }
     }
     u_int8_t protocol_control_information = message[1];
+    if ((protocol_control_information & 0xF0) == 0x00 || (protocol_control_information & 0xF0) == 0x10) {
+      // A new request ends any open multi frame request or response.
+      if (this->transport_.on_new_request()) {
+        // Frames of the old response must not be sent anymore.
+        this->updates_to_send_.flush();
+        this->updates_queued_ = 0;
+      }
+    }
     if ((protocol_control_information & 0xF0) == 0x00) {
       // Single Frame mode
-      {
-        // End any open Multi frame mode message
-        this->multi_pdu_message_expected_size_ = 0;
-        this->multi_pdu_message_len_ = 0;
-        this->multi_pdu_message_frame_counter_ = 0;
-      }
       this->lin_msg_diag_single_(message, length);
-    } else if ((protocol_control_information & 0xF0) == 0x10) {
-      // First Frame of multi PDU message
-      this->lin_msg_diag_first_(message, length);
-    } else if ((protocol_control_information & 0xF0) == 0x20) {
-      // Consecutive Frames
-      if (this->lin_msg_diag_consecutive_(message, length)) {
-        this->lin_msg_diag_multi_();
-      }
+    } else if (this->transport_.on_request_frame(message, micros())) {
+      // First Frame or Consecutive Frames of multi PDU message completed the request.
+      this->lin_msg_diag_multi_();
     }
 
   } else if (pid == this->lin_node_address_) {
@@ -170,105 +177,75 @@ void LinBusProtocol::lin_msg_diag_single_(const u_int8_t *message, u_int8_t leng
   }
 }
 
-void LinBusProtocol::lin_msg_diag_first_(const u_int8_t *message, u_int8_t length) {
-  u_int8_t protocol_control_information = message[1];
-  u_int16_t message_length = (protocol_control_information & 0x0F << 8) + message[2];
-  if (message_length < 7) {
-    ESP_LOGE(TAG, "LIN Protocol issue: Multi frame message too short.");
-    // ignore invalid message
-    return;
-  }
-  if (message_length > sizeof(this->multi_pdu_message_)) {
-    ESP_LOGE(TAG, "LIN Protocol issue: Multi frame message too long.");
-    // ignore invalid message
-    return;
+void LinBusProtocol::lin_msg_diag_multi_() {
+  const u_int8_t *request = this->transport_.message();
+  u_int16_t request_len = this->transport_.message_len();
+  ESP_LOGD(TAG, "Multi package request  %s", format_hex_pretty(request, request_len).c_str());
+
+  u_int16_t answer_len = 0;
+  // Ask handling class what to answer to this request.
+  auto answer = this->lin_multiframe_recieved(request, request_len, &answer_len);
+  if (answer_len > 0) {
+    ESP_LOGD(TAG, "Multi package response %s", format_hex_pretty(answer, answer_len).c_str());
+
+    // Single frame or first frame now, consecutive frames while the master fetches them.
+    if (this->transport_.start_response(this->lin_node_address_, answer[0] | LIN_SID_RESPONSE, &answer[1],
+                                        answer_len - 1, micros())) {
+      this->transport_fill_();
+    }
+  } else {
+    // Nothing to answer, hand a pool buffer back.
+    this->transport_.abort_request();
   }
-  this->multi_pdu_message_expected_size_ = message_length;
-  this->multi_pdu_message_len_ = 0;
-  this->multi_pdu_message_frame_counter_ = 1;
+}
 
-  // Copy recieved message over to `multi_pdu_message_` buffer.
-  for (size_t i = 3; i < 8; i++) {
-    this->multi_pdu_message_[this->multi_pdu_message_len_++] = message[i];
+void LinBusProtocol::log_transport_counters_() {
+  const LinBusTransportCounters &counters = this->transport_.get_counters();
+  // Counters only grow, the sum changes with any of them.
+  uint32_t sum = counters.rx_messages + counters.rx_abort_sequence + counters.rx_abort_timeout +
+                 counters.rx_abort_length + counters.rx_abort_buffer + counters.rx_abort_new + counters.tx_messages +
+                 counters.tx_abort_timeout + counters.tx_abort_new + counters.tx_abort_buffer;
+  if (sum == this->transport_counters_reported_) {
+    return;
   }
+  this->transport_counters_reported_ = sum;
+  ESP_LOGD(TAG,
+           "Multi package requests: %u, dropped: %u sequence, %u timeout, %u length, %u buffer, %u new request",
+           (unsigned) counters.rx_messages, (unsigned) counters.rx_abort_sequence,
+           (unsigned) counters.rx_abort_timeout, (unsigned) counters.rx_abort_length,
+           (unsigned) counters.rx_abort_buffer, (unsigned) counters.rx_abort_new);
+  ESP_LOGD(TAG, "Multi package responses: %u, dropped: %u timeout, %u buffer, %u new request",
+           (unsigned) counters.tx_messages, (unsigned) counters.tx_abort_timeout, (unsigned) counters.tx_abort_buffer,
+           (unsigned) counters.tx_abort_new);
 }
 
-bool LinBusProtocol::lin_msg_diag_consecutive_(const u_int8_t *message, u_int8_t length) {
-  if (this->multi_pdu_message_len_ >= this->multi_pdu_message_expected_size_) {
-    // ignore, because i don't await a consecutive frame
-    return false;
+void LinBusProtocol::lin_messages_processed_() { this->transport_fill_(); }
+
+void LinBusProtocol::transport_fill_() {
+  if (!this->transport_.response_pending()) {
+    return;
   }
-  u_int8_t protocol_control_information = message[1];
-  u_int8_t frame_counter = protocol_control_information & 0x0F;
-  if (frame_counter != this->multi_pdu_message_frame_counter_) {
-    // ignore, because i don't await this consecutive frame
-    return false;
+  uint32_t now = micros();
+  size_t queued = this->updates_to_send_.size();
+  if (queued < this->updates_queued_) {
+    this->transport_.response_progress(now);
   }
-  this->multi_pdu_message_frame_counter_++;
-  if (this->multi_pdu_message_frame_counter_ > 0x0F) {
-    // Frame counter has only 4 bit and wraps around.
-    this->multi_pdu_message_frame_counter_ = 0x00;
+  if (this->transport_.check_response_timeout(now)) {
+    this->updates_to_send_.flush();
+    this->updates_queued_ = 0;
+    return;
   }
-
-  // Copy recieved message over to `multi_pdu_message_` buffer.
-  for (u_int8_t i = 2; i < 8; i++) {
-    if (this->multi_pdu_message_len_ < this->multi_pdu_message_expected_size_) {
-      this->multi_pdu_message_[this->multi_pdu_message_len_++] = message[i];
-    }
+  std::array<u_int8_t, 8> response;
+  // Flushed frames keep their slots until the UART task skipped them, generate only into free slots.
+  while (queued < TRANSPORT_FRAMES_AHEAD && !this->updates_to_send_.full() &&
+         this->transport_.next_response_frame(&response)) {
+    this->prepare_update_msg_(response);
+    queued++;
   }
-
-  // Check if this was the last consecutive message.
-  return this->multi_pdu_message_len_ == this->multi_pdu_message_expected_size_;
-}
-
-void LinBusProtocol::lin_msg_diag_multi_() {
-  ESP_LOGD(TAG, "Multi package request  %s",
-           format_hex_pretty(this->multi_pdu_message_, this->multi_pdu_message_len_).c_str());
-
-  u_int8_t answer_len = 0;
-  // Ask handling class what to answer to this request.
-  auto answer = this->lin_multiframe_recieved(this->multi_pdu_message_, this->multi_pdu_message_len_, &answer_len);
-  if (answer_len > 0) {
-    ESP_LOGD(TAG, "Multi package response %s", format_hex_pretty(answer, answer_len).c_str());
-
-    std::array<u_int8_t, 8> response = this->lin_empty_response_;
-    if (answer_len <= 6) {
-      // Single Frame response - first frame
-      response[0] = this->lin_node_address_;
-      response[1] = answer_len; /* bytes length */
-      response[2] = answer[0] | LIN_SID_RESPONSE;
-      for (u_int8_t i = 1; i < answer_len; i++) {
-        response[i + 2] = answer[i];
-      }
-      this->prepare_update_msg_(response);
-    } else {
-      // Multi Frame response
-      response[0] = this->lin_node_address_;
-      response[1] = 0x10 | ((answer_len >> 8) & 0x0F);
-      response[2] = answer_len & 0xFF;
-      response[3] = answer[0] | LIN_SID_RESPONSE;
-      for (u_int8_t i = 1; i < 5; i++) {
-        response[i + 3] = answer[i];
-      }
-      this->prepare_update_msg_(response);
-
-      // Multi Frame response - consecutive frame
-      u_int16_t answer_position = 5;      // The first 5 bytes are sent in First frame of multi frame response.
-      u_int8_t answer_frame_counter = 0;  // Each answer frame can contain 6 bytes
-      while (answer_position < answer_len) {
-        response = this->lin_empty_response_;
-        response[0] = this->lin_node_address_;
-        response[1] = ((answer_frame_counter + 1) & 0x0F) | 0x20;
-        for (u_int8_t i = 0; i < 6; i++) {
-          if (answer_position < answer_len) {
-            response[i + 2] = answer[answer_position++];
-          }
-        }
-        this->prepare_update_msg_(response);
-        answer_frame_counter++;
-      }
-    }
+  if (queued == 0 && this->transport_.response_generated()) {
+    this->transport_.response_sent();
   }
+  this->updates_queued_ = queued;
 }
 
 }  // namespace truma_inetbox
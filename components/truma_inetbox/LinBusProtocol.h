@@ -1,7 +1,9 @@
 #pragma once
 
-#include <queue>
+#include <array>
 #include "LinBusListener.h"
+#include "LinBusRingBuffer.h"
+#include "LinBusTransport.h"
 
 namespace esphome {
 namespace truma_inetbox {
@@ -11,32 +13,51 @@ class LinBusProtocol : public LinBusListener {
   virtual void lin_heartbeat() = 0;
   virtual void lin_reset_device();
 
+  void setup() override;
+
+  const LinBusTransportCounters &get_transport_counters() const { return this->transport_.get_counters(); }
+
  protected:
   const std::array<u_int8_t, 8> lin_empty_response_ = {0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF};
 
-  bool answer_lin_order_(const u_int8_t pid) override;
   void lin_message_recieved_(const u_int8_t pid, const u_int8_t *message, u_int8_t length) override;
+  void lin_messages_processed_() override;
 
   virtual bool lin_read_field_by_identifier_(u_int8_t identifier, std::array<u_int8_t, 5> *response) = 0;
-  virtual const u_int8_t *lin_multiframe_recieved(const u_int8_t *message, const u_int8_t message_len,
-                                                  u_int8_t *return_len) = 0;
+  virtual const u_int8_t *lin_multiframe_recieved(const u_int8_t *message, const u_int16_t message_len,
+                                                  u_int16_t *return_len) = 0;
+
+  // Filled by the LIN message task, drained by the `DIAGNOSTIC_FRAME_SLAVE` handler in the UART task.
+  LinBusRingBuffer<LinBusResponse, TRUMA_UPDATE_QUEUE_LENGTH> updates_to_send_;
 
-  std::queue<std::array<u_int8_t, 8>> updates_to_send_ = {};
+  // Answer for `DIAGNOSTIC_FRAME_SLAVE`: next queued frame or nullptr. Called in the UART task.
+  const LinBusResponse *lin_update_response_() {
+    if (!this->updates_to_send_.pop(&this->update_to_send_)) {
+      return nullptr;
+    }
+    // Let the LIN message task queue the next frame of a multi frame response.
+    this->notify_event_task_(LIN_EVENT_LIN_MSG);
+    return &this->update_to_send_;
+  }
 
  private:
   u_int8_t lin_node_address_ = /*LIN initial node address*/ 0x03;
+  // Answer currently written by the UART task.
+  LinBusResponse update_to_send_;
 
-  void prepare_update_msg_(const std::array<u_int8_t, 8> message) { this->updates_to_send_.push(std::move(message)); }
+  void prepare_update_msg_(const std::array<u_int8_t, 8> &message);
   bool is_matching_identifier_(const u_int8_t *message);
 
-  u_int16_t multi_pdu_message_expected_size_ = 0;
-  u_int8_t multi_pdu_message_len_ = 0;
-  u_int8_t multi_pdu_message_frame_counter_ = 0;
-  u_int8_t multi_pdu_message_[64];
+  // Multi frame requests and responses on the diagnostic frames.
+  LinBusTransport transport_;
+  // Entries in `updates_to_send_` after the last `transport_fill_`.
+  size_t updates_queued_ = 0;
+  // Sum of the transport counters at the last log line.
+  uint32_t transport_counters_reported_ = 0;
   void lin_msg_diag_single_(const u_int8_t *message, u_int8_t length);
-  void lin_msg_diag_first_(const u_int8_t *message, u_int8_t length);
-  bool lin_msg_diag_consecutive_(const u_int8_t *message, u_int8_t length);
   void lin_msg_diag_multi_();
+  void transport_fill_();
+  void log_transport_counters_();
 };
 
 }  // namespace truma_inetbox
@@ -0,0 +1,116 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace esphome {
+namespace truma_inetbox {
+
+// Fixed capacity single producer / single consumer ring buffer. No heap allocation and no locks, so producer and
+// consumer can run in different tasks (one of them the UART event task).
+//
+// Producer: `push` or `write_slot` + `commit`, `flush`, `size`, `full`, `overflow_count`.
+// Consumer: `pop` or `read_slot` + `release`, `empty`.
+// `write_slot`/`read_slot` hand out the entry in place, so large entries are not copied through a temporary.
+// Only the consumer moves the tail, a slot is reused only after the consumer released or flushed it.
+// Only atomic loads and stores are used (no read-modify-write), which keeps it lock-free on the RP2040 as well.
+template<typename T, size_t N> class LinBusRingBuffer {
+  static_assert(N > 0 && (N & (N - 1)) == 0, "LinBusRingBuffer capacity must be a power of two");
+
+ public:
+  static constexpr size_t capacity() { return N; }
+
+  // Next free entry, or nullptr (overflow counted) if the buffer is full. Becomes visible with `commit`.
+  T *write_slot() {
+    uint32_t head = this->head_.load(std::memory_order_relaxed);
+    if (head - this->tail_.load(std::memory_order_acquire) >= N) {
+      this->overflow_.store(this->overflow_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+      return nullptr;
+    }
+    return &this->items_[head & (N - 1)];
+  }
+  void commit() { this->head_.store(this->head_.load(std::memory_order_relaxed) + 1, std::memory_order_release); }
+
+  // Returns false and counts the overflow if the buffer is full.
+  bool push(const T &item) {
+    T *slot = this->write_slot();
+    if (slot == nullptr) {
+      return false;
+    }
+    *slot = item;
+    this->commit();
+    return true;
+  }
+
+  // Oldest entry, or nullptr if empty. Stays valid until `release`.
+  T *read_slot() {
+    uint32_t tail = this->consumer_tail_();
+    if (tail == this->head_.load(std::memory_order_acquire)) {
+      return nullptr;
+    }
+    return &this->items_[tail & (N - 1)];
+  }
+  void release() { this->tail_.store(this->tail_.load(std::memory_order_relaxed) + 1, std::memory_order_release); }
+
+  bool pop(T *item) {
+    T *slot = this->read_slot();
+    if (slot == nullptr) {
+      return false;
+    }
+    *item = *slot;
+    this->release();
+    return true;
+  }
+
+  bool empty() { return this->consumer_tail_() == this->head_.load(std::memory_order_acquire); }
+
+  // Drop everything pushed so far. Called by the producer: only a flush request, the consumer drops the entries on
+  // its next access. Until then they keep their slots.
+  void flush() {
+    this->flush_head_.store(this->head_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    this->flush_seq_.store(this->flush_seq_.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+  }
+
+  // Entries the consumer will still take. Entries of a pending flush do not count.
+  size_t size() const {
+    uint32_t head = this->head_.load(std::memory_order_relaxed);
+    uint32_t used = head - this->tail_.load(std::memory_order_acquire);
+    uint32_t since_flush = head - this->flush_head_.load(std::memory_order_relaxed);
+    return since_flush < used ? since_flush : used;
+  }
+  // No free slot, `write_slot` would fail. Entries of a pending flush still occupy their slots.
+  bool full() const {
+    return this->head_.load(std::memory_order_relaxed) - this->tail_.load(std::memory_order_acquire) >= N;
+  }
+
+  uint32_t overflow_count() const { return this->overflow_.load(std::memory_order_relaxed); }
+
+ protected:
+  T items_[N] = {};
+  std::atomic<uint32_t> head_{0};  // written by producer
+  std::atomic<uint32_t> tail_{0};  // written by consumer
+  std::atomic<uint32_t> flush_head_{0};
+  std::atomic<uint32_t> flush_seq_{0};
+  std::atomic<uint32_t> overflow_{0};
+  uint32_t flush_seq_seen_ = 0;  // consumer only
+
+  // Tail after a pending flush request has been carried out.
+  uint32_t consumer_tail_() {
+    uint32_t seq = this->flush_seq_.load(std::memory_order_acquire);
+    uint32_t tail = this->tail_.load(std::memory_order_relaxed);
+    if (seq != this->flush_seq_seen_) {
+      this->flush_seq_seen_ = seq;
+      uint32_t flush_head = this->flush_head_.load(std::memory_order_relaxed);
+      // Only move forward; entries popped in the meantime are already gone.
+      if ((int32_t) (flush_head - tail) > 0) {
+        tail = flush_head;
+        this->tail_.store(tail, std::memory_order_release);
+      }
+    }
+    return tail;
+  }
+};
+
+}  // namespace truma_inetbox
+}  // namespace esphome
@@ -0,0 +1,245 @@
+#include "LinBusTransport.h"
+#include <cstring>
+#include "esphome/core/log.h"
+
+namespace esphome {
+namespace truma_inetbox {
+
+static const char *const TAG = "truma_inetbox.LinBusTransport";
+
+#define PCI_TYPE_SINGLE_FRAME 0x00
+#define PCI_TYPE_FIRST_FRAME 0x10
+#define PCI_TYPE_CONSECUTIVE_FRAME 0x20
+// Payload bytes per frame type
+#define SINGLE_FRAME_DATA 6
+#define FIRST_FRAME_DATA 5
+#define CONSECUTIVE_FRAME_DATA 6
+#define FRAME_FILLER 0xFF
+
+#if TRUMA_TRANSPORT_POOL_BUFFERS > 0
+u_int8_t LinBusTransport::pool_[TRUMA_TRANSPORT_POOL_BUFFERS][TRUMA_TRANSPORT_MAX_MESSAGE_LENGTH];
+bool LinBusTransport::pool_used_[TRUMA_TRANSPORT_POOL_BUFFERS] = {};
+SemaphoreHandle_t LinBusTransport::pool_lock_ = nullptr;
+#endif  // TRUMA_TRANSPORT_POOL_BUFFERS > 0
+
+LinBusTransport::LinBusTransport() : buffer_(inline_buffer_) {
+#if TRUMA_TRANSPORT_POOL_BUFFERS > 0
+  // Components are created one after another before any task runs.
+  if (pool_lock_ == nullptr) {
+    pool_lock_ = xSemaphoreCreateMutex();
+  }
+#endif  // TRUMA_TRANSPORT_POOL_BUFFERS > 0
+}
+
+bool LinBusTransport::reserve_(u_int16_t len) {
+  if (len <= TRUMA_TRANSPORT_INLINE_LENGTH || this->pool_index_ >= 0) {
+    return true;
+  }
+#if TRUMA_TRANSPORT_POOL_BUFFERS > 0
+  xSemaphoreTake(pool_lock_, portMAX_DELAY);
+  for (int8_t i = 0; i < TRUMA_TRANSPORT_POOL_BUFFERS; i++) {
+    if (!pool_used_[i]) {
+      pool_used_[i] = true;
+      this->pool_index_ = i;
+      break;
+    }
+  }
+  xSemaphoreGive(pool_lock_);
+  if (this->pool_index_ >= 0) {
+    this->buffer_ = pool_[this->pool_index_];
+    return true;
+  }
+#endif  // TRUMA_TRANSPORT_POOL_BUFFERS > 0
+  ESP_LOGW(TAG, "LIN Protocol issue: No buffer free for a message of %u bytes.", len);
+  return false;
+}
+
+void LinBusTransport::release_() {
+#if TRUMA_TRANSPORT_POOL_BUFFERS > 0
+  if (this->pool_index_ < 0 || this->rx_expected_ > 0 || this->rx_complete_ || this->response_pending()) {
+    return;
+  }
+  xSemaphoreTake(pool_lock_, portMAX_DELAY);
+  pool_used_[this->pool_index_] = false;
+  xSemaphoreGive(pool_lock_);
+  this->pool_index_ = -1;
+  this->buffer_ = this->inline_buffer_;
+#endif  // TRUMA_TRANSPORT_POOL_BUFFERS > 0
+}
+
+bool LinBusTransport::on_new_request() {
+  if (this->rx_expected_ > 0) {
+    this->counters_.rx_abort_new++;
+  }
+  this->abort_request();
+  if (!this->response_pending()) {
+    return false;
+  }
+  this->counters_.tx_abort_new++;
+  this->abort_response();
+  return true;
+}
+
+bool LinBusTransport::on_request_frame(const u_int8_t *frame, uint32_t now) {
+  u_int8_t protocol_control_information = frame[1];
+  if ((protocol_control_information & 0xF0) == PCI_TYPE_FIRST_FRAME) {
+    // Request and response share the buffer.
+    this->abort_request();
+    this->abort_response();
+    // 12 bit length: low nibble of the PCI is the high byte.
+    u_int16_t message_length = ((protocol_control_information & 0x0F) << 8) | frame[2];
+    if (message_length <= SINGLE_FRAME_DATA) {
+      ESP_LOGE(TAG, "LIN Protocol issue: Multi frame message too short.");
+      this->counters_.rx_abort_length++;
+      return false;
+    }
+    if (message_length > TRUMA_TRANSPORT_MAX_MESSAGE_LENGTH) {
+      ESP_LOGE(TAG, "LIN Protocol issue: Multi frame message too long (%u).", message_length);
+      this->counters_.rx_abort_length++;
+      return false;
+    }
+    if (!this->reserve_(message_length)) {
+      this->counters_.rx_abort_buffer++;
+      return false;
+    }
+    this->rx_expected_ = message_length;
+    this->rx_sequence_ = 1;
+    this->rx_last_ = now;
+    memcpy(&this->buffer_[0], &frame[3], FIRST_FRAME_DATA);
+    this->rx_len_ = FIRST_FRAME_DATA;
+    return false;
+  }
+
+  if ((protocol_control_information & 0xF0) != PCI_TYPE_CONSECUTIVE_FRAME || this->rx_expected_ == 0) {
+    // ignore, because i don't await a consecutive frame
+    return false;
+  }
+  if (now - this->rx_last_ > TRUMA_TRANSPORT_TIMEOUT_US) {
+    ESP_LOGW(TAG, "LIN Protocol issue: Consecutive frame after %u ms, request dropped.",
+             (unsigned) ((now - this->rx_last_) / 1000));
+    this->counters_.rx_abort_timeout++;
+    this->abort_request();
+    return false;
+  }
+  if ((protocol_control_information & 0x0F) != this->rx_sequence_) {
+    ESP_LOGW(TAG, "LIN Protocol issue: Consecutive frame %u, expected %u, request dropped.",
+             protocol_control_information & 0x0F, this->rx_sequence_);
+    this->counters_.rx_abort_sequence++;
+    this->abort_request();
+    return false;
+  }
+  // Sequence number has only 4 bit and wraps around.
+  this->rx_sequence_ = (this->rx_sequence_ + 1) & 0x0F;
+  this->rx_last_ = now;
+
+  u_int16_t copy = this->rx_expected_ - this->rx_len_;
+  if (copy > CONSECUTIVE_FRAME_DATA) {
+    copy = CONSECUTIVE_FRAME_DATA;
+  }
+  memcpy(&this->buffer_[this->rx_len_], &frame[2], copy);
+  this->rx_len_ += copy;
+
+  if (this->rx_len_ < this->rx_expected_) {
+    return false;
+  }
+  // Check if this was the last consecutive message.
+  this->rx_expected_ = 0;
+  this->rx_complete_ = true;
+  this->counters_.rx_messages++;
+  return true;
+}
+
+void LinBusTransport::abort_request() {
+  this->rx_expected_ = 0;
+  this->rx_len_ = 0;
+  this->rx_complete_ = false;
+  this->release_();
+}
+
+bool LinBusTransport::start_response(u_int8_t nad, u_int8_t rsid, const u_int8_t *data, u_int16_t len,
+                                     uint32_t now) {
+  if (len + 1u > TRUMA_TRANSPORT_MAX_MESSAGE_LENGTH) {
+    ESP_LOGE(TAG, "LIN Protocol issue: Response too long (%u).", len + 1u);
+    this->abort_request();
+    return false;
+  }
+  // The request in the buffer has been handled by now. `data` may point into it; a response that does not fit into
+  // the inline buffer cannot come from there.
+  if (!this->reserve_(len + 1)) {
+    this->counters_.tx_abort_buffer++;
+    this->abort_request();
+    return false;
+  }
+  memmove(&this->buffer_[1], data, len);
+  this->buffer_[0] = rsid;
+  this->tx_nad_ = nad;
+  this->tx_len_ = len + 1;
+  // Request done, the buffer belongs to the response now.
+  this->rx_expected_ = 0;
+  this->rx_len_ = 0;
+  this->rx_complete_ = false;
+  this->tx_pos_ = 0;
+  this->tx_sequence_ = 0;
+  this->tx_last_ = now;
+  return true;
+}
+
+bool LinBusTransport::next_response_frame(std::array<u_int8_t, 8> *frame) {
+  if (this->tx_pos_ >= this->tx_len_) {
+    return false;
+  }
+  frame->fill(FRAME_FILLER);
+  (*frame)[0] = this->tx_nad_;
+  u_int8_t offset;
+  u_int16_t copy;
+  if (this->tx_pos_ == 0 && this->tx_len_ <= SINGLE_FRAME_DATA) {
+    (*frame)[1] = PCI_TYPE_SINGLE_FRAME | this->tx_len_;
+    offset = 2;
+    copy = this->tx_len_;
+  } else if (this->tx_pos_ == 0) {
+    (*frame)[1] = PCI_TYPE_FIRST_FRAME | ((this->tx_len_ >> 8) & 0x0F);
+    (*frame)[2] = this->tx_len_ & 0xFF;
+    offset = 3;
+    copy = FIRST_FRAME_DATA;
+  } else {
+    (*frame)[1] = PCI_TYPE_CONSECUTIVE_FRAME | this->tx_sequence_;
+    offset = 2;
+    copy = this->tx_len_ - this->tx_pos_;
+    if (copy > CONSECUTIVE_FRAME_DATA) {
+      copy = CONSECUTIVE_FRAME_DATA;
+    }
+  }
+  memcpy(&(*frame)[offset], &this->buffer_[this->tx_pos_], copy);
+  this->tx_pos_ += copy;
+  this->tx_sequence_ = (this->tx_sequence_ + 1) & 0x0F;
+  return true;
+}
+
+void LinBusTransport::response_sent() {
+  this->counters_.tx_messages++;
+  this->abort_response();
+}
+
+bool LinBusTransport::check_response_timeout(uint32_t now) {
+  if (!this->response_pending() || now - this->tx_last_ <= TRUMA_TRANSPORT_TIMEOUT_US) {
+    return false;
+  }
+  ESP_LOGW(TAG, "LIN Protocol issue: Master stopped fetching the response, response dropped.");
+  this->counters_.tx_abort_timeout++;
+  this->abort_response();
+  return true;
+}
+
+void LinBusTransport::abort_response() {
+  this->tx_len_ = 0;
+  this->tx_pos_ = 0;
+  this->release_();
+}
+
+void LinBusTransport::reset() {
+  this->abort_request();
+  this->abort_response();
+}
+
+}  // namespace truma_inetbox
+}  // namespace esphome
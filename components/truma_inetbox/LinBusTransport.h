@@ -0,0 +1,132 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <sys/types.h>
+
+#if defined(USE_ESP32) || defined(USE_HOST)
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#endif  // USE_ESP32 || USE_HOST
+#ifdef USE_RP2040
+#include <FreeRTOS.h>
+#include <semphr.h>
+#endif  // USE_RP2040
+
+// Largest message the transport layer accepts or sends. The LIN transport layer (ISO 17987-2) allows 4095 bytes
+// (12 bit length in the first frame).
+#ifndef  TRUMA_TRANSPORT_MAX_MESSAGE_LENGTH
+#define TRUMA_TRANSPORT_MAX_MESSAGE_LENGTH 4095
+#endif
+// Messages up to this length stay in the transport layer itself. Truma messages are 48 bytes at most.
+#ifndef  TRUMA_TRANSPORT_INLINE_LENGTH
+#define TRUMA_TRANSPORT_INLINE_LENGTH 64
+#endif
+// Buffers of `TRUMA_TRANSPORT_MAX_MESSAGE_LENGTH` bytes for longer messages, shared by the transport layers of all LIN
+// buses. 0 limits messages to `TRUMA_TRANSPORT_INLINE_LENGTH`.
+#ifndef  TRUMA_TRANSPORT_POOL_BUFFERS
+#define TRUMA_TRANSPORT_POOL_BUFFERS 1
+#endif
+// N_Cr: max. time between two consecutive frames of a request.
+// N_As: max. time until the master has fetched the next frame of a response.
+#ifndef  TRUMA_TRANSPORT_TIMEOUT_US
+#define TRUMA_TRANSPORT_TIMEOUT_US (1000 * 1000)
+#endif
+
+namespace esphome {
+namespace truma_inetbox {
+
+struct LinBusTransportCounters {
+  uint32_t rx_messages = 0;
+  uint32_t rx_abort_sequence = 0;  // consecutive frame with wrong sequence number
+  uint32_t rx_abort_timeout = 0;   // N_Cr exceeded
+  uint32_t rx_abort_length = 0;    // first frame announces an invalid length
+  uint32_t rx_abort_buffer = 0;    // no pool buffer free for a long request
+  uint32_t rx_abort_new = 0;       // new request before the last one was complete
+  uint32_t tx_messages = 0;
+  uint32_t tx_abort_timeout = 0;   // N_As exceeded
+  uint32_t tx_abort_new = 0;       // new request before the response was fetched
+  uint32_t tx_abort_buffer = 0;    // no pool buffer free for a long response
+};
+
+// LIN transport layer for one node: reassembles segmented requests (first frame + consecutive frames) and splits a
+// response into single, first and consecutive frames. A node handles one message at a time, so request and response
+// share one buffer. Longer messages than `TRUMA_TRANSPORT_INLINE_LENGTH` borrow a pool buffer until the message is
+// done. Not thread safe apart from the pool, owned by the LIN message task.
+class LinBusTransport {
+ public:
+  LinBusTransport();
+  ~LinBusTransport() { this->reset(); }
+  LinBusTransport(const LinBusTransport &) = delete;
+  LinBusTransport &operator=(const LinBusTransport &) = delete;
+
+  // A new request (single or first frame) ends an unfinished request and a response in progress. Returns true if a
+  // response was dropped, frames the caller has already queued belong to it.
+  bool on_new_request();
+  // Feed a first or consecutive frame (PCI 0x1_ / 0x2_) addressed to this node. Returns true when a request is
+  // complete, see `message` / `message_len`.
+  bool on_request_frame(const u_int8_t *frame, uint32_t now);
+  // Drop a request that is being reassembled or has been handled without a response.
+  void abort_request();
+
+  const u_int8_t *message() const { return this->buffer_; }
+  u_int16_t message_len() const { return this->rx_complete_ ? this->rx_len_ : 0; }
+
+  // Start a response `rsid` + `data`. Frames are generated on demand with `next_response_frame`.
+  bool start_response(u_int8_t nad, u_int8_t rsid, const u_int8_t *data, u_int16_t len, uint32_t now);
+  // Response started and not all of its frames fetched by the master yet.
+  bool response_pending() const { return this->tx_len_ > 0; }
+  // All frames have been handed out by `next_response_frame`.
+  bool response_generated() const { return this->tx_pos_ >= this->tx_len_; }
+  // Next frame of the current response. Returns false when all frames have been handed out.
+  bool next_response_frame(std::array<u_int8_t, 8> *frame);
+  // The master fetched a frame of the response; restarts the N_As supervision.
+  void response_progress(uint32_t now) { this->tx_last_ = now; }
+  // The master fetched the last frame.
+  void response_sent();
+  // Returns true (and drops the response) if the master stopped fetching the response.
+  bool check_response_timeout(uint32_t now);
+  void abort_response();
+
+  void reset();
+
+  const LinBusTransportCounters &get_counters() const { return this->counters_; }
+  // Holds a pool buffer.
+  bool has_pool_buffer() const { return this->pool_index_ >= 0; }
+
+ protected:
+  // `inline_buffer_` or a pool buffer.
+  u_int8_t *buffer_;
+  u_int8_t inline_buffer_[TRUMA_TRANSPORT_INLINE_LENGTH];
+  int8_t pool_index_ = -1;
+  LinBusTransportCounters counters_;
+
+  // Make `buffer_` hold `len` bytes, takes a pool buffer if needed.
+  bool reserve_(u_int16_t len);
+  // Hand the pool buffer back once neither a request nor a response uses it.
+  void release_();
+
+  // Request reassembly
+  u_int16_t rx_expected_ = 0;
+  u_int16_t rx_len_ = 0;
+  u_int8_t rx_sequence_ = 0;
+  uint32_t rx_last_ = 0;
+  bool rx_complete_ = false;
+
+  // Response generation
+  u_int8_t tx_nad_ = 0;
+  u_int16_t tx_len_ = 0;
+  u_int16_t tx_pos_ = 0;
+  u_int8_t tx_sequence_ = 0;
+  uint32_t tx_last_ = 0;
+
+#if TRUMA_TRANSPORT_POOL_BUFFERS > 0
+  static u_int8_t pool_[TRUMA_TRANSPORT_POOL_BUFFERS][TRUMA_TRANSPORT_MAX_MESSAGE_LENGTH];
+  static bool pool_used_[TRUMA_TRANSPORT_POOL_BUFFERS];
+  // The LIN message tasks of several buses claim pool buffers concurrently.
+  static SemaphoreHandle_t pool_lock_;
+#endif  // TRUMA_TRANSPORT_POOL_BUFFERS > 0
+};
+
+}  // namespace truma_inetbox
+}  // namespace esphome
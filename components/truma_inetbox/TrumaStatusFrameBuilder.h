@@ -25,7 +25,7 @@ inline void status_frame_calculate_checksum(StatusFrame *response) {
   response->genericHeader.checksum = data_checksum(&response->raw[10], sizeof(StatusFrame) - 10, 0);
 }
 
-inline void status_frame_create_init(StatusFrame *response, u_int8_t *response_len, u_int8_t command_counter) {
+inline void status_frame_create_init(StatusFrame *response, u_int16_t *response_len, u_int8_t command_counter) {
   status_frame_create_empty(response, STATUS_FRAME_RESPONSE_INIT_REQUEST, 0, command_counter);
 
   // Init frame is empty.
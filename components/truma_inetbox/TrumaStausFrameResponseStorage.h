@@ -26,7 +26,7 @@ class TrumaStausFrameResponseStorage : public TrumaStausFrameStorage<T>, public
     TrumaStausFrameStorage<T>::set_status(val);
     this->update_status_stale_ = false;
   };
-  virtual void create_update_data(StatusFrame *response, u_int8_t *response_len, u_int8_t command_counter) = 0;
+  virtual void create_update_data(StatusFrame *response, u_int16_t *response_len, u_int8_t command_counter) = 0;
 
  protected:
   inline void update_submitted() {
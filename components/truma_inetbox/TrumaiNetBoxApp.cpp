@@ -18,6 +18,22 @@ TrumaiNetBoxApp::TrumaiNetBoxApp() {
   this->timer_.set_parent(this);
 }
 
+void TrumaiNetBoxApp::setup() {
+  // Alive message
+  std::array<u_int8_t, 8> response = this->lin_empty_response_;
+  this->prepare_lin_response_(&this->alive_response_, LIN_PID_TRUMA_INET_BOX, response.data(), response.size());
+  response[0] = 0xFE;
+  this->prepare_lin_response_(&this->alive_response_idle_, LIN_PID_TRUMA_INET_BOX, response.data(), response.size());
+  this->register_lin_response_(LIN_PID_TRUMA_INET_BOX, [](LinBusListener *listener) -> const LinBusResponse * {
+    auto *app = static_cast<TrumaiNetBoxApp *>(listener);
+    if (app->updates_to_send_.empty() && !app->has_update_to_submit_()) {
+      return &app->alive_response_idle_;
+    }
+    return &app->alive_response_;
+  });
+  LinBusProtocol::setup();
+}
+
 void TrumaiNetBoxApp::update() {
   // Call listeners in after method 'lin_multiframe_recieved' call.
   // Because 'lin_multiframe_recieved' is time critical an all these sensors can take some time.
@@ -85,20 +101,6 @@ void TrumaiNetBoxApp::lin_reset_device() {
   this->update_time_ = 0;
 }
 
-bool TrumaiNetBoxApp::answer_lin_order_(const u_int8_t pid) {
-  // Alive message
-  if (pid == LIN_PID_TRUMA_INET_BOX) {
-    std::array<u_int8_t, 8> response = this->lin_empty_response_;
-
-    if (this->updates_to_send_.empty() && !this->has_update_to_submit_()) {
-      response[0] = 0xFE;
-    }
-    this->write_lin_answer_(response.data(), (u_int8_t) sizeof(response));
-    return true;
-  }
-  return LinBusProtocol::answer_lin_order_(pid);
-}
-
 bool TrumaiNetBoxApp::lin_read_field_by_identifier_(u_int8_t identifier, std::array<u_int8_t, 5> *response) {
   if (identifier == 0x00 /* LIN Product Identification */) {
     auto lin_identifier = this->lin_identifier();
@@ -125,8 +127,8 @@ bool TrumaiNetBoxApp::lin_read_field_by_identifier_(u_int8_t identifier, std::ar
   return false;
 }
 
-const u_int8_t *TrumaiNetBoxApp::lin_multiframe_recieved(const u_int8_t *message, const u_int8_t message_len,
-                                                         u_int8_t *return_len) {
+const u_int8_t *TrumaiNetBoxApp::lin_multiframe_recieved(const u_int8_t *message, const u_int16_t message_len,
+                                                         u_int16_t *return_len) {
   static u_int8_t response[48] = {};
   // Validate message prefix.
   if (message_len < truma_message_header.size()) {
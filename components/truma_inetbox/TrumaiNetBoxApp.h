@@ -21,6 +21,7 @@ namespace truma_inetbox {
 class TrumaiNetBoxApp : public LinBusProtocol {
  public:
   TrumaiNetBoxApp();
+  void setup() override;
   void update() override;
 
   const std::array<u_int8_t, 4> lin_identifier() override;
@@ -73,11 +74,13 @@ class TrumaiNetBoxApp : public LinBusProtocol {
   bool update_status_clock_done = false;
 #endif  // USE_TIME
 
-  bool answer_lin_order_(const u_int8_t pid) override;
+  // Alive message answers, checksum calculated once in `setup`.
+  LinBusResponse alive_response_;
+  LinBusResponse alive_response_idle_;
 
   bool lin_read_field_by_identifier_(u_int8_t identifier, std::array<u_int8_t, 5> *response) override;
-  const u_int8_t *lin_multiframe_recieved(const u_int8_t *message, const u_int8_t message_len,
-                                          u_int8_t *return_len) override;
+  const u_int8_t *lin_multiframe_recieved(const u_int8_t *message, const u_int16_t message_len,
+                                          u_int16_t *return_len) override;
 
   bool has_update_to_submit_();
 };
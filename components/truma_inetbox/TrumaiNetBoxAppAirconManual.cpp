@@ -26,7 +26,7 @@ StatusFrameAirconManualResponse *TrumaiNetBoxAppAirconManual::update_prepare() {
   return &this->update_status_;
 }
 
-void TrumaiNetBoxAppAirconManual::create_update_data(StatusFrame *response, u_int8_t *response_len,
+void TrumaiNetBoxAppAirconManual::create_update_data(StatusFrame *response, u_int16_t *response_len,
                                                      u_int8_t command_counter) {
   status_frame_create_empty(response, STATUS_FRAME_AIRCON_MANUAL_RESPONSE, sizeof(StatusFrameAirconManualResponse),
                             command_counter);
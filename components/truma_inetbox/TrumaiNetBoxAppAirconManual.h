@@ -10,7 +10,7 @@ class TrumaiNetBoxAppAirconManual
     : public TrumaStausFrameResponseStorage<StatusFrameAirconManual, StatusFrameAirconManualResponse> {
  public:
   StatusFrameAirconManualResponse *update_prepare() override;
-  void create_update_data(StatusFrame *response, u_int8_t *response_len, u_int8_t command_counter) override;
+  void create_update_data(StatusFrame *response, u_int16_t *response_len, u_int8_t command_counter) override;
   void dump_data() const override;
   bool can_update() override;
 
@@ -16,7 +16,7 @@ class TrumaiNetBoxAppClock : public TrumaStausFrameStorage<StatusFrameClock>, pu
   void update_submit() { this->update_status_unsubmitted_ = true; }
   bool has_update() const { return this->update_status_unsubmitted_; }
   bool action_write_time();
-  void create_update_data(StatusFrame *response, u_int8_t *response_len, u_int8_t command_counter);
+  void create_update_data(StatusFrame *response, u_int16_t *response_len, u_int8_t command_counter);
 
  protected:
   // The behaviour of `update_status_clock_unsubmitted_` is special.
@@ -29,7 +29,7 @@ StatusFrameHeaterResponse *TrumaiNetBoxAppHeater::update_prepare() {
   return &this->update_status_;
 }
 
-void TrumaiNetBoxAppHeater::create_update_data(StatusFrame *response, u_int8_t *response_len,
+void TrumaiNetBoxAppHeater::create_update_data(StatusFrame *response, u_int16_t *response_len,
                                                u_int8_t command_counter) {
   status_frame_create_empty(response, STATUS_FRAME_HEATER_RESPONSE, sizeof(StatusFrameHeaterResponse), command_counter);
 
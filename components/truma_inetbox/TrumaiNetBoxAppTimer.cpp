@@ -34,7 +34,7 @@ StatusFrameTimerResponse *TrumaiNetBoxAppTimer::update_prepare() {
   return &this->update_status_;
 }
 
-void TrumaiNetBoxAppTimer::create_update_data(StatusFrame *response, u_int8_t *response_len, u_int8_t command_counter) {
+void TrumaiNetBoxAppTimer::create_update_data(StatusFrame *response, u_int16_t *response_len, u_int8_t command_counter) {
   status_frame_create_empty(response, STATUS_FRAME_TIMER_RESPONSE, sizeof(StatusFrameTimerResponse), command_counter);
 
   response->timerResponse.timer_target_temp_room = this->update_status_.timer_target_temp_room;
@@ -9,7 +9,7 @@ namespace truma_inetbox {
 class TrumaiNetBoxAppTimer : public TrumaStausFrameResponseStorage<StatusFrameTimer, StatusFrameTimerResponse> {
  public:
   StatusFrameTimerResponse *update_prepare() override;
-  void create_update_data(StatusFrame *response, u_int8_t *response_len, u_int8_t command_counter) override;
+  void create_update_data(StatusFrame *response, u_int16_t *response_len, u_int8_t command_counter) override;
   void dump_data() const override;
   
   bool action_timer_disable();
@@ -8,6 +8,12 @@ namespace truma_inetbox {
 static const char *const TAG = "truma_inetbox.sensor";
 
 void TrumaSensor::setup() {
+  if (this->type_ == TRUMA_SENSOR_TYPE::LIN_MESSAGES_DROPPED || this->type_ == TRUMA_SENSOR_TYPE::LOG_MESSAGES_DROPPED ||
+      this->type_ == TRUMA_SENSOR_TYPE::UART_BYTES_DROPPED || this->type_ == TRUMA_SENSOR_TYPE::LIN_RESPONSE_OFFSET) {
+    // Diagnostics are not tied to a status frame, sample them.
+    this->set_interval("diagnostic", 10 * 1000 /* 10 seconds */, [this]() { this->publish_diagnostic_(); });
+    return;
+  }
   this->parent_->get_heater()->add_on_message_callback([this](const StatusFrameHeater *status_heater) {
     switch (this->type_) {
       case TRUMA_SENSOR_TYPE::CURRENT_ROOM_TEMPERATURE:
@@ -45,6 +51,34 @@ void TrumaSensor::setup() {
   });
 }
 
+void TrumaSensor::publish_diagnostic_() {
+  switch (this->type_) {
+    case TRUMA_SENSOR_TYPE::LIN_MESSAGES_DROPPED:
+      this->publish_state(static_cast<float>(this->parent_->get_lin_msg_dropped()));
+      break;
+    case TRUMA_SENSOR_TYPE::LOG_MESSAGES_DROPPED:
+      this->publish_state(static_cast<float>(this->parent_->get_log_msg_dropped()));
+      break;
+    case TRUMA_SENSOR_TYPE::UART_BYTES_DROPPED:
+      this->publish_state(static_cast<float>(this->parent_->get_uart_rx_dropped()));
+      break;
+    case TRUMA_SENSOR_TYPE::LIN_RESPONSE_OFFSET: {
+      // Mean offset of the answers sent since the last sample. Nothing to publish without answers.
+      const LinBusResponseHistogram &hist = this->parent_->get_response_offsets();
+      uint32_t count = hist.count;
+      uint64_t sum_us = hist.sum_us;
+      if (count != this->response_count_) {
+        this->publish_state(static_cast<float>(sum_us - this->response_sum_us_) / (count - this->response_count_));
+      }
+      this->response_count_ = count;
+      this->response_sum_us_ = sum_us;
+      break;
+    }
+    default:
+      break;
+  }
+}
+
 void TrumaSensor::dump_config() {
   LOG_SENSOR("", "Truma Sensor", this);
   ESP_LOGCONFIG(TAG, "  Type '%s'", enum_to_c_str(this->type_));
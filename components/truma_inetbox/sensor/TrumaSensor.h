@@ -17,6 +17,10 @@ enum class TRUMA_SENSOR_TYPE {
   ENERGY_MIX,
   OPERATING_STATUS,
   HEATER_ERROR_CODE,
+  LIN_MESSAGES_DROPPED,
+  LOG_MESSAGES_DROPPED,
+  UART_BYTES_DROPPED,
+  LIN_RESPONSE_OFFSET,
 };
 
 #ifdef ESPHOME_LOG_HAS_CONFIG
@@ -49,6 +53,18 @@ static const char *enum_to_c_str(const TRUMA_SENSOR_TYPE val) {
     case TRUMA_SENSOR_TYPE::HEATER_ERROR_CODE:
       return "HEATER_ERROR_CODE";
       break;
+    case TRUMA_SENSOR_TYPE::LIN_MESSAGES_DROPPED:
+      return "LIN_MESSAGES_DROPPED";
+      break;
+    case TRUMA_SENSOR_TYPE::LOG_MESSAGES_DROPPED:
+      return "LOG_MESSAGES_DROPPED";
+      break;
+    case TRUMA_SENSOR_TYPE::UART_BYTES_DROPPED:
+      return "UART_BYTES_DROPPED";
+      break;
+    case TRUMA_SENSOR_TYPE::LIN_RESPONSE_OFFSET:
+      return "LIN_RESPONSE_OFFSET";
+      break;
     default:
       return "";
       break;
@@ -66,6 +82,11 @@ class TrumaSensor : public Component, public sensor::Sensor, public Parented<Tru
  protected:
   TRUMA_SENSOR_TYPE type_;
 
+  void publish_diagnostic_();
+  // LIN_RESPONSE_OFFSET: histogram state at the last sample.
+  uint32_t response_count_ = 0;
+  uint64_t response_sum_us_ = 0;
+
  private:
 };
 }  // namespace truma_inetbox
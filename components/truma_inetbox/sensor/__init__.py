@@ -13,6 +13,8 @@ from esphome.const import (
     STATE_CLASS_MEASUREMENT,
     CONF_ACCURACY_DECIMALS,
     CONF_DEVICE_CLASS,
+    CONF_ENTITY_CATEGORY,
+    ENTITY_CATEGORY_DIAGNOSTIC,
     UNIT_WATT,
     UNIT_EMPTY,
     ICON_GAS_CYLINDER,
@@ -87,6 +89,33 @@ CONF_SUPPORTED_TYPE = {
         CONF_UNIT_OF_MEASUREMENT: UNIT_EMPTY,
         CONF_ACCURACY_DECIMALS: 0,
     },
+    # Diagnostic counters of the LIN bus listener
+    "LIN_MESSAGES_DROPPED": {
+        CONF_CLASS: TRUMA_SENSOR_TYPE_dummy_ns.LIN_MESSAGES_DROPPED,
+        CONF_UNIT_OF_MEASUREMENT: UNIT_EMPTY,
+        CONF_ACCURACY_DECIMALS: 0,
+        CONF_ENTITY_CATEGORY: ENTITY_CATEGORY_DIAGNOSTIC,
+    },
+    "LOG_MESSAGES_DROPPED": {
+        CONF_CLASS: TRUMA_SENSOR_TYPE_dummy_ns.LOG_MESSAGES_DROPPED,
+        CONF_UNIT_OF_MEASUREMENT: UNIT_EMPTY,
+        CONF_ACCURACY_DECIMALS: 0,
+        CONF_ENTITY_CATEGORY: ENTITY_CATEGORY_DIAGNOSTIC,
+    },
+    # RP2040 only (bytes lost between UART IRQ and LIN reader), always 0 on ESP32
+    "UART_BYTES_DROPPED": {
+        CONF_CLASS: TRUMA_SENSOR_TYPE_dummy_ns.UART_BYTES_DROPPED,
+        CONF_UNIT_OF_MEASUREMENT: UNIT_EMPTY,
+        CONF_ACCURACY_DECIMALS: 0,
+        CONF_ENTITY_CATEGORY: ENTITY_CATEGORY_DIAGNOSTIC,
+    },
+    # Mean time between PID byte and the start of my answer, see `response_space`
+    "LIN_RESPONSE_OFFSET": {
+        CONF_CLASS: TRUMA_SENSOR_TYPE_dummy_ns.LIN_RESPONSE_OFFSET,
+        CONF_UNIT_OF_MEASUREMENT: "µs",
+        CONF_ACCURACY_DECIMALS: 0,
+        CONF_ENTITY_CATEGORY: ENTITY_CATEGORY_DIAGNOSTIC,
+    },
 }
 
 
@@ -102,6 +131,8 @@ def set_default_based_on_type():
             config[CONF_ACCURACY_DECIMALS] = sensor_type[CONF_ACCURACY_DECIMALS]
         if CONF_DEVICE_CLASS in sensor_type and CONF_DEVICE_CLASS not in config:
             config[CONF_DEVICE_CLASS] = sensor_type[CONF_DEVICE_CLASS]
+        if CONF_ENTITY_CATEGORY in sensor_type and CONF_ENTITY_CATEGORY not in config:
+            config[CONF_ENTITY_CATEGORY] = cv.entity_category(sensor_type[CONF_ENTITY_CATEGORY])
         return config
 
     return set_defaults_
@@ -0,0 +1,90 @@
+#include "capture.h"
+#include "freertos/FreeRTOS.h"
+#include <string.h>
+
+_Static_assert((CAPTURE_RING_SIZE & (CAPTURE_RING_SIZE - 1)) == 0,
+               "CAPTURE_RING_SIZE muss eine Zweierpotenz sein");
+
+static capture_rec_t ring[CAPTURE_RING_SIZE];
+static uint32_t head_seq = 0;
+
+// Kurze kritische Abschnitte (ein bzw. wenige memcpy), daher Spinlock statt Mutex
+static portMUX_TYPE ring_lock = portMUX_INITIALIZER_UNLOCKED;
+
+void capture_push(capture_rec_t *rec)
+{
+    taskENTER_CRITICAL(&ring_lock);
+    rec->seq = ++head_seq;
+    if (rec->seq == 0) {
+        // Überlauf nach 2^32 Frames: 0 bleibt für "leer" reserviert
+        rec->seq = head_seq = 1;
+    }
+    memcpy(&ring[rec->seq & (CAPTURE_RING_SIZE - 1)], rec, sizeof(*rec));
+    taskEXIT_CRITICAL(&ring_lock);
+}
+
+uint32_t capture_head(void)
+{
+    return __atomic_load_n(&head_seq, __ATOMIC_RELAXED);
+}
+
+size_t capture_read(uint32_t *next_seq, capture_rec_t *out, size_t max, uint32_t *lost)
+{
+    size_t n = 0;
+
+    taskENTER_CRITICAL(&ring_lock);
+    uint32_t head = head_seq;
+    uint32_t avail = head - *next_seq + 1;
+
+    if ((int32_t)avail > 0) {
+        if (avail > CAPTURE_RING_SIZE) {
+            // Leser wurde überholt: auf ältesten gültigen Eintrag springen
+            uint32_t oldest = head - CAPTURE_RING_SIZE + 1;
+            if (lost) {
+                *lost += oldest - *next_seq;
+            }
+            *next_seq = oldest;
+            avail = CAPTURE_RING_SIZE;
+        }
+        n = avail < max ? avail : max;
+        for (size_t i = 0; i < n; i++) {
+            memcpy(&out[i], &ring[(*next_seq + i) & (CAPTURE_RING_SIZE - 1)], sizeof(*out));
+        }
+        *next_seq += n;
+    }
+    taskEXIT_CRITICAL(&ring_lock);
+
+    return n;
+}
+
+size_t capture_peek(uint32_t *next_seq, const capture_rec_t **span, uint32_t *lost)
+{
+    size_t n = 0;
+
+    taskENTER_CRITICAL(&ring_lock);
+    uint32_t head = head_seq;
+    uint32_t avail = head - *next_seq + 1;
+
+    if ((int32_t)avail > 0) {
+        if (avail > CAPTURE_RING_SIZE) {
+            uint32_t oldest = head - CAPTURE_RING_SIZE + 1;
+            if (lost) {
+                *lost += oldest - *next_seq;
+            }
+            *next_seq = oldest;
+            avail = CAPTURE_RING_SIZE;
+        }
+        uint32_t idx = *next_seq & (CAPTURE_RING_SIZE - 1);
+        uint32_t to_end = CAPTURE_RING_SIZE - idx;
+        n = avail < to_end ? avail : to_end;
+        *span = &ring[idx];
+    }
+    taskEXIT_CRITICAL(&ring_lock);
+
+    return n;
+}
+
+bool capture_lapped(uint32_t seq)
+{
+    return capture_head() - seq >= CAPTURE_RING_SIZE;
+}
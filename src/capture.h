@@ -0,0 +1,65 @@
+#ifndef CAPTURE_H
+#define CAPTURE_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+// Capture-Ring für LIN-Frames: mehrere Produzenten (Proxy-Tasks), beliebig viele
+// Leser mit eigener Leseposition. Der Ring überschreibt die ältesten Einträge,
+// Produzenten werden also nie von langsamen Lesern ausgebremst. Leser erkennen
+// verlorene Einträge an Lücken in der Sequenznummer.
+
+#ifndef CAPTURE_RING_SIZE
+#define CAPTURE_RING_SIZE 256   // Einträge, Zweierpotenz (256 x 32 Byte = 8 KB)
+#endif
+
+#define CAPTURE_MAX_DATA 10     // 8 Datenbytes + Checksumme + Reserve
+
+// Flags pro Frame
+#define CAPTURE_F_PARITY_OK   0x01  // ID-Parität korrekt
+#define CAPTURE_F_CLASSIC_OK  0x02  // Classic-Checksumme passt
+#define CAPTURE_F_ENHANCED_OK 0x04  // Enhanced-Checksumme passt
+#define CAPTURE_F_NO_RESPONSE 0x08  // Header ohne Antwort
+#define CAPTURE_F_TRUNCATED   0x10  // Mehr Bytes empfangen als gespeichert
+
+#define CAPTURE_US_NONE 0xFFFF      // Zeitfeld nicht verfügbar
+
+// Fester 32-Byte-Datensatz, identisches Layout im Web-Client (Little Endian)
+typedef struct __attribute__((packed)) {
+    uint32_t seq;         // fortlaufend ab 1
+    uint64_t t_us;        // BREAK-Zeitpunkt (esp_timer, µs seit Boot)
+    uint16_t resp_us;     // Header -> erstes Antwortbyte
+    uint16_t sync_us;     // BREAK -> SYNC
+    uint16_t id_us;       // SYNC -> ID
+    uint8_t  link;        // log_link_t
+    uint8_t  pid;         // ID inkl. Paritätsbits
+    uint8_t  len;         // Anzahl Bytes in data (Daten + Checksumme)
+    uint8_t  flags;       // CAPTURE_F_*
+    uint8_t  data[CAPTURE_MAX_DATA];
+} capture_rec_t;
+
+_Static_assert(sizeof(capture_rec_t) == 32, "capture_rec_t muss 32 Byte groß sein");
+
+// Frame in den Ring schreiben (seq wird vergeben), aus beliebigem Task aufrufbar
+void capture_push(capture_rec_t *rec);
+
+// Sequenznummer des zuletzt geschriebenen Eintrags (0 = leer)
+uint32_t capture_head(void);
+
+// Bis zu max Einträge ab *next_seq lesen. *next_seq wird weitergesetzt.
+// Wurde der Leser überholt, springt *next_seq auf den ältesten vorhandenen
+// Eintrag und die Anzahl übersprungener Einträge wird zu *lost addiert.
+size_t capture_read(uint32_t *next_seq, capture_rec_t *out, size_t max, uint32_t *lost);
+
+// Zero-Copy-Zugriff: zusammenhängender Abschnitt ab *next_seq direkt im Ring
+// (bis Ringende bzw. neuestem Eintrag). *next_seq wird nur bei Überholung
+// verschoben (wie capture_read), sonst nicht weitergesetzt.
+// Der Abschnitt ist nur gültig, solange ihn kein Produzent überschreibt:
+// nach der Verwendung mit capture_lapped() prüfen.
+size_t capture_peek(uint32_t *next_seq, const capture_rec_t **span, uint32_t *lost);
+
+// true, wenn der Eintrag seq inzwischen überschrieben wurde
+bool capture_lapped(uint32_t seq);
+
+#endif // CAPTURE_H
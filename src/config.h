@@ -43,13 +43,39 @@
 // Logging Konfiguration
 #define LOG_TO_CONSOLE  1    // 1=ESP_LOG aktiviert
 #define LOG_TO_UDP      1    // 1=UDP Syslog aktiviert
+#define SYSLOG_FACILITY 16   // RFC-5424-Facility (16 = local0)
+
+// Zeit-Synchronisation für Syslog-Zeitstempel
+#ifndef SNTP_SERVER
+#define SNTP_SERVER     "pool.ntp.org"
+#endif
 
 // LIN Frame Logging
 #define LOG_LIN_FRAMES  1    // 1=Alle LIN-Frames loggen
 
-// LIN Sniffer Modus (nur für Testing/Debugging)
-#define LIN_SNIFFER_MODE 0   // 1=Aktiviert Sniffer auf LIN1 (deaktiviert Proxy!)
-#define SNIFFER_DETAIL_LOGS 1 // 1=Detaillierte Frame-Analyse mit Timing
+// TCP-Sink für den Capture-Ring (verlustfreie Aufzeichnung, siehe tcp_sink_receiver.py)
+#ifndef TCP_SINK_MODE
+#define TCP_SINK_MODE   0    // 0=aus, 1=Gerät verbindet zu TCP_SINK_HOST, 2=Gerät lauscht auf TCP_SINK_PORT
+#endif
+#ifndef TCP_SINK_HOST
+#define TCP_SINK_HOST   SYSLOG_SERVER
+#endif
+#ifndef TCP_SINK_PORT
+#define TCP_SINK_PORT   5515
+#endif
+
+// Start-Betriebsart der Links, solange in NVS nichts gespeichert ist
+// (zur Laufzeit per /api/config lin1_mode/lin2_mode = proxy|tap|sniffer|bypass)
+#define LIN_SNIFFER_MODE 0   // 1=Beide Links starten im Sniffer-Modus (nur mitlesen)
+#define SNIFFER_DETAIL_LOGS 1 // 1=Detaillierte Frame-Analyse mit Timing (TAP/SNIFFER)
+#ifndef LIN_TAP_POLL_MS
+#define LIN_TAP_POLL_MS 20   // Abfrageintervall des Analyse-Tasks auf den Capture-Ring
+#endif
+
+// Boot: Wartezeit nach dem Setzen der UART-Pins, bis RX-Pullup und Transceiver stabil sind
+#ifndef LIN_PIN_SETTLE_MS
+#define LIN_PIN_SETTLE_MS 20
+#endif
 
 // Firmware Version
 #define FW_VERSION      "1.0.0"
@@ -58,6 +84,51 @@
 #define OTA_ENABLED     1    // 1=OTA über HTTP aktiviert
 #define AUTO_UPDATE     1    // 1=Automatischer Versions-Check und Update
 #define UPDATE_INTERVAL 3600 // Auto-Update-Check alle 3600 Sekunden (1 Stunde)
+#ifndef OTA_BUF_SIZE
+#define OTA_BUF_SIZE    16384 // Puffer für Upload/Flash-Schreiben (8-16 KB, Heap)
+#endif
+#ifndef OTA_BUF_PSRAM
+#define OTA_BUF_PSRAM   0    // 1=Puffer bevorzugt im PSRAM (nur mit CONFIG_SPIRAM)
+#endif
+#ifndef OTA_PROGRESS_STEP
+#define OTA_PROGRESS_STEP 10 // Fortschritt nur alle N Prozent loggen (Rest: /api/ota/status)
+#endif
+// OTA-Download drosseln, damit das LIN-Timing nicht leidet
+#ifndef OTA_SLICE_SIZE
+#define OTA_SLICE_SIZE  4096 // Bytes pro Lese-/Flash-Schritt (eine Flash-Sektor-Löschung)
+#endif
+#ifndef OTA_BW_LIMIT_KBPS
+#define OTA_BW_LIMIT_KBPS 0  // Max. Download-Rate in KB/s (0 = unbegrenzt)
+#endif
+#ifndef OTA_CPU_BUDGET_PCT
+#define OTA_CPU_BUDGET_PCT 30 // Max. Anteil Arbeitszeit des OTA-Tasks in Prozent
+#endif
+#ifndef OTA_RESUME_RETRIES
+#define OTA_RESUME_RETRIES 5 // Abgebrochenen Download so oft per Range fortsetzen
+#endif
+#ifndef OTA_GZ_WINDOW_BITS
+#define OTA_GZ_WINDOW_BITS 12 // Fenster für gzip-Images (2^12 = 4 KB), muss zu tools/ota_compress.py passen
+#endif
+#ifndef OTA_DELTA_ENABLED
+#define OTA_DELTA_ENABLED 1  // 1=Auto-Update versucht zuerst ein Delta gegen die laufende Firmware
+#endif
+#ifndef LIN_LATENCY_BUDGET_US
+#define LIN_LATENCY_BUDGET_US 2500 // p99 ID->Header während eines Updates (inkl. 1500 µs BREAK)
+#endif
+
+// Systemmonitor (Tasks/CPU/Stack/Heap/Queues unter /api/sysmon)
+#ifndef SYSMON_ENABLED
+#define SYSMON_ENABLED 1     // 1=periodisch messen (braucht CONFIG_FREERTOS_USE_TRACE_FACILITY)
+#endif
+#ifndef SYSMON_INTERVAL_MS
+#define SYSMON_INTERVAL_MS 1000 // Messintervall
+#endif
+#ifndef SYSMON_HISTORY
+#define SYSMON_HISTORY 60    // Messungen im Verlauf (60 x 1 s)
+#endif
+#ifndef SYSMON_MAX_TASKS
+#define SYSMON_MAX_TASKS 24  // Tasks im Verlauf; weitere werden nur gezählt
+#endif
 
 // Web-Interface
 #define WEB_SERVER_ENABLED  1   // 1=HTTP-Server für Web-Interface
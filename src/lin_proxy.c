@@ -8,10 +8,17 @@
 #include "esp_log.h"
 #include "esp_rom_sys.h"
 #include "esp_timer.h"
+#include "nvs_flash.h"
 #include "config.h"
+#include "lin_proxy.h"
 #include "network.h"
 #include "ota.h"
 #include "webserver.h"
+#include "log_filter.h"
+#include "proxy_config.h"
+#include "capture.h"
+#include "tcp_sink.h"
+#include "sysmon.h"
 
 #define TAG "LIN_PROXY"
 
@@ -34,15 +41,12 @@
 #define LIN2_RX   GPIO_NUM_13
 #define LIN2_TX   GPIO_NUM_12
 
-#define UART_BUF  2048
-
 // Pins erst verarbeiten, wenn sie gesetzt wurden (Pin-Strapping Stabilisierung)
 static volatile bool lin1_pins_ready = false;
 static volatile bool lin2_pins_ready = false;
 
-// Grenzen für Sync-Suche nach BREAK
-#define SYNC_SEARCH_MAX_BYTES 3      // max. Nicht-0x55 Bytes direkt nach BREAK tolerieren
-#define SYNC_SEARCH_MAX_US    600    // max. Zeitfenster in µs nach BREAK für SYNC
+// Grenzen für Sync-Suche, BREAK-Länge, RX-Timeout, UART-Puffer und Rollen kommen
+// aus proxy_config (zur Laufzeit über /api/config änderbar)
 
 // Einfacher Antwort-Tracker zwischen LIN1 (Header) und LIN2 (Daten)
 typedef struct {
@@ -54,6 +58,20 @@ typedef struct {
 
 static response_tracker_t g_resp = {0};
 
+// Zeitpunkt des letzten BREAK auf LIN1 (für lin_proxy_frame_in_flight)
+static volatile int64_t g_last_break_us = 0;
+
+// Boot-Phasen (nur einmal geschrieben, siehe lin_proxy_boot_t)
+static lin_proxy_boot_t g_boot;
+
+// Latenz-Histogramm ID -> Header (nur vom Master-Task geschrieben)
+static const uint32_t lat_edges[LIN_LAT_BUCKETS] = {
+    250, 500, 750, 1000, 1250, 1500, 1750, 2000,
+    2500, 3000, 4000, 5000, 7500, 10000, 20000, UINT32_MAX
+};
+static lin_latency_hist_t g_lat;
+static portMUX_TYPE lat_lock = portMUX_INITIALIZER_UNLOCKED;
+
 typedef enum {
     ST_IDLE = 0,
     ST_GOT_BREAK,
@@ -70,17 +88,73 @@ typedef struct {
     lin_state_t st;
     uint8_t last_id;
     const char *name;         // z.B. "LIN1→LIN2"
+    log_link_t link;          // Eingangs-Link für Laufzeit-Log-Filter
     uint8_t frame_buf[20];    // Buffer für komplettes Frame
     uint8_t frame_len;        // Länge des aktuellen Frames
     bool is_master;           // true = Master→Slave (Header regenerieren), false = Slave→Master (nur Daten)
     int64_t break_timestamp;  // Timestamp des Break-Events für Timing-Analyse
     int64_t sync_timestamp;   // Timestamp des Sync-Bytes
     int64_t id_timestamp;     // Timestamp des ID-Bytes
+    int64_t data_timestamp;   // Timestamp des ersten Antwort-/Datenbytes
     uint8_t sync_search_count; // Anzahl der Nicht-0x55 Bytes nach BREAK
+    const proxy_config_t *cfg; // Konfigurations-Snapshot für das laufende Frame
+    uint32_t cfg_gen;          // Generation von cfg beim Übernehmen
+    lin_mode_t mode;           // Betriebsart aus cfg (PROXY/TAP/SNIFFER/BYPASS)
 } lin_link_t;
 
 static inline void delay_us(int us) { esp_rom_delay_us(us); }
 
+bool lin_proxy_frame_in_flight(void)
+{
+    int64_t last = g_last_break_us;
+    return last > 0 && esp_timer_get_time() - last < LIN_FRAME_MAX_US;
+}
+
+uint32_t lin_proxy_latency_edge(int bucket)
+{
+    return lat_edges[bucket];
+}
+
+static void latency_record(uint32_t us)
+{
+    int i = 0;
+    while (us > lat_edges[i]) i++;
+    taskENTER_CRITICAL(&lat_lock);
+    g_lat.count[i]++;
+    g_lat.total++;
+    if (us > g_lat.max_us) g_lat.max_us = us;
+    taskEXIT_CRITICAL(&lat_lock);
+}
+
+void lin_proxy_latency_get(lin_latency_hist_t *out)
+{
+    taskENTER_CRITICAL(&lat_lock);
+    *out = g_lat;
+    taskEXIT_CRITICAL(&lat_lock);
+}
+
+void lin_proxy_latency_reset(void)
+{
+    taskENTER_CRITICAL(&lat_lock);
+    memset(&g_lat, 0, sizeof(g_lat));
+    taskEXIT_CRITICAL(&lat_lock);
+}
+
+uint32_t lin_proxy_latency_percentile(const lin_latency_hist_t *h, int pct)
+{
+    if (h->total == 0) return 0;
+    uint32_t need = (uint32_t)(((uint64_t)h->total * pct + 99) / 100);
+    uint32_t acc = 0;
+    for (int i = 0; i < LIN_LAT_BUCKETS; i++) {
+        acc += h->count[i];
+        if (acc >= need) {
+            // Letzter Bucket ist offen: dort das gemessene Maximum melden
+            return i == LIN_LAT_BUCKETS - 1 ? h->max_us : lat_edges[i];
+        }
+    }
+    return h->max_us;
+}
+
 static void lin_send_break_gpio(gpio_num_t tx_pin, int us_low)
 {
     gpio_set_direction(tx_pin, GPIO_MODE_OUTPUT);
@@ -91,9 +165,18 @@ static void lin_send_break_gpio(gpio_num_t tx_pin, int us_low)
 
 static void lin_send_header(lin_link_t *lnk, uint8_t id)
 {
-    lin_send_break_gpio(lnk->out_tx_pin, 1500);
-    uint8_t hdr[2] = {0x55, id};
-    uart_write_bytes(lnk->out_uart, (const char*)hdr, 2);
+    // SNIFFER: Header nur aufzeichnen, nicht senden
+    if (lnk->mode != LIN_MODE_SNIFFER) {
+        lin_send_break_gpio(lnk->out_tx_pin, lnk->cfg->break_us);
+        uint8_t hdr[2] = {0x55, id};
+        uart_write_bytes(lnk->out_uart, (const char*)hdr, 2);
+        if (g_boot.first_frame_us == 0) {
+            g_boot.first_frame_us = esp_timer_get_time();
+        }
+        if (lnk->id_timestamp > 0) {
+            latency_record((uint32_t)(esp_timer_get_time() - lnk->id_timestamp));
+        }
+    }
     
     // Frame-Buffer initialisieren für Logging
     lnk->frame_buf[0] = 0x55;
@@ -101,7 +184,7 @@ static void lin_send_header(lin_link_t *lnk, uint8_t id)
     lnk->frame_len = 2;
 
     // Antwort-Tracking initialisieren (nur im Masterpfad relevant)
-    if (lnk->is_master) {
+    if (lnk->is_master && lnk->mode != LIN_MODE_SNIFFER) {
         g_resp.expecting = true;
         g_resp.got = false;
         g_resp.id = id;
@@ -114,6 +197,39 @@ static bool is_likely_break_event(uart_event_t *e)
     return (e->type == UART_BREAK) || (e->type == UART_FRAME_ERR);
 }
 
+// Neue Konfiguration übernehmen (nur an Frame-Grenzen aufrufen)
+static void link_apply_config(lin_link_t *lnk)
+{
+    const proxy_config_t *c = proxy_config_get();
+    if (lnk->cfg && c->gen == lnk->cfg_gen) return;
+
+    if (!lnk->cfg || c->rx_timeout != lnk->cfg->rx_timeout) {
+        uart_set_rx_timeout(lnk->in_uart, c->rx_timeout);
+    }
+    bool master = c->master_link == lnk->link;
+    if (lnk->cfg && master != lnk->is_master) {
+        ESP_LOGW(TAG, "[%s] Rolle gewechselt: %s", lnk->name, master ? "Master→Slave" : "Slave→Master");
+        lnk->st = ST_IDLE;
+        lnk->frame_len = 0;
+        g_resp.expecting = false;
+    }
+    lin_mode_t mode = c->mode[lnk->link];
+    if (lnk->cfg && mode != lnk->mode) {
+        ESP_LOGW(TAG, "[%s] Modus %s -> %s", lnk->name,
+                 proxy_config_mode_name(lnk->mode), proxy_config_mode_name(mode));
+        lnk->st = ST_IDLE;
+        lnk->frame_len = 0;
+        // Ohne Header-Regenerierung kommt keine Antwort mehr, auf die der Slave-Pfad wartet
+        if (master && (mode == LIN_MODE_SNIFFER || mode == LIN_MODE_BYPASS)) {
+            g_resp.expecting = false;
+        }
+    }
+    lnk->is_master = master;
+    lnk->mode = mode;
+    lnk->cfg = c;
+    lnk->cfg_gen = c->gen;
+}
+
 // Berechne LIN ID Parität (P0 und P1)
 static uint8_t lin_calc_id_parity(uint8_t id_no_parity)
 {
@@ -153,9 +269,52 @@ static uint8_t lin_calc_checksum_enhanced(uint8_t id, const uint8_t *data, uint8
     return ~sum;
 }
 
+// Zeitdifferenz für Capture-Datensatz (16 Bit, CAPTURE_US_NONE wenn unbekannt)
+static uint16_t capture_delta_us(int64_t from, int64_t to)
+{
+    if (from <= 0 || to < from) return CAPTURE_US_NONE;
+    int64_t d = to - from;
+    return d >= CAPTURE_US_NONE ? CAPTURE_US_NONE - 1 : (uint16_t)d;
+}
+
+// Abgeschlossenes Frame in den Capture-Ring schreiben (unabhängig vom Log-Filter)
+static void capture_lin_frame(lin_link_t *lnk)
+{
+    capture_rec_t rec = {0};
+    int data_len = lnk->frame_len > 2 ? lnk->frame_len - 2 : 0;
+
+    rec.t_us = lnk->break_timestamp;
+    rec.sync_us = capture_delta_us(lnk->break_timestamp, lnk->sync_timestamp);
+    rec.id_us = capture_delta_us(lnk->sync_timestamp, lnk->id_timestamp);
+    rec.resp_us = data_len ? capture_delta_us(lnk->id_timestamp, lnk->data_timestamp) : CAPTURE_US_NONE;
+    rec.link = lnk->link;
+    rec.pid = lnk->last_id;
+    rec.len = data_len > CAPTURE_MAX_DATA ? CAPTURE_MAX_DATA : data_len;
+    memcpy(rec.data, &lnk->frame_buf[2], rec.len);
+
+    if (lin_check_id_parity(lnk->last_id)) rec.flags |= CAPTURE_F_PARITY_OK;
+    if (data_len == 0 && (rec.flags & CAPTURE_F_PARITY_OK)) rec.flags |= CAPTURE_F_NO_RESPONSE;
+    if (data_len > CAPTURE_MAX_DATA) rec.flags |= CAPTURE_F_TRUNCATED;
+    if (data_len >= 2) {
+        uint8_t cs = lnk->frame_buf[lnk->frame_len - 1];
+        if (lin_calc_checksum_classic(&lnk->frame_buf[2], data_len - 1) == cs) {
+            rec.flags |= CAPTURE_F_CLASSIC_OK;
+        }
+        if (lin_calc_checksum_enhanced(lnk->last_id, &lnk->frame_buf[2], data_len - 1) == cs) {
+            rec.flags |= CAPTURE_F_ENHANCED_OK;
+        }
+    }
+
+    capture_push(&rec);
+}
+
 static void log_lin_frame(lin_link_t *lnk)
 {
 #if LOG_LIN_FRAMES
+    if (!log_filter_allows(lnk->link, lnk->last_id, LOG_SEV_INFO)) {
+        return;
+    }
+
     char log_buf[256];
     int offset = snprintf(log_buf, sizeof(log_buf), "[%s] ID=0x%02X Data=", 
                           lnk->name, lnk->last_id);
@@ -166,24 +325,29 @@ static void log_lin_frame(lin_link_t *lnk)
     }
     
     ESP_LOGI(TAG, "%s", log_buf);
-    network_log(log_buf);
+    network_log_sd_t sd = { "FRAME", lnk->link, lnk->last_id & 0x3F, -1 };
+    network_log_sd(LOG_SEV_INFO, &sd, log_buf);
 #endif
 }
 
-#if LIN_SNIFFER_MODE
-// Detaillierte Frame-Analyse für Sniffer-Modus
-static void sniffer_analyze_frame(lin_link_t *lnk)
+// Detaillierte Frame-Analyse für TAP/SNIFFER: läuft im Analyse-Task auf den
+// Capture-Datensätzen, nicht im Proxy-Task
+static void tap_analyze_record(const capture_rec_t *rec)
 {
+    if (!log_filter_allows(rec->link, rec->pid, LOG_SEV_INFO)) {
+        return;
+    }
+
     char log_buf[512];
     int offset = 0;
     
     // Basis-Informationen
-    uint8_t id_raw = lnk->last_id;
+    uint8_t id_raw = rec->pid;
     uint8_t id_no_parity = id_raw & 0x3F;
-    bool parity_ok = lin_check_id_parity(id_raw);
+    bool parity_ok = rec->flags & CAPTURE_F_PARITY_OK;
     
     offset += snprintf(log_buf + offset, sizeof(log_buf) - offset,
-                      "\n========== LIN FRAME ==========\n");
+                      "\n========== LIN FRAME (%s) ==========\n", log_filter_link_name(rec->link));
     offset += snprintf(log_buf + offset, sizeof(log_buf) - offset,
                       "ID: 0x%02X (raw) / 0x%02X (no parity)\n", id_raw, id_no_parity);
     offset += snprintf(log_buf + offset, sizeof(log_buf) - offset,
@@ -191,36 +355,40 @@ static void sniffer_analyze_frame(lin_link_t *lnk)
     
 #if SNIFFER_DETAIL_LOGS
     // Timing-Analyse
-    if (lnk->break_timestamp > 0 && lnk->sync_timestamp > 0) {
-        int64_t break_to_sync = lnk->sync_timestamp - lnk->break_timestamp;
+    if (rec->sync_us != CAPTURE_US_NONE) {
+        offset += snprintf(log_buf + offset, sizeof(log_buf) - offset,
+                          "Break→Sync: %u µs\n", rec->sync_us);
+    }
+    if (rec->id_us != CAPTURE_US_NONE) {
         offset += snprintf(log_buf + offset, sizeof(log_buf) - offset,
-                          "Break→Sync: %lld µs\n", break_to_sync);
+                          "Sync→ID: %u µs\n", rec->id_us);
     }
-    if (lnk->sync_timestamp > 0 && lnk->id_timestamp > 0) {
-        int64_t sync_to_id = lnk->id_timestamp - lnk->sync_timestamp;
+    if (rec->resp_us != CAPTURE_US_NONE) {
         offset += snprintf(log_buf + offset, sizeof(log_buf) - offset,
-                          "Sync→ID: %lld µs\n", sync_to_id);
+                          "ID→Antwort: %u µs\n", rec->resp_us);
     }
 #endif
     
-    // Daten-Bytes
-    int data_len = lnk->frame_len - 2;  // Ohne Sync + ID
+    // Daten-Bytes (inkl. Checksumme)
+    int data_len = rec->len;
     offset += snprintf(log_buf + offset, sizeof(log_buf) - offset,
-                      "Data Length: %d bytes\n", data_len);
+                      "Data Length: %d bytes%s\n", data_len,
+                      (rec->flags & CAPTURE_F_TRUNCATED) ? " (gekürzt)" :
+                      (rec->flags & CAPTURE_F_NO_RESPONSE) ? " (keine Antwort)" : "");
     
     if (data_len > 0) {
         offset += snprintf(log_buf + offset, sizeof(log_buf) - offset, "Data: ");
         for (int i = 0; i < data_len && offset < sizeof(log_buf) - 20; i++) {
             offset += snprintf(log_buf + offset, sizeof(log_buf) - offset,
-                              "%02X ", lnk->frame_buf[2 + i]);
+                              "%02X ", rec->data[i]);
         }
         offset += snprintf(log_buf + offset, sizeof(log_buf) - offset, "\n");
         
         // Checksumme prüfen (letztes Byte ist Checksumme)
         if (data_len >= 2) {
-            uint8_t checksum_received = lnk->frame_buf[lnk->frame_len - 1];
-            uint8_t checksum_classic = lin_calc_checksum_classic(&lnk->frame_buf[2], data_len - 1);
-            uint8_t checksum_enhanced = lin_calc_checksum_enhanced(id_raw, &lnk->frame_buf[2], data_len - 1);
+            uint8_t checksum_received = rec->data[data_len - 1];
+            uint8_t checksum_classic = lin_calc_checksum_classic(rec->data, data_len - 1);
+            uint8_t checksum_enhanced = lin_calc_checksum_enhanced(id_raw, rec->data, data_len - 1);
             
             offset += snprintf(log_buf + offset, sizeof(log_buf) - offset,
                               "Checksum: 0x%02X (received)\n", checksum_received);
@@ -237,98 +405,87 @@ static void sniffer_analyze_frame(lin_link_t *lnk)
                       "==============================\n");
     
     ESP_LOGI(TAG, "%s", log_buf);
-    network_log(log_buf);
+    network_log_sd_t sd = { "FRAME", rec->link, id_no_parity, -1 };
+    network_log_sd(LOG_SEV_INFO, &sd, log_buf);
 }
 
-// Sniffer-Task für LIN1 (nur Listen, kein Weiterleiten)
-static void lin_sniffer_task(void *arg)
+static bool mode_is_analyzed(uint32_t mode)
 {
-    lin_link_t *lnk = (lin_link_t*)arg;
-    uart_event_t e;
-    uint8_t b;
-    
-    ESP_LOGI(TAG, "[SNIFFER] Task gestartet auf %s (nur Analyse, kein Proxy!)", lnk->name);
-    ESP_LOGI(TAG, "[SNIFFER] Warte auf LIN-Traffic...");
+    return mode == LIN_MODE_TAP || mode == LIN_MODE_SNIFFER;
+}
 
-    while (1) {
-        if (xQueueReceive(lnk->q, &e, portMAX_DELAY) != pdTRUE) continue;
+// Analyse-Task: liest den Capture-Ring wie ein Live-Client und analysiert die
+// Frames der Links im TAP-/SNIFFER-Modus. Kommt er nicht hinterher, überspringt
+// er Frames, der Proxy wird nie gebremst.
+static void lin_tap_task(void *arg)
+{
+    capture_rec_t recs[8];
+    uint32_t next_seq = capture_head() + 1;
+    uint32_t lost = 0, reported = 0;
 
-        // Handle overflow
-        if (e.type == UART_FIFO_OVF || e.type == UART_BUFFER_FULL) {
-            ESP_LOGW(TAG, "[SNIFFER] UART overflow -> flush");
-            uart_flush_input(lnk->in_uart);
-            xQueueReset(lnk->q);
-            lnk->st = ST_IDLE;
-            lnk->frame_len = 0;
+    while (1) {
+        const proxy_config_t *cfg = proxy_config_get();
+        if (!mode_is_analyzed(cfg->mode[LOG_LINK_LIN1]) && !mode_is_analyzed(cfg->mode[LOG_LINK_LIN2])) {
+            next_seq = capture_head() + 1;
+            vTaskDelay(pdMS_TO_TICKS(LIN_TAP_POLL_MS * 5));
             continue;
         }
 
-        // Break-Detection
-        if (is_likely_break_event(&e)) {
-            // Frame abschließen falls noch Daten da
-            if (lnk->st == ST_DATA && lnk->frame_len > 2) {
-                sniffer_analyze_frame(lnk);
+        size_t n = capture_read(&next_seq, recs, sizeof(recs) / sizeof(recs[0]), &lost);
+        if (lost != reported) {
+            ESP_LOGW(TAG, "[TAP] %lu Frames nicht analysiert (Analyse zu langsam)", (unsigned long)(lost - reported));
+            reported = lost;
+        }
+        for (size_t i = 0; i < n; i++) {
+            if (recs[i].link < LOG_LINK_COUNT && mode_is_analyzed(cfg->mode[recs[i].link])) {
+                tap_analyze_record(&recs[i]);
             }
-            
-            lnk->break_timestamp = esp_timer_get_time();
-            ESP_LOGI(TAG, "[SNIFFER] >>> BREAK erkannt <<<");
-            lnk->st = ST_GOT_BREAK;
-            lnk->frame_len = 0;
-            continue;
         }
+        if (n < sizeof(recs) / sizeof(recs[0])) {
+            vTaskDelay(pdMS_TO_TICKS(LIN_TAP_POLL_MS));
+        }
+    }
+}
 
-        if (e.type == UART_DATA) {
-            int len = e.size;
-            while (len-- > 0) {
-                if (uart_read_bytes(lnk->in_uart, &b, 1, 0) != 1) break;
-
-                switch (lnk->st) {
-                    case ST_IDLE:
-                        // Im IDLE ignorieren (kein Frame aktiv)
-                        ESP_LOGD(TAG, "[SNIFFER] IDLE: Byte 0x%02X (ignoriert)", b);
-                        break;
-
-                    case ST_GOT_BREAK:
-                        if (b == LIN_SYNC_BYTE) {
-                            lnk->sync_timestamp = esp_timer_get_time();
-                            lnk->frame_buf[0] = b;
-                            lnk->frame_len = 1;
-                            lnk->st = ST_GOT_SYNC;
-                            ESP_LOGI(TAG, "[SNIFFER] SYNC: 0x%02X", b);
-                        } else {
-                            ESP_LOGW(TAG, "[SNIFFER] Nach BREAK kein SYNC: 0x%02X -> IDLE", b);
-                            lnk->st = ST_IDLE;
-                        }
-                        break;
-
-                    case ST_GOT_SYNC:
-                        lnk->id_timestamp = esp_timer_get_time();
-                        lnk->last_id = b;
-                        lnk->frame_buf[lnk->frame_len++] = b;
-                        lnk->st = ST_GOT_ID;
-                        ESP_LOGI(TAG, "[SNIFFER] ID: 0x%02X", b);
-                        break;
+// Frame abgeschlossen: Capture immer, Kurz-Log nur im PROXY-Modus
+// (TAP/SNIFFER loggt der Analyse-Task ausführlich)
+static void finish_lin_frame(lin_link_t *lnk)
+{
+    capture_lin_frame(lnk);
+    if (lnk->mode == LIN_MODE_PROXY) {
+        log_lin_frame(lnk);
+    }
+}
 
-                    case ST_GOT_ID:
-                    case ST_DATA:
-                        if (lnk->frame_len < sizeof(lnk->frame_buf)) {
-                            lnk->frame_buf[lnk->frame_len++] = b;
-                        }
-                        lnk->st = ST_DATA;
-                        ESP_LOGD(TAG, "[SNIFFER] Data[%d]: 0x%02X", lnk->frame_len - 2, b);
-                        
-                        // Bei typischer Frame-Länge (2-9 Bytes Daten+Checksum) Frame abschließen
-                        if (lnk->frame_len >= 3 && lnk->frame_len <= 10) {
-                            // Warte kurz ob noch mehr Daten kommen (Inter-Byte-Timeout)
-                            vTaskDelay(pdMS_TO_TICKS(5));
-                        }
-                        break;
-                }
-            }
+// BYPASS: BREAK sofort regenerieren und alle Bytes roh weiterreichen,
+// ohne Parsen, Log und Capture (kleinste Latenz)
+static void bypass_event(lin_link_t *lnk, uart_event_t *e)
+{
+    if (is_likely_break_event(e)) {
+        if (lnk->is_master) {
+            uart_flush_input(lnk->in_uart);
+            lin_send_break_gpio(lnk->out_tx_pin, lnk->cfg->break_us);
+            g_last_break_us = esp_timer_get_time();
+            lnk->st = ST_GOT_BREAK;
         }
+        return;
+    }
+    if (e->type != UART_DATA) {
+        return;
+    }
+
+    uint8_t buf[128];
+    int len = uart_read_bytes(lnk->in_uart, buf, e->size > sizeof(buf) ? sizeof(buf) : e->size, 0);
+    int off = 0;
+    if (lnk->st == ST_GOT_BREAK) {
+        // 0x00 direkt nach BREAK kommt vom langen Low (Framing Error)
+        while (off < len && buf[off] == 0x00) off++;
+        if (off < len) lnk->st = ST_DATA;
+    }
+    if (len > off) {
+        uart_write_bytes(lnk->out_uart, (const char *)buf + off, len - off);
     }
 }
-#endif
 
 static void uart_init_lin(uart_port_t uart, int tx, int rx, QueueHandle_t *out_q)
 {
@@ -343,44 +500,29 @@ static void uart_init_lin(uart_port_t uart, int tx, int rx, QueueHandle_t *out_q
 
     // Erst Konfiguration setzen, dann Treiber installieren (stabiler laut ESP-IDF Praxis)
     uart_param_config(uart, &cfg);
-    uart_driver_install(uart, UART_BUF, UART_BUF, 20, out_q, 0);
-    uart_set_rx_timeout(uart, 2);   // Kurzes Timeout, um Frames schneller abzuschließen
+    // Puffergröße nur beim Boot; das RX-Timeout setzt link_apply_config (kurz, um Frames schneller abzuschließen)
+    uint32_t buf = proxy_config_get()->uart_buf;
+    uart_driver_install(uart, buf, buf, 20, out_q, 0);
+    uart_set_rx_timeout(uart, proxy_config_get()->rx_timeout);
 }
 
-static void uart_apply_pins_delayed(void *arg)
+// Pins eines Links setzen. Die Strapping-Pins (GPIO12/MTDI = LIN2_TX,
+// GPIO15/MTDO = LIN1_TX) werden nur beim Reset gelesen und sind beim Start von
+// app_main bereits übernommen; eine längere Wartezeit ist daher nicht nötig.
+static void uart_apply_pins(const char *name, uart_port_t uart, gpio_num_t tx, gpio_num_t rx, volatile bool *ready)
 {
-    // Warte bewusst bis System vollständig gebootet hat (Strapping stabil)
-    vTaskDelay(pdMS_TO_TICKS(3000));
-
-    ESP_LOGI(TAG, "Starte UART-Pin-Konfiguration...");
-    
-    // LIN1 Pins setzen
-    ESP_LOGI(TAG, "Setze LIN1 Pins: TX=%d RX=%d", (int)LIN1_TX, (int)LIN1_RX);
-    esp_err_t ret1 = uart_set_pin(LIN1_UART, LIN1_TX, LIN1_RX, UART_PIN_NO_CHANGE, UART_PIN_NO_CHANGE);
-    ESP_LOGI(TAG, "LIN1 uart_set_pin: %s", ret1 == ESP_OK ? "OK" : esp_err_to_name(ret1));
+    esp_err_t ret = uart_set_pin(uart, tx, rx, UART_PIN_NO_CHANGE, UART_PIN_NO_CHANGE);
+    ESP_LOGI(TAG, "%s Pins TX=%d RX=%d: %s", name, (int)tx, (int)rx, ret == ESP_OK ? "OK" : esp_err_to_name(ret));
     // RX mit Pullup stabilisieren, sonst können vor der Pin-Zuweisung Zufalls-Events auftreten
-    gpio_set_pull_mode(LIN1_RX, GPIO_PULLUP_ONLY);
-    uart_flush_input(LIN1_UART);
-    lin1_pins_ready = true;
-    vTaskDelay(pdMS_TO_TICKS(100));
-    
-    // LIN2 Pins setzen
-    ESP_LOGI(TAG, "Setze LIN2 Pins: TX=%d RX=%d", (int)LIN2_TX, (int)LIN2_RX);
-    esp_err_t ret2 = uart_set_pin(LIN2_UART, LIN2_TX, LIN2_RX, UART_PIN_NO_CHANGE, UART_PIN_NO_CHANGE);
-    ESP_LOGI(TAG, "LIN2 uart_set_pin: %s", ret2 == ESP_OK ? "OK" : esp_err_to_name(ret2));
-    gpio_set_pull_mode(LIN2_RX, GPIO_PULLUP_ONLY);
-    uart_flush_input(LIN2_UART);
-    lin2_pins_ready = true;
-    vTaskDelay(pdMS_TO_TICKS(100));
-
-    ESP_LOGI(TAG, "UART-Pins konfiguriert! Warte auf LIN-Events...");
-    
-    // Periodisches Lebenszeichen
-    int alive_count = 0;
-    while (1) {
-        vTaskDelay(pdMS_TO_TICKS(5000));
-        ESP_LOGI(TAG, "System läuft... (%d)", ++alive_count);
-    }
+    gpio_set_pull_mode(rx, GPIO_PULLUP_ONLY);
+    vTaskDelay(pdMS_TO_TICKS(LIN_PIN_SETTLE_MS));
+    uart_flush_input(uart);
+    *ready = true;
+}
+
+void lin_proxy_boot_get(lin_proxy_boot_t *out)
+{
+    *out = g_boot;
 }
 
 static void lin_proxy_task(void *arg)
@@ -389,6 +531,7 @@ static void lin_proxy_task(void *arg)
     uart_event_t e;
     uint8_t b;
     
+    link_apply_config(lnk);
     ESP_LOGI(TAG, "[%s] Proxy-Task gestartet (%s)", lnk->name, lnk->is_master ? "Master→Slave" : "Slave→Master");
 
     while (1) {
@@ -418,6 +561,17 @@ static void lin_proxy_task(void *arg)
             continue;
         }
 
+        // Frame-Grenze: Master beim BREAK, Slave wenn keine Antwort aussteht.
+        // Bis dahin arbeitet das Frame mit dem alten Snapshot weiter.
+        if (is_likely_break_event(&e) || (lnk->st == ST_IDLE && !g_resp.expecting)) {
+            link_apply_config(lnk);
+        }
+
+        if (lnk->mode == LIN_MODE_BYPASS) {
+            bypass_event(lnk, &e);
+            continue;
+        }
+
         // Slave→Master: Nur Daten blind durchreichen, keine Break-Detection
         if (!lnk->is_master) {
             if (e.type == UART_DATA) {
@@ -429,13 +583,18 @@ static void lin_proxy_task(void *arg)
                         g_resp.got = true;
                         int64_t now = esp_timer_get_time();
                         int64_t dt = now - g_resp.t_us;
-                        ESP_LOGI(TAG, "[%s] Antwort auf ID 0x%02X nach %lld µs (%d Bytes)", lnk->name, g_resp.id, dt, len);
-                        char m[128];
-                        snprintf(m, sizeof(m), "Response for ID 0x%02X in %lldus", g_resp.id, dt);
-                        network_log(m);
+                        if (log_filter_allows(lnk->link, g_resp.id, LOG_SEV_INFO)) {
+                            ESP_LOGI(TAG, "[%s] Antwort auf ID 0x%02X nach %lld µs (%d Bytes)", lnk->name, g_resp.id, dt, len);
+                            char m[128];
+                            snprintf(m, sizeof(m), "Response for ID 0x%02X in %lldus", g_resp.id, dt);
+                            network_log_sd_t sd = { "RESP", lnk->link, g_resp.id & 0x3F, dt };
+                            network_log_sd(LOG_SEV_INFO, &sd, m);
+                        }
+                    }
+                    if (lnk->mode != LIN_MODE_SNIFFER) {
+                        uart_write_bytes(lnk->out_uart, (const char*)buf, len);
+                        ESP_LOGD(TAG, "[%s] Slave-Response: %d Bytes durchgereicht", lnk->name, len);
                     }
-                    uart_write_bytes(lnk->out_uart, (const char*)buf, len);
-                    ESP_LOGD(TAG, "[%s] Slave-Response: %d Bytes durchgereicht", lnk->name, len);
                 }
             }
             continue;
@@ -446,24 +605,37 @@ static void lin_proxy_task(void *arg)
         if (is_likely_break_event(&e)) {
             // Bei neuem Break: vorheriges Frame loggen falls vorhanden
             if (lnk->st == ST_DATA && lnk->frame_len > 2) {
-                log_lin_frame(lnk);
+                finish_lin_frame(lnk);
+            } else if (lnk->st == ST_GOT_ID) {
+                capture_lin_frame(lnk);
             }
             
             // Wenn wir auf eine Antwort gewartet haben, aber bis zum nächsten BREAK nichts kam
             if (lnk->is_master && g_resp.expecting && !g_resp.got) {
-                ESP_LOGW(TAG, "[%s] KEINE Antwort auf ID 0x%02X innerhalb eines Zyklus", lnk->name, g_resp.id);
-                char buf[96];
-                snprintf(buf, sizeof(buf), "No response for ID 0x%02X", g_resp.id);
-                network_log(buf);
+                // Fehlende Antwort gehört zum Slave-Link
+                log_link_t slave = lnk->link == LOG_LINK_LIN1 ? LOG_LINK_LIN2 : LOG_LINK_LIN1;
+                if (log_filter_allows(slave, g_resp.id, LOG_SEV_WARN)) {
+                    ESP_LOGW(TAG, "[%s] KEINE Antwort auf ID 0x%02X innerhalb eines Zyklus", lnk->name, g_resp.id);
+                    char buf[96];
+                    snprintf(buf, sizeof(buf), "No response for ID 0x%02X", g_resp.id);
+                    network_log_sd_t sd = { "NORESP", slave, g_resp.id & 0x3F, -1 };
+                    network_log_sd(LOG_SEV_WARN, &sd, buf);
+                }
                 g_resp.expecting = false;
             }
 
-            ESP_LOGI(TAG, "[%s] BREAK erkannt! (event type=%d, prev_state=%d)", lnk->name, e.type, lnk->st);
+            if (log_filter_link_enabled(lnk->link, LOG_SEV_DEBUG)) {
+                ESP_LOGD(TAG, "[%s] BREAK erkannt! (event type=%d, prev_state=%d)", lnk->name, e.type, lnk->st);
+            }
             // Flush, um evtl. 0x00/Rauschen aus dem BREAK zu entfernen
             uart_flush_input(lnk->in_uart);
             lnk->st = ST_GOT_BREAK;
             lnk->frame_len = 0;
             lnk->break_timestamp = esp_timer_get_time();
+            g_last_break_us = lnk->break_timestamp;
+            lnk->sync_timestamp = 0;
+            lnk->id_timestamp = 0;
+            lnk->data_timestamp = 0;
             lnk->sync_search_count = 0;
             continue;
         }
@@ -471,7 +643,7 @@ static void lin_proxy_task(void *arg)
         // UART Pattern Detection oder Timeout während Frame-Empfang
         if (e.type == UART_PATTERN_DET || e.type == UART_EVENT_MAX) {
             if (lnk->st == ST_DATA && lnk->frame_len > 2) {
-                log_lin_frame(lnk);
+                finish_lin_frame(lnk);
                 lnk->st = ST_IDLE;
             }
             continue;
@@ -485,7 +657,7 @@ static void lin_proxy_task(void *arg)
                 switch (lnk->st) {
                     case ST_IDLE:
                         // Im Master-Modus keine unbekannten Bytes durchreichen
-                        if (!lnk->is_master) {
+                        if (!lnk->is_master && lnk->mode != LIN_MODE_SNIFFER) {
                             uart_write_bytes(lnk->out_uart, (char*)&b, 1);
                         }
                         break;
@@ -501,37 +673,52 @@ static void lin_proxy_task(void *arg)
                         int64_t since_break = now_us - lnk->break_timestamp;
 
                         if (b == LIN_SYNC_BYTE) {
-                            ESP_LOGI(TAG, "[%s] SYNC (0x55) empfangen", lnk->name);
+                            lnk->sync_timestamp = now_us;
+                            if (log_filter_link_enabled(lnk->link, LOG_SEV_DEBUG)) {
+                                ESP_LOGD(TAG, "[%s] SYNC (0x55) empfangen", lnk->name);
+                            }
                             lnk->st = ST_GOT_SYNC;
                         } else {
                             lnk->sync_search_count++;
-                            if (lnk->sync_search_count <= SYNC_SEARCH_MAX_BYTES && since_break <= SYNC_SEARCH_MAX_US) {
+                            if (lnk->sync_search_count <= lnk->cfg->sync_max_bytes && since_break <= lnk->cfg->sync_max_us) {
                                 // Ignoriere sporadische Bytes im Sync-Fenster
-                                ESP_LOGD(TAG, "[%s] Ignoriere 0x%02X im Sync-Fenster (%d/%d, %lldus)",
-                                         lnk->name, b, lnk->sync_search_count, SYNC_SEARCH_MAX_BYTES, since_break);
+                                ESP_LOGD(TAG, "[%s] Ignoriere 0x%02X im Sync-Fenster (%d/%u, %lldus)",
+                                         lnk->name, b, lnk->sync_search_count, (unsigned)lnk->cfg->sync_max_bytes, since_break);
                                 break;
                             }
-                            ESP_LOGW(TAG, "[%s] Nach BREAK kein SYNC, sondern 0x%02X -> IDLE (count=%d, %lldus)",
-                                     lnk->name, b, lnk->sync_search_count, since_break);
+                            if (log_filter_link_enabled(lnk->link, LOG_SEV_WARN)) {
+                                ESP_LOGW(TAG, "[%s] Nach BREAK kein SYNC, sondern 0x%02X -> IDLE (count=%d, %lldus)",
+                                         lnk->name, b, lnk->sync_search_count, since_break);
+                            }
                             lnk->st = ST_IDLE;
                         }
                         break;
 
                     case ST_GOT_SYNC:
                         lnk->last_id = b;
+                        lnk->id_timestamp = esp_timer_get_time();
                         // Prüfe ID-Parität; verwerfe Frame bei Fehler
                         if (!lin_check_id_parity(b)) {
-                            ESP_LOGW(TAG, "[%s] ID-Parität ungültig: 0x%02X -> Frame verworfen", lnk->name, b);
+                            if (log_filter_allows(lnk->link, b, LOG_SEV_WARN)) {
+                                ESP_LOGW(TAG, "[%s] ID-Parität ungültig: 0x%02X -> Frame verworfen", lnk->name, b);
+                            }
+                            lnk->frame_len = 0;
+                            capture_lin_frame(lnk);
                             lnk->st = ST_IDLE;
                             break;
                         }
-                        ESP_LOGI(TAG, "[%s] ID=0x%02X empfangen, sende Header", lnk->name, b);
+                        if (log_filter_allows(lnk->link, b, LOG_SEV_DEBUG)) {
+                            ESP_LOGI(TAG, "[%s] ID=0x%02X empfangen, sende Header", lnk->name, b);
+                        }
                         lin_send_header(lnk, b);
                         lnk->st = ST_GOT_ID;
                         break;
 
                     case ST_GOT_ID:
-                        uart_write_bytes(lnk->out_uart, (char*)&b, 1);
+                        lnk->data_timestamp = esp_timer_get_time();
+                        if (lnk->mode != LIN_MODE_SNIFFER) {
+                            uart_write_bytes(lnk->out_uart, (char*)&b, 1);
+                        }
                         if (lnk->frame_len < sizeof(lnk->frame_buf)) {
                             lnk->frame_buf[lnk->frame_len++] = b;
                         }
@@ -539,7 +726,9 @@ static void lin_proxy_task(void *arg)
                         break;
 
                     case ST_DATA:
-                        uart_write_bytes(lnk->out_uart, (char*)&b, 1);
+                        if (lnk->mode != LIN_MODE_SNIFFER) {
+                            uart_write_bytes(lnk->out_uart, (char*)&b, 1);
+                        }
                         if (lnk->frame_len < sizeof(lnk->frame_buf)) {
                             lnk->frame_buf[lnk->frame_len++] = b;
                         }
@@ -552,48 +741,27 @@ static void lin_proxy_task(void *arg)
 
 void app_main(void)
 {
-    // Netzwerk initialisieren (WiFi oder Ethernet)
+    // Phase 1: nur was der Proxy braucht (NVS für Filter/Parameter, UARTs, Tasks).
+    // Der Bus ist damit nach wenigen 10 ms wieder bedient, nicht erst nach dem Netzwerk.
     ESP_LOGI(TAG, "=== LIN Proxy v%s ===", ota_get_version());
-    ESP_LOGI(TAG, "Starte Netzwerk...");
-    network_init();
-    
-    vTaskDelay(pdMS_TO_TICKS(3000)); // Warte auf Netzwerk-Verbindung
-    
-    // OTA-System initialisieren
-    ota_init();
-    
-    // Web-Server starten
-    webserver_init();
+    ESP_ERROR_CHECK(nvs_flash_init());
+
+    // Laufzeit-Log-Filter und Proxy-Parameter aus NVS laden
+    log_filter_init();
+    proxy_config_init();
     
     QueueHandle_t q1 = NULL;
     QueueHandle_t q2 = NULL;
 
     uart_init_lin(LIN1_UART, LIN1_TX, LIN1_RX, &q1);
+    uart_apply_pins("LIN1", LIN1_UART, LIN1_TX, LIN1_RX, &lin1_pins_ready);
+    sysmon_register_uart("LIN1", LIN1_UART, q1);
     
-#if LIN_SNIFFER_MODE
-    // SNIFFER-MODUS: Nur LIN1 analysieren, kein LIN2, kein Proxy
-    ESP_LOGW(TAG, "*** SNIFFER-MODUS AKTIVIERT ***");
-    ESP_LOGW(TAG, "*** NUR LIN1 WIRD ANALYSIERT (KEIN PROXY!) ***");
-    
-    static lin_link_t sniffer = {
-        .in_uart = LIN1_UART,
-        .out_uart = UART_NUM_MAX,  // Kein Output
-        .out_tx_pin = GPIO_NUM_NC,
-        .st = ST_IDLE,
-        .name = "LIN1-SNIFFER",
-        .frame_len = 0,
-        .is_master = true,
-        .break_timestamp = 0,
-        .sync_timestamp = 0,
-        .id_timestamp = 0
-    };
-    sniffer.q = q1;
-    
-    xTaskCreate(lin_sniffer_task, "lin1_sniffer", 6144, &sniffer, 12, NULL);
-    ESP_LOGI(TAG, "LIN1 Sniffer gestartet (9600 baud)");
-#else
-    // PROXY-MODUS: Normale Bidirektionale Weiterleitung
+    // Beide Links laufen immer; die Betriebsart je Link (proxy/tap/sniffer/bypass)
+    // kommt aus proxy_config und ist zur Laufzeit umschaltbar
     uart_init_lin(LIN2_UART, LIN2_TX, LIN2_RX, &q2);
+    uart_apply_pins("LIN2", LIN2_UART, LIN2_TX, LIN2_RX, &lin2_pins_ready);
+    sysmon_register_uart("LIN2", LIN2_UART, q2);
 
     static lin_link_t l12 = {
         .in_uart = LIN1_UART,
@@ -601,8 +769,9 @@ void app_main(void)
         .out_tx_pin = LIN2_TX,
         .st = ST_IDLE,
         .name = "LIN1→LIN2",
+        .link = LOG_LINK_LIN1,
         .frame_len = 0,
-        .is_master = true,  // LIN1 ist Master, Header regenerieren
+        .is_master = true,  // Startwert, maßgeblich ist master_link (proxy_config)
         .break_timestamp = 0,
         .sync_timestamp = 0,
         .id_timestamp = 0
@@ -615,8 +784,9 @@ void app_main(void)
         .out_tx_pin = LIN1_TX,
         .st = ST_IDLE,
         .name = "LIN2→LIN1",
+        .link = LOG_LINK_LIN2,
         .frame_len = 0,
-        .is_master = false,  // LIN2 ist Slave, nur Daten durchreichen
+        .is_master = false,  // Startwert, maßgeblich ist master_link (proxy_config)
         .break_timestamp = 0,
         .sync_timestamp = 0,
         .id_timestamp = 0
@@ -626,11 +796,35 @@ void app_main(void)
     xTaskCreate(lin_proxy_task, "lin1_to_lin2", 4096, &l12, 12, NULL);
     xTaskCreate(lin_proxy_task, "lin2_to_lin1", 4096, &l21, 12, NULL);
 
+    // Detail-Analyse für TAP/SNIFFER, unterhalb der Proxy-Tasks
+    xTaskCreate(lin_tap_task, "lin_tap", 4096, NULL, 2, NULL);
+
     ESP_LOGI(TAG, "LIN proxy gestartet (9600 baud)");
+    g_boot.proxy_ready_us = esp_timer_get_time();
+    ESP_LOGI(TAG, "Proxy bereit nach %lld ms", g_boot.proxy_ready_us / 1000);
+
+    // Phase 2: Netzwerk, OTA, Webserver. app_main läuft mit Priorität 1, die
+    // Proxy-Tasks (12) leiten währenddessen schon weiter.
+    ESP_LOGI(TAG, "Starte Netzwerk...");
+    network_init();
+    g_boot.network_us = esp_timer_get_time();
+
+    // OTA-System initialisieren
+    ota_init();
+    
+    // Web-Server starten
+    webserver_init();
+    g_boot.web_us = esp_timer_get_time();
+
+#if TCP_SINK_MODE
+    // Binärer Capture-Stream per TCP
+    tcp_sink_init();
 #endif
 
-    // UART-Pins erst nach Boot stabilisieren/configurieren
-    xTaskCreate(uart_apply_pins_delayed, "uart_pins_late", 2048, NULL, 10, NULL);
+    // Tasks/CPU/Stack/Heap/Queues messen (/api/sysmon)
+    sysmon_init();
+
+    vTaskDelay(pdMS_TO_TICKS(3000)); // Warte auf Netzwerk-Verbindung (nur für die IP im Log)
     
     // Hole aktuelle IP-Adresse
     const char *ip = network_get_ip_string();
@@ -664,4 +858,17 @@ void app_main(void)
     ESP_LOGI(TAG, "Auto-Update aktiviert (Check alle %d Sekunden)", UPDATE_INTERVAL);
     ESP_LOGI(TAG, "OTA-Server: %s", FW_UPDATE_URL);
 #endif
-}
\ No newline at end of file
+
+    if (g_boot.first_frame_us) {
+        ESP_LOGI(TAG, "Boot: Proxy %lld ms, erstes Frame %lld ms, Netzwerk %lld ms, Web %lld ms",
+                 g_boot.proxy_ready_us / 1000, g_boot.first_frame_us / 1000,
+                 g_boot.network_us / 1000, g_boot.web_us / 1000);
+    }
+
+    // Periodisches Lebenszeichen
+    int alive_count = 0;
+    while (1) {
+        vTaskDelay(pdMS_TO_TICKS(5000));
+        ESP_LOGI(TAG, "System läuft... (%d)", ++alive_count);
+    }
+}
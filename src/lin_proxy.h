@@ -0,0 +1,47 @@
+#ifndef LIN_PROXY_H
+#define LIN_PROXY_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Proxy-Zustand für andere Module (z.B. OTA-Drosselung)
+
+// Max. Dauer eines LIN-Frames ab BREAK (9600 Baud, 8 Datenbytes, +40% Toleranz)
+#ifndef LIN_FRAME_MAX_US
+#define LIN_FRAME_MAX_US 18000
+#endif
+
+// Latenz-Histogramm: ID auf LIN1 empfangen -> Header auf LIN2 gesendet
+#define LIN_LAT_BUCKETS 16
+
+typedef struct {
+    uint32_t count[LIN_LAT_BUCKETS];    // Bucket i: Latenz <= lin_proxy_latency_edge(i)
+    uint32_t total;
+    uint32_t max_us;
+} lin_latency_hist_t;
+
+// true, solange ein Frame auf LIN1 läuft (BREAK gesehen, Frame noch nicht
+// abgeschlossen oder jünger als LIN_FRAME_MAX_US)
+bool lin_proxy_frame_in_flight(void);
+
+// Obere Grenze von Bucket i in µs (letzter Bucket: UINT32_MAX)
+uint32_t lin_proxy_latency_edge(int bucket);
+
+// Histogramm kopieren bzw. zurücksetzen
+void lin_proxy_latency_get(lin_latency_hist_t *out);
+void lin_proxy_latency_reset(void);
+
+// Boot-Phasen in µs seit Start der Firmware (esp_timer, ohne Bootloader), 0 = noch nicht erreicht
+typedef struct {
+    int64_t proxy_ready_us;     // UARTs konfiguriert, Proxy-Tasks laufen
+    int64_t first_frame_us;     // erster Header weitergeleitet
+    int64_t network_us;         // network_init abgeschlossen
+    int64_t web_us;             // Webserver gestartet
+} lin_proxy_boot_t;
+
+void lin_proxy_boot_get(lin_proxy_boot_t *out);
+
+// Perzentil (0-100) als obere Bucket-Grenze in µs, 0 wenn leer
+uint32_t lin_proxy_latency_percentile(const lin_latency_hist_t *h, int pct);
+
+#endif // LIN_PROXY_H
@@ -0,0 +1,371 @@
+#include "live.h"
+#include "capture.h"
+#include "log_filter.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "lwip/sockets.h"
+#include <string.h>
+#include <stdlib.h>
+
+static const char *TAG = "LIVE";
+
+#ifndef MIN
+#define MIN(a,b) ((a) < (b) ? (a) : (b))
+#endif
+
+#define LIVE_MAX_CLIENTS     4
+#define LIVE_POLL_MS         50      // Sende-Intervall
+#define LIVE_BATCH           32      // max. Datensätze pro WebSocket-Nachricht
+#define LIVE_STATUS_MS       1000    // Leere Nachricht mit Status, auch ohne Traffic
+#define LIVE_LAG_SLOW        (CAPTURE_RING_SIZE / 2)  // ab hier Downsampling verdoppeln
+#define LIVE_LAG_OK          (CAPTURE_RING_SIZE / 8)  // darunter Downsampling halbieren
+#define LIVE_MAX_DOWNSAMPLE  8
+#define LIVE_DROP_CYCLES     40      // so viele Zyklen in Folge überholt/blockiert -> trennen
+
+// Kopf jeder Binär-Nachricht, danach count x capture_rec_t
+typedef struct __attribute__((packed)) {
+    uint8_t  type;        // 1 = Frames
+    uint8_t  downsample;  // aktueller Faktor (1 = jedes Frame)
+    uint16_t count;       // Anzahl Datensätze
+    uint32_t depth;       // noch nicht gelesene Einträge im Ring (Queue-Tiefe)
+    uint32_t lost;        // vom Ring überholt (Summe)
+    uint32_t dropped;     // durch Filter-Rate/Downsampling verworfen (Summe)
+} live_hdr_t;
+
+_Static_assert(sizeof(live_hdr_t) == 16, "live_hdr_t muss 16 Byte groß sein");
+
+typedef struct {
+    int fd;                 // -1 = frei
+    uint32_t gen;           // Verbindungszähler, schützt vor wiederverwendeten fds
+    uint32_t next_seq;      // Leseposition im Capture-Ring
+    uint64_t pid_mask;      // Bit pro PID (ohne Parität)
+    uint16_t rate;          // max. Frames/s, 0 = unbegrenzt
+    uint8_t downsample;
+    uint8_t slow_cycles;    // aufeinanderfolgende Zyklen mit Überlauf/Blockade
+    uint32_t tokens_x1000;  // Token-Bucket in 1/1000 Frames
+    int64_t last_refill_us;
+    int64_t last_send_us;
+    uint32_t skip;          // Zähler für Downsampling
+    uint32_t depth;
+    uint32_t sent;
+    uint32_t lost;
+    uint32_t dropped;
+} live_client_t;
+
+static httpd_handle_t live_server = NULL;
+static live_client_t clients[LIVE_MAX_CLIENTS];
+static SemaphoreHandle_t clients_lock = NULL;
+static uint32_t clients_gen = 0;
+
+// Optionen "pids=0x18,0x3C&rate=50" (Query-String oder Text-Nachricht) übernehmen
+static esp_err_t client_apply_opts(live_client_t *c, const char *opts)
+{
+    char val[128];
+
+    if (httpd_query_key_value(opts, "pids", val, sizeof(val)) == ESP_OK) {
+        uint64_t mask = 0;
+        if (strcmp(val, "all") == 0 || val[0] == '\0') {
+            mask = UINT64_MAX;
+        } else if (!log_filter_parse_pids(val, &mask)) {
+            return ESP_ERR_INVALID_ARG;
+        }
+        c->pid_mask = mask;
+    }
+    if (httpd_query_key_value(opts, "rate", val, sizeof(val)) == ESP_OK) {
+        int rate = atoi(val);
+        c->rate = rate < 0 ? 0 : (rate > 1000 ? 1000 : rate);
+        c->tokens_x1000 = c->rate * 1000;
+    }
+    return ESP_OK;
+}
+
+static live_client_t *client_find(int fd)
+{
+    for (int i = 0; i < LIVE_MAX_CLIENTS; i++) {
+        if (clients[i].fd == fd) return &clients[i];
+    }
+    return NULL;
+}
+
+static esp_err_t client_add(int fd, const char *query)
+{
+    esp_err_t err = ESP_ERR_NO_MEM;
+
+    xSemaphoreTake(clients_lock, portMAX_DELAY);
+    live_client_t *c = client_find(fd);
+    if (!c) c = client_find(-1);
+    if (c) {
+        memset(c, 0, sizeof(*c));
+        c->fd = fd;
+        c->gen = ++clients_gen;
+        c->next_seq = capture_head() + 1;   // nur neue Frames
+        c->pid_mask = UINT64_MAX;
+        c->downsample = 1;
+        c->last_refill_us = esp_timer_get_time();
+        err = query ? client_apply_opts(c, query) : ESP_OK;
+        if (err != ESP_OK) {
+            c->fd = -1;
+        }
+    }
+    xSemaphoreGive(clients_lock);
+
+    if (err == ESP_OK) {
+        ESP_LOGI(TAG, "Client fd=%d verbunden", fd);
+    } else {
+        ESP_LOGW(TAG, "Client fd=%d abgelehnt: %s", fd, esp_err_to_name(err));
+    }
+    return err;
+}
+
+void live_session_closed(int sockfd)
+{
+    if (!clients_lock) return;
+
+    xSemaphoreTake(clients_lock, portMAX_DELAY);
+    live_client_t *c = client_find(sockfd);
+    if (c) {
+        ESP_LOGI(TAG, "Client fd=%d getrennt (gesendet=%lu, verloren=%lu, verworfen=%lu)",
+                 sockfd, (unsigned long)c->sent, (unsigned long)c->lost, (unsigned long)c->dropped);
+        c->fd = -1;
+    }
+    xSemaphoreGive(clients_lock);
+}
+
+// Handler: WebSocket /ws/live
+static esp_err_t ws_live_handler(httpd_req_t *req)
+{
+    int fd = httpd_req_to_sockfd(req);
+
+    if (req->method == HTTP_GET) {
+        // Handshake abgeschlossen -> Client registrieren
+        char query[160];
+        bool has_query = httpd_req_get_url_query_str(req, query, sizeof(query)) == ESP_OK;
+        return client_add(fd, has_query ? query : NULL) == ESP_OK ? ESP_OK : ESP_FAIL;
+    }
+
+    // Text-Nachricht vom Browser: Filter/Rate ändern
+    httpd_ws_frame_t frame = {0};
+    esp_err_t err = httpd_ws_recv_frame(req, &frame, 0);
+    if (err != ESP_OK) return err;
+
+    char buf[160];
+    if (frame.len >= sizeof(buf)) {
+        return ESP_FAIL;   // Protokollfehler, Verbindung schließen
+    }
+    frame.payload = (uint8_t *)buf;
+    err = httpd_ws_recv_frame(req, &frame, frame.len);
+    if (err != ESP_OK) return err;
+    buf[frame.len] = '\0';
+
+    if (frame.type != HTTPD_WS_TYPE_TEXT) {
+        return ESP_OK;
+    }
+
+    xSemaphoreTake(clients_lock, portMAX_DELAY);
+    live_client_t *c = client_find(fd);
+    err = c ? client_apply_opts(c, buf) : ESP_ERR_NOT_FOUND;
+    xSemaphoreGive(clients_lock);
+
+    if (err != ESP_OK) {
+        ESP_LOGW(TAG, "Ungültige Optionen von fd=%d: %s", fd, buf);
+    }
+    return ESP_OK;
+}
+
+// Handler: Client-Status als JSON
+static esp_err_t live_status_handler(httpd_req_t *req)
+{
+    char json[128 + LIVE_MAX_CLIENTS * 192];
+    int off = snprintf(json, sizeof(json), "{\"head\":%lu,\"ring\":%d,\"clients\":[",
+                       (unsigned long)capture_head(), CAPTURE_RING_SIZE);
+
+    xSemaphoreTake(clients_lock, portMAX_DELAY);
+    bool first = true;
+    for (int i = 0; i < LIVE_MAX_CLIENTS; i++) {
+        live_client_t *c = &clients[i];
+        if (c->fd < 0) continue;
+        off += snprintf(json + off, sizeof(json) - off,
+                        "%s{\"fd\":%d,\"depth\":%lu,\"sent\":%lu,\"lost\":%lu,\"dropped\":%lu,"
+                        "\"downsample\":%u,\"rate\":%u,\"pids\":\"%016llX\"}",
+                        first ? "" : ",", c->fd, (unsigned long)c->depth, (unsigned long)c->sent,
+                        (unsigned long)c->lost, (unsigned long)c->dropped,
+                        c->downsample, c->rate, c->pid_mask);
+        first = false;
+    }
+    xSemaphoreGive(clients_lock);
+    snprintf(json + off, sizeof(json) - off, "]}");
+
+    httpd_resp_set_type(req, "application/json");
+    httpd_resp_sendstr(req, json);
+    return ESP_OK;
+}
+
+// Socket ohne Blockieren beschreibbar? Langsame Clients dürfen den Sende-Task nicht aufhalten.
+static bool socket_writable(int fd)
+{
+    fd_set wfds;
+    FD_ZERO(&wfds);
+    FD_SET(fd, &wfds);
+    struct timeval tv = { 0, 0 };
+    return select(fd + 1, NULL, &wfds, NULL, &tv) > 0;
+}
+
+// Einen Client bedienen. Arbeitet auf einer Kopie, damit der HTTP-Task nie auf das Senden wartet.
+static bool client_service(live_client_t *c, uint8_t *buf, int64_t now)
+{
+    live_hdr_t *hdr = (live_hdr_t *)buf;
+    capture_rec_t *out = (capture_rec_t *)(buf + sizeof(live_hdr_t));
+    capture_rec_t recs[LIVE_BATCH];
+
+    uint32_t lag = capture_head() - c->next_seq + 1;
+    if ((int32_t)lag < 0) lag = 0;
+
+    if (!socket_writable(c->fd)) {
+        // TCP-Sendepuffer voll: nichts lesen, Ring läuft ggf. über
+        c->depth = lag;
+        return ++c->slow_cycles < LIVE_DROP_CYCLES;
+    }
+
+    // Downsampling an Rückstand anpassen
+    if (lag > LIVE_LAG_SLOW && c->downsample < LIVE_MAX_DOWNSAMPLE) {
+        c->downsample *= 2;
+    } else if (lag < LIVE_LAG_OK && c->downsample > 1) {
+        c->downsample /= 2;
+    }
+
+    // Token-Bucket auffüllen (Kapazität = 1 s)
+    if (c->rate) {
+        int64_t dt = now - c->last_refill_us;
+        uint32_t add = (uint32_t)((dt * c->rate) / 1000);
+        c->tokens_x1000 = MIN(c->tokens_x1000 + add, (uint32_t)c->rate * 1000);
+    }
+    c->last_refill_us = now;
+
+    uint32_t lost_before = c->lost;
+    size_t n = capture_read(&c->next_seq, recs, LIVE_BATCH, &c->lost);
+    uint16_t count = 0;
+
+    for (size_t i = 0; i < n; i++) {
+        if (!((c->pid_mask >> (recs[i].pid & 0x3F)) & 1)) {
+            continue;   // Filter: nicht abonniert, zählt nicht als verworfen
+        }
+        if (c->downsample > 1 && (c->skip++ % c->downsample) != 0) {
+            c->dropped++;
+            continue;
+        }
+        if (c->rate) {
+            if (c->tokens_x1000 < 1000) {
+                c->dropped++;
+                continue;
+            }
+            c->tokens_x1000 -= 1000;
+        }
+        out[count++] = recs[i];
+    }
+
+    c->slow_cycles = c->lost != lost_before ? c->slow_cycles + 1 : 0;
+    c->depth = capture_head() - c->next_seq + 1;
+
+    if (count == 0 && now - c->last_send_us < LIVE_STATUS_MS * 1000LL) {
+        return c->slow_cycles < LIVE_DROP_CYCLES;
+    }
+
+    hdr->type = 1;
+    hdr->downsample = c->downsample;
+    hdr->count = count;
+    hdr->depth = c->depth;
+    hdr->lost = c->lost;
+    hdr->dropped = c->dropped;
+
+    httpd_ws_frame_t frame = {
+        .final = true,
+        .type = HTTPD_WS_TYPE_BINARY,
+        .payload = buf,
+        .len = sizeof(live_hdr_t) + count * sizeof(capture_rec_t),
+    };
+    if (httpd_ws_send_frame_async(live_server, c->fd, &frame) != ESP_OK) {
+        return false;
+    }
+    c->sent += count;
+    c->last_send_us = now;
+    return c->slow_cycles < LIVE_DROP_CYCLES;
+}
+
+static void live_task(void *arg)
+{
+    static uint8_t buf[sizeof(live_hdr_t) + LIVE_BATCH * sizeof(capture_rec_t)];
+
+    while (1) {
+        vTaskDelay(pdMS_TO_TICKS(LIVE_POLL_MS));
+
+        for (int i = 0; i < LIVE_MAX_CLIENTS; i++) {
+            live_client_t copy;
+
+            xSemaphoreTake(clients_lock, portMAX_DELAY);
+            copy = clients[i];
+            xSemaphoreGive(clients_lock);
+            if (copy.fd < 0) continue;
+
+            if (httpd_ws_get_fd_info(live_server, copy.fd) != HTTPD_WS_CLIENT_WEBSOCKET) {
+                live_session_closed(copy.fd);
+                continue;
+            }
+
+            bool keep = client_service(&copy, buf, esp_timer_get_time());
+
+            // Zurückschreiben, sofern der Client inzwischen nicht getrennt/ersetzt wurde.
+            // Optionen (Filter/Rate) können sich parallel geändert haben und bleiben erhalten.
+            xSemaphoreTake(clients_lock, portMAX_DELAY);
+            live_client_t *c = &clients[i];
+            if (c->fd == copy.fd && c->gen == copy.gen) {
+                copy.pid_mask = c->pid_mask;
+                if (copy.rate != c->rate) {
+                    copy.rate = c->rate;
+                    copy.tokens_x1000 = c->tokens_x1000;
+                }
+                *c = copy;
+            }
+            xSemaphoreGive(clients_lock);
+
+            if (!keep) {
+                ESP_LOGW(TAG, "Client fd=%d zu langsam (Queue %lu, verloren %lu) -> trenne",
+                         copy.fd, (unsigned long)copy.depth, (unsigned long)copy.lost);
+                httpd_sess_trigger_close(live_server, copy.fd);
+            }
+        }
+    }
+}
+
+esp_err_t live_register(httpd_handle_t server)
+{
+    live_server = server;
+
+    if (!clients_lock) {
+        clients_lock = xSemaphoreCreateMutex();
+        for (int i = 0; i < LIVE_MAX_CLIENTS; i++) {
+            clients[i].fd = -1;
+        }
+        // Niedrige Priorität: Proxy-Tasks (12) und HTTP-Server haben Vorrang
+        xTaskCreate(live_task, "live_ws", 4096, NULL, 4, NULL);
+    }
+
+    httpd_uri_t ws = {
+        .uri = "/ws/live",
+        .method = HTTP_GET,
+        .handler = ws_live_handler,
+        .is_websocket = true,
+    };
+    httpd_register_uri_handler(server, &ws);
+
+    httpd_uri_t status = {
+        .uri = "/api/live",
+        .method = HTTP_GET,
+        .handler = live_status_handler,
+    };
+    httpd_register_uri_handler(server, &status);
+
+    return ESP_OK;
+}
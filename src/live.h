@@ -0,0 +1,18 @@
+#ifndef LIVE_H
+#define LIVE_H
+
+#include "esp_err.h"
+#include "esp_http_server.h"
+
+// Live-Ansicht: WebSocket-Stream der Frames aus dem Capture-Ring
+//   GET /live       HTML-Seite aus src/www/live.html (liefert webserver.c aus)
+//   GET /ws/live    WebSocket, optional ?pids=0x18,0x3C&rate=50
+//   GET /api/live   Status aller Clients (Queue-Tiefe, Verluste) als JSON
+
+// Endpunkte registrieren und Sende-Task starten
+esp_err_t live_register(httpd_handle_t server);
+
+// Vom Close-Callback des HTTP-Servers aufzurufen
+void live_session_closed(int sockfd);
+
+#endif // LIVE_H
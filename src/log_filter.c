@@ -0,0 +1,147 @@
+#include "log_filter.h"
+#include "esp_log.h"
+#include "nvs.h"
+#include "freertos/FreeRTOS.h"
+#include <string.h>
+#include <stdlib.h>
+
+static const char *TAG = "LOG_FILTER";
+
+#define NVS_NAMESPACE "log_filter"
+#define NVS_KEY_MASK  "mask"
+
+volatile uint32_t g_log_filter[LOG_LINK_COUNT][LOG_SEV_COUNT][2];
+
+// Schreiber (HTTP-Task) serialisieren; Leser im Proxy-Task lesen ohne Lock.
+// Ein halb aktualisiertes 64-Bit-Wort betrifft höchstens eine einzelne Log-Entscheidung.
+static portMUX_TYPE filter_lock = portMUX_INITIALIZER_UNLOCKED;
+
+static const char *link_names[LOG_LINK_COUNT] = { "LIN1", "LIN2" };
+static const char *sev_names[LOG_SEV_COUNT] = { "error", "warn", "info", "debug" };
+
+static void apply_defaults(void)
+{
+    // Default entspricht dem bisherigen Verhalten: alles loggen
+    taskENTER_CRITICAL(&filter_lock);
+    for (int l = 0; l < LOG_LINK_COUNT; l++) {
+        for (int s = 0; s < LOG_SEV_COUNT; s++) {
+            g_log_filter[l][s][0] = 0xFFFFFFFF;
+            g_log_filter[l][s][1] = 0xFFFFFFFF;
+        }
+    }
+    taskEXIT_CRITICAL(&filter_lock);
+}
+
+esp_err_t log_filter_save(void)
+{
+    uint32_t snapshot[LOG_LINK_COUNT][LOG_SEV_COUNT][2];
+
+    taskENTER_CRITICAL(&filter_lock);
+    memcpy(snapshot, (const void *)g_log_filter, sizeof(snapshot));
+    taskEXIT_CRITICAL(&filter_lock);
+
+    nvs_handle_t nvs;
+    esp_err_t err = nvs_open(NVS_NAMESPACE, NVS_READWRITE, &nvs);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "NVS öffnen fehlgeschlagen: %s", esp_err_to_name(err));
+        return err;
+    }
+    err = nvs_set_blob(nvs, NVS_KEY_MASK, snapshot, sizeof(snapshot));
+    if (err == ESP_OK) {
+        err = nvs_commit(nvs);
+    }
+    nvs_close(nvs);
+
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Filter speichern fehlgeschlagen: %s", esp_err_to_name(err));
+    }
+    return err;
+}
+
+esp_err_t log_filter_init(void)
+{
+    apply_defaults();
+
+    nvs_handle_t nvs;
+    esp_err_t err = nvs_open(NVS_NAMESPACE, NVS_READONLY, &nvs);
+    if (err != ESP_OK) {
+        // Noch nie gespeichert -> Defaults
+        ESP_LOGI(TAG, "Kein gespeicherter Filter, nutze Default (alles aktiv)");
+        return ESP_OK;
+    }
+
+    uint32_t stored[LOG_LINK_COUNT][LOG_SEV_COUNT][2];
+    size_t len = sizeof(stored);
+    err = nvs_get_blob(nvs, NVS_KEY_MASK, stored, &len);
+    nvs_close(nvs);
+
+    if (err == ESP_OK && len == sizeof(stored)) {
+        taskENTER_CRITICAL(&filter_lock);
+        memcpy((void *)g_log_filter, stored, sizeof(stored));
+        taskEXIT_CRITICAL(&filter_lock);
+        ESP_LOGI(TAG, "Log-Filter aus NVS geladen");
+    } else {
+        ESP_LOGW(TAG, "Gespeicherter Filter ungültig (%s, %u Bytes) -> Default",
+                 esp_err_to_name(err), (unsigned)len);
+    }
+    return ESP_OK;
+}
+
+esp_err_t log_filter_set(log_link_t link, log_sev_t sev, uint64_t pid_mask)
+{
+    if (link >= LOG_LINK_COUNT || sev >= LOG_SEV_COUNT) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    taskENTER_CRITICAL(&filter_lock);
+    g_log_filter[link][sev][0] = (uint32_t)(pid_mask & 0xFFFFFFFF);
+    g_log_filter[link][sev][1] = (uint32_t)(pid_mask >> 32);
+    taskEXIT_CRITICAL(&filter_lock);
+
+    ESP_LOGI(TAG, "%s/%s -> %016llX", link_names[link], sev_names[sev], pid_mask);
+    return ESP_OK;
+}
+
+uint64_t log_filter_get(log_link_t link, log_sev_t sev)
+{
+    if (link >= LOG_LINK_COUNT || sev >= LOG_SEV_COUNT) {
+        return 0;
+    }
+
+    taskENTER_CRITICAL(&filter_lock);
+    uint64_t mask = ((uint64_t)g_log_filter[link][sev][1] << 32) | g_log_filter[link][sev][0];
+    taskEXIT_CRITICAL(&filter_lock);
+    return mask;
+}
+
+esp_err_t log_filter_reset(void)
+{
+    apply_defaults();
+    ESP_LOGI(TAG, "Log-Filter auf Default zurückgesetzt");
+    return log_filter_save();
+}
+
+const char* log_filter_link_name(log_link_t link)
+{
+    return link < LOG_LINK_COUNT ? link_names[link] : "?";
+}
+
+const char* log_filter_sev_name(log_sev_t sev)
+{
+    return sev < LOG_SEV_COUNT ? sev_names[sev] : "?";
+}
+
+bool log_filter_parse_pids(char *list, uint64_t *mask)
+{
+    *mask = 0;
+    char *save = NULL;
+    for (char *tok = strtok_r(list, ",", &save); tok; tok = strtok_r(NULL, ",", &save)) {
+        char *end = NULL;
+        unsigned long pid = strtoul(tok, &end, 0);
+        if (end == tok || *end != '\0' || pid > 0x3F) {
+            return false;
+        }
+        *mask |= 1ULL << pid;
+    }
+    return true;
+}
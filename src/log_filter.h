@@ -0,0 +1,63 @@
+#ifndef LOG_FILTER_H
+#define LOG_FILTER_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "esp_err.h"
+
+// Link-Index für die Filter-Bitmap
+typedef enum {
+    LOG_LINK_LIN1 = 0,
+    LOG_LINK_LIN2,
+    LOG_LINK_COUNT
+} log_link_t;
+
+// Schweregrade des Laufzeit-Filters
+typedef enum {
+    LOG_SEV_ERROR = 0,
+    LOG_SEV_WARN,
+    LOG_SEV_INFO,
+    LOG_SEV_DEBUG,
+    LOG_SEV_COUNT
+} log_sev_t;
+
+// Filter-Bitmap: je Link und Schweregrad ein Bit pro PID (0..63), als 2x32 Bit
+// abgelegt, damit Lesen im Proxy-Task ohne Lock auskommt
+extern volatile uint32_t g_log_filter[LOG_LINK_COUNT][LOG_SEV_COUNT][2];
+
+// O(1)-Prüfung für den Hot-Path: soll für diese PID geloggt werden?
+static inline bool log_filter_allows(log_link_t link, uint8_t pid, log_sev_t sev)
+{
+    pid &= 0x3F;
+    return (g_log_filter[link][sev][pid >> 5] >> (pid & 31)) & 1;
+}
+
+// Für Meldungen ohne bekannte PID (BREAK, SYNC): mindestens eine PID aktiv?
+static inline bool log_filter_link_enabled(log_link_t link, log_sev_t sev)
+{
+    return (g_log_filter[link][sev][0] | g_log_filter[link][sev][1]) != 0;
+}
+
+// Filter aus NVS laden (Default: alles aktiv)
+esp_err_t log_filter_init(void);
+
+// PID-Maske für Link/Schweregrad setzen (sofort aktiv, ohne Reboot)
+esp_err_t log_filter_set(log_link_t link, log_sev_t sev, uint64_t pid_mask);
+
+// Aktuellen Filter in NVS speichern
+esp_err_t log_filter_save(void);
+
+// Aktuelle PID-Maske lesen
+uint64_t log_filter_get(log_link_t link, log_sev_t sev);
+
+// Auf Default zurücksetzen und speichern
+esp_err_t log_filter_reset(void);
+
+// Namen für API/JSON ("LIN1", "info", ...)
+const char* log_filter_link_name(log_link_t link);
+const char* log_filter_sev_name(log_sev_t sev);
+
+// PID-Liste "0x18,0x3C,32" in Bitmaske wandeln (list wird zerlegt)
+bool log_filter_parse_pids(char *list, uint64_t *mask);
+
+#endif // LOG_FILTER_H
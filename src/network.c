@@ -6,10 +6,13 @@
 #include "esp_netif.h"
 #include "esp_event.h"
 #include "esp_log.h"
-#include "nvs_flash.h"
+#include "esp_netif_sntp.h"
+#include "esp_timer.h"
 #include "lwip/sockets.h"
 #include <string.h>
 #include <errno.h>
+#include <sys/time.h>
+#include <time.h>
 
 static const char *TAG = "NETWORK";
 static int udp_sock = -1;
@@ -20,6 +23,17 @@ static bool ap_mode_active = false;
 static int wifi_retry_count = 0;
 #define WIFI_MAX_RETRY 5  // Max. Versuche für Station-Verbindung
 
+// RFC-5424-Syslog
+#define SYSLOG_APP_NAME     "lin_proxy"
+// Private Enterprise Number 32473 ist laut RFC 5612 für Dokumentation reserviert;
+// bei Bedarf durch eigene PEN ersetzen
+#define SYSLOG_SD_ID        "lin@32473"
+#define SYSLOG_SEQ_MAX      2147483647   // meta/sequenceId läuft laut RFC 5424 danach auf 1
+#define SYSLOG_MSG_MAX      768
+#define SNTP_VALID_EPOCH    1577836800   // 2020-01-01: alles davor gilt als "nicht synchronisiert"
+static uint32_t syslog_seq = 0;
+static char syslog_hostname[32] = "-";
+
 #if USE_ETHERNET
 #include "driver/gpio.h"
 
@@ -199,9 +213,20 @@ static esp_err_t init_wifi(void)
 
 esp_err_t network_init(void)
 {
-    ESP_ERROR_CHECK(nvs_flash_init());
+    // NVS initialisiert app_main bereits vor dem Proxy-Start
     ESP_ERROR_CHECK(esp_netif_init());
     ESP_ERROR_CHECK(esp_event_loop_create_default());
+
+    // Hostname für Syslog aus MAC ableiten (eindeutig pro Gerät)
+    uint8_t mac[6];
+    if (esp_read_mac(mac, ESP_MAC_BASE) == ESP_OK) {
+        snprintf(syslog_hostname, sizeof(syslog_hostname), "lin-proxy-%02x%02x%02x",
+                 mac[3], mac[4], mac[5]);
+    }
+
+    // SNTP für Wall-Clock-Zeitstempel im Syslog; synchronisiert sobald IP vorhanden
+    esp_sntp_config_t sntp_cfg = ESP_NETIF_SNTP_DEFAULT_CONFIG(SNTP_SERVER);
+    esp_netif_sntp_init(&sntp_cfg);
     
 #if USE_ETHERNET
     return init_ethernet();
@@ -247,7 +272,69 @@ char* network_get_ip_string(void)
     return ip_str;
 }
 
+// log_sev_t -> RFC-5424-Severity
+static int syslog_severity(log_sev_t sev)
+{
+    switch (sev) {
+        case LOG_SEV_ERROR: return 3;
+        case LOG_SEV_WARN:  return 4;
+        case LOG_SEV_INFO:  return 6;
+        default:            return 7;
+    }
+}
+
+// RFC-5424-Nachricht aufbauen:
+// <PRI>1 TIMESTAMP HOSTNAME APP-NAME PROCID MSGID [meta][timeQuality][lin@..] BOM MSG
+static int syslog_format(char *buf, size_t len, log_sev_t sev,
+                         const network_log_sd_t *sd, const char *msg)
+{
+    uint32_t seq = __atomic_add_fetch(&syslog_seq, 1, __ATOMIC_RELAXED);
+    seq = (seq - 1) % SYSLOG_SEQ_MAX + 1;
+    int64_t mono_us = esp_timer_get_time();
+
+    // Wall-Clock nur verwenden, wenn SNTP bereits synchronisiert hat
+    char ts[40] = "-";
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    bool synced = tv.tv_sec >= SNTP_VALID_EPOCH;
+    if (synced) {
+        struct tm tm;
+        gmtime_r(&tv.tv_sec, &tm);
+        snprintf(ts, sizeof(ts), "%04d-%02d-%02dT%02d:%02d:%02d.%06ldZ",
+                 tm.tm_year + 1900, tm.tm_mon + 1, tm.tm_mday,
+                 tm.tm_hour, tm.tm_min, tm.tm_sec, (long)tv.tv_usec);
+    }
+
+    int off = snprintf(buf, len, "<%d>1 %s %s " SYSLOG_APP_NAME " - %s "
+                       "[meta sequenceId=\"%lu\"][timeQuality tzKnown=\"1\" isSynced=\"%d\"]"
+                       "[" SYSLOG_SD_ID " mono_us=\"%lld\"",
+                       SYSLOG_FACILITY * 8 + syslog_severity(sev), ts, syslog_hostname,
+                       (sd && sd->msgid) ? sd->msgid : "-",
+                       (unsigned long)seq, synced ? 1 : 0, mono_us);
+
+    if (sd && sd->link >= 0 && off < (int)len) {
+        off += snprintf(buf + off, len - off, " link=\"%s\"", log_filter_link_name(sd->link));
+    }
+    if (sd && sd->pid >= 0 && off < (int)len) {
+        off += snprintf(buf + off, len - off, " pid=\"0x%02X\"", sd->pid);
+    }
+    if (sd && sd->latency_us >= 0 && off < (int)len) {
+        off += snprintf(buf + off, len - off, " lat_us=\"%lld\"", sd->latency_us);
+    }
+    if (off < (int)len) {
+        // BOM kennzeichnet MSG als UTF-8 (RFC 5424, MSG-UTF8)
+        off += snprintf(buf + off, len - off, "] \xEF\xBB\xBF%s", msg);
+    }
+
+    return off < (int)len ? off : (int)len - 1;
+}
+
 void network_log(const char *msg)
+{
+    network_log_sd(LOG_SEV_INFO, NULL, msg);
+}
+
+void network_log_sd(log_sev_t sev, const network_log_sd_t *sd, const char *msg)
 {
 #if LOG_TO_UDP
     // Prüfe ob Netzwerk verbunden
@@ -280,7 +367,9 @@ void network_log(const char *msg)
     }
     
     // Sende Syslog-Nachricht
-    int sent = sendto(udp_sock, msg, strlen(msg), 0, 
+    char packet[SYSLOG_MSG_MAX];
+    int packet_len = syslog_format(packet, sizeof(packet), sev, sd, msg);
+    int sent = sendto(udp_sock, packet, packet_len, 0, 
                       (struct sockaddr *)&syslog_addr, sizeof(syslog_addr));
     
     if (sent < 0) {
@@ -1,14 +1,27 @@
 #ifndef NETWORK_H
 #define NETWORK_H
 
+#include <stdint.h>
 #include "esp_err.h"
+#include "log_filter.h"
 
-// Netzwerk initialisieren (WiFi oder Ethernet)
+// Strukturierte Felder für RFC-5424-Syslog (SD-Element "lin")
+typedef struct {
+    const char *msgid;      // RFC-5424 MSGID (z.B. "FRAME"), NULL = "-"
+    int link;               // log_link_t, -1 = nicht gesetzt
+    int pid;                // LIN-ID, -1 = nicht gesetzt
+    int64_t latency_us;     // Antwort-Latenz in µs, -1 = nicht gesetzt
+} network_log_sd_t;
+
+// Netzwerk initialisieren (WiFi oder Ethernet), setzt nvs_flash_init voraus
 esp_err_t network_init(void);
 
-// UDP-Log-Nachricht senden (für Syslog)
+// UDP-Log-Nachricht senden (RFC-5424-Syslog, Schweregrad "info")
 void network_log(const char *msg);
 
+// UDP-Log-Nachricht mit Schweregrad und LIN-Feldern senden (sd darf NULL sein)
+void network_log_sd(log_sev_t sev, const network_log_sd_t *sd, const char *msg);
+
 // Aktuelle IP-Adresse als String (statischer Buffer)
 char* network_get_ip_string(void);
 
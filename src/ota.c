@@ -1,21 +1,396 @@
 #include "ota.h"
+#include "ota_gz.h"
 #include "config.h"
+#include "lin_proxy.h"
 #include "esp_log.h"
 #include "esp_ota_ops.h"
 #include "esp_http_client.h"
-#include "esp_https_ota.h"
 #include "esp_crt_bundle.h"
+#include "esp_heap_caps.h"
+#include "esp_timer.h"
+#include "mbedtls/sha256.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
+#include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 
 static const char *TAG = "OTA";
 
+struct ota_stream {
+    esp_ota_handle_t handle;
+    const esp_partition_t *partition;
+    mbedtls_sha256_context sha;
+    uint8_t *buf;
+    ota_gz_t *gz;               // gesetzt, wenn das Image gzip-komprimiert ankommt
+    uint32_t received;          // Eingangs-Bytes (komprimiert oder roh)
+    bool have_expected;
+    uint8_t expected[32];
+    int64_t start_us;
+    int next_progress;          // nächste Log-Schwelle in Prozent
+};
+
+static ota_status_t ota_status;
+static int64_t ota_start_us;
+static portMUX_TYPE ota_status_lock = portMUX_INITIALIZER_UNLOCKED;
+
 const char* ota_get_version(void)
 {
     return FW_VERSION;
 }
 
+void ota_get_status(ota_status_t *out)
+{
+    taskENTER_CRITICAL(&ota_status_lock);
+    *out = ota_status;
+    if (ota_status.state == OTA_STATE_RUNNING) {
+        out->elapsed_ms = (uint32_t)((esp_timer_get_time() - ota_start_us) / 1000);
+    }
+    taskEXIT_CRITICAL(&ota_status_lock);
+}
+
+static void status_fail(const char *reason)
+{
+    char error[sizeof(ota_status.error)];
+    snprintf(error, sizeof(error), "%s", reason);
+
+    taskENTER_CRITICAL(&ota_status_lock);
+    ota_status.state = OTA_STATE_FAILED;
+    memcpy(ota_status.error, error, sizeof(error));
+    taskEXIT_CRITICAL(&ota_status_lock);
+}
+
+static bool parse_sha256_hex(const char *hex, uint8_t out[32])
+{
+    if (strlen(hex) != 64) {
+        return false;
+    }
+    for (int i = 0; i < 32; i++) {
+        unsigned int v;
+        if (sscanf(hex + 2 * i, "%2x", &v) != 1) {
+            return false;
+        }
+        out[i] = (uint8_t)v;
+    }
+    return true;
+}
+
+static void stream_free(ota_stream_t *s)
+{
+    if (s->gz) {
+        ota_gz_free(s->gz);
+    }
+    mbedtls_sha256_free(&s->sha);
+    heap_caps_free(s->buf);
+    free(s);
+}
+
+esp_err_t ota_stream_begin(size_t total, const char *sha256_hex, ota_stream_t **out)
+{
+    // Status atomar belegen: nur ein Update gleichzeitig
+    taskENTER_CRITICAL(&ota_status_lock);
+    bool busy = ota_status.state == OTA_STATE_RUNNING;
+    if (!busy) {
+        memset(&ota_status, 0, sizeof(ota_status));
+        ota_status.state = OTA_STATE_RUNNING;
+        ota_status.total = total;
+        ota_start_us = esp_timer_get_time();
+    }
+    taskEXIT_CRITICAL(&ota_status_lock);
+    if (busy) {
+        ESP_LOGW(TAG, "OTA läuft bereits");
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    ota_stream_t *s = calloc(1, sizeof(ota_stream_t));
+    if (!s) {
+        status_fail("Kein Speicher");
+        return ESP_ERR_NO_MEM;
+    }
+
+    if (sha256_hex && sha256_hex[0]) {
+        if (!parse_sha256_hex(sha256_hex, s->expected)) {
+            free(s);
+            status_fail("Ungültiger SHA-256");
+            return ESP_ERR_INVALID_ARG;
+        }
+        s->have_expected = true;
+    }
+
+#if OTA_BUF_PSRAM
+    s->buf = heap_caps_malloc(OTA_BUF_SIZE, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+#endif
+    if (!s->buf) {
+        s->buf = heap_caps_malloc(OTA_BUF_SIZE, MALLOC_CAP_DEFAULT);
+    }
+    if (!s->buf) {
+        free(s);
+        status_fail("Kein Speicher für Puffer");
+        return ESP_ERR_NO_MEM;
+    }
+
+    esp_err_t err = ESP_ERR_NOT_FOUND;
+    s->partition = esp_ota_get_next_update_partition(NULL);
+    if (s->partition) {
+        // Sektorweise löschen während des Schreibens statt die Partition vorab
+        // am Stück zu löschen (blockiert sonst den Flash-Cache für Sekunden)
+        err = esp_ota_begin(s->partition, OTA_WITH_SEQUENTIAL_WRITES, &s->handle);
+    }
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "esp_ota_begin fehlgeschlagen: %s", esp_err_to_name(err));
+        heap_caps_free(s->buf);
+        free(s);
+        status_fail(esp_err_to_name(err));
+        return err;
+    }
+
+    mbedtls_sha256_init(&s->sha);
+    mbedtls_sha256_starts(&s->sha, 0);
+    s->start_us = ota_start_us;
+    lin_proxy_latency_reset();
+    s->next_progress = OTA_PROGRESS_STEP;
+
+    ESP_LOGI(TAG, "Streaming-OTA nach %s (%u Byte, Puffer %d Byte, SHA-256 %s)",
+             s->partition->label, (unsigned)total, OTA_BUF_SIZE,
+             s->have_expected ? "wird geprüft" : "nicht vorgegeben");
+    *out = s;
+    return ESP_OK;
+}
+
+uint8_t* ota_stream_buf(ota_stream_t *s, size_t *cap)
+{
+    *cap = OTA_BUF_SIZE;
+    return s->buf;
+}
+
+// Image-Daten (bereits dekomprimiert) hashen und in den Flash schreiben
+static esp_err_t stream_write(void *ctx, const uint8_t *data, size_t len)
+{
+    ota_stream_t *s = (ota_stream_t *)ctx;
+    mbedtls_sha256_update(&s->sha, data, len);
+
+    int64_t t0 = esp_timer_get_time();
+    esp_err_t err = esp_ota_write(s->handle, data, len);
+    uint32_t write_us = (uint32_t)(esp_timer_get_time() - t0);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "esp_ota_write fehlgeschlagen: %s", esp_err_to_name(err));
+        return err;
+    }
+
+    taskENTER_CRITICAL(&ota_status_lock);
+    ota_status.written += len;
+    if (write_us > ota_status.max_write_us) {
+        ota_status.max_write_us = write_us;
+    }
+    taskEXIT_CRITICAL(&ota_status_lock);
+    return ESP_OK;
+}
+
+esp_err_t ota_stream_commit(ota_stream_t *s, size_t len)
+{
+    // gzip am Magic erkennen (ein App-Image beginnt mit 0xE9)
+    if (s->received == 0 && ota_gz_is_gzip(s->buf, len)) {
+        s->gz = ota_gz_new();
+        if (!s->gz) {
+            return ESP_ERR_NO_MEM;
+        }
+        ESP_LOGI(TAG, "Image ist gzip-komprimiert, dekomprimiere mit %u-Byte-Fenster", 1u << OTA_GZ_WINDOW_BITS);
+        taskENTER_CRITICAL(&ota_status_lock);
+        ota_status.compressed = true;
+        taskEXIT_CRITICAL(&ota_status_lock);
+    }
+    s->received += len;
+
+    esp_err_t err = s->gz ? ota_gz_feed(s->gz, s->buf, len, stream_write, s)
+                          : stream_write(s, s->buf, len);
+    if (err != ESP_OK) {
+        return err;
+    }
+
+    taskENTER_CRITICAL(&ota_status_lock);
+    ota_status.received = s->received;
+    uint32_t total = ota_status.total;
+    taskEXIT_CRITICAL(&ota_status_lock);
+
+    // Fortschritt nur an Schwellen loggen, nicht pro Block
+    if (total && (int)((uint64_t)s->received * 100 / total) >= s->next_progress) {
+        int pct = (int)((uint64_t)s->received * 100 / total);
+        ESP_LOGI(TAG, "OTA Fortschritt: %d%%", pct);
+        s->next_progress = (pct / OTA_PROGRESS_STEP + 1) * OTA_PROGRESS_STEP;
+    }
+    return ESP_OK;
+}
+
+esp_err_t ota_stream_finish(ota_stream_t *s)
+{
+    if (s->gz) {
+        esp_err_t err = ota_gz_finish(s->gz);
+        if (err != ESP_OK) {
+            esp_ota_abort(s->handle);
+            stream_free(s);
+            status_fail("gzip stream invalid");
+            return err;
+        }
+        ESP_LOGI(TAG, "gzip: %u -> %u Byte (%u%%)", (unsigned)s->received,
+                 (unsigned)ota_gz_output_size(s->gz),
+                 (unsigned)((uint64_t)s->received * 100 / (ota_gz_output_size(s->gz) ? ota_gz_output_size(s->gz) : 1)));
+    }
+
+    uint8_t digest[32];
+    char hex[65];
+    mbedtls_sha256_finish(&s->sha, digest);
+    for (int i = 0; i < 32; i++) {
+        snprintf(hex + 2 * i, 3, "%02x", digest[i]);
+    }
+
+    int64_t elapsed_us = esp_timer_get_time() - s->start_us;
+    lin_latency_hist_t lat;
+    lin_proxy_latency_get(&lat);
+    uint32_t p99 = lin_proxy_latency_percentile(&lat, 99);
+
+    taskENTER_CRITICAL(&ota_status_lock);
+    ota_status.elapsed_ms = (uint32_t)(elapsed_us / 1000);
+    memcpy(ota_status.sha256, hex, sizeof(hex));
+    ota_status.sha_checked = s->have_expected;
+    ota_status.lin_p99_us = p99;
+    ota_status.lin_max_us = lat.max_us;
+    uint32_t written = ota_status.written, max_write_us = ota_status.max_write_us;
+    taskEXIT_CRITICAL(&ota_status_lock);
+
+    ESP_LOGI(TAG, "OTA empfangen: %u Byte in %lld ms (%lld KB/s), längster Flash-Write %u µs",
+             (unsigned)written, elapsed_us / 1000,
+             elapsed_us > 0 ? (long long)written * 1000000 / 1024 / elapsed_us : 0LL,
+             (unsigned)max_write_us);
+    if (lat.total) {
+        ESP_LOGI(TAG, "LIN-Latenz während OTA: %u Frames, p99 %u µs, max %u µs (Budget %d µs) %s",
+                 (unsigned)lat.total, (unsigned)p99, (unsigned)lat.max_us, LIN_LATENCY_BUDGET_US,
+                 p99 <= LIN_LATENCY_BUDGET_US ? "OK" : "ÜBERSCHRITTEN");
+    }
+    ESP_LOGI(TAG, "SHA-256: %s", hex);
+
+    if (s->have_expected && memcmp(digest, s->expected, sizeof(digest)) != 0) {
+        ESP_LOGE(TAG, "SHA-256 stimmt nicht mit dem vorgegebenen Digest überein");
+        esp_ota_abort(s->handle);
+        stream_free(s);
+        status_fail("SHA-256 mismatch");
+        return ESP_ERR_INVALID_CRC;
+    }
+
+    esp_err_t err = esp_ota_end(s->handle);
+    if (err == ESP_OK) {
+        err = esp_ota_set_boot_partition(s->partition);
+    }
+    stream_free(s);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "OTA-Abschluss fehlgeschlagen: %s", esp_err_to_name(err));
+        status_fail(esp_err_to_name(err));
+        return err;
+    }
+
+    taskENTER_CRITICAL(&ota_status_lock);
+    ota_status.state = OTA_STATE_DONE;
+    taskEXIT_CRITICAL(&ota_status_lock);
+    return ESP_OK;
+}
+
+void ota_stream_abort(ota_stream_t *s, const char *reason)
+{
+    ESP_LOGE(TAG, "OTA abgebrochen: %s", reason);
+    esp_ota_abort(s->handle);
+    stream_free(s);
+    status_fail(reason);
+}
+
+// Vor jedem Schritt: LIN-Frame abwarten (max. 50 ms, danach trotzdem weiter,
+// damit ein dauerhaft belegter Bus das Update nicht verhindert)
+static uint32_t wait_for_lin_gap(void)
+{
+    int64_t t0 = esp_timer_get_time();
+    while (lin_proxy_frame_in_flight() && esp_timer_get_time() - t0 < 50000) {
+        vTaskDelay(1);
+    }
+    return (uint32_t)(esp_timer_get_time() - t0);
+}
+
+// Nach einem Schritt: Pause für Bandbreiten- und CPU-Budget
+static uint32_t throttle_slice(size_t bytes, int64_t work_us)
+{
+    int64_t pause_us = 0;
+#if OTA_BW_LIMIT_KBPS > 0
+    int64_t min_us = (int64_t)bytes * 1000000 / (OTA_BW_LIMIT_KBPS * 1024);
+    if (min_us > work_us) pause_us = min_us - work_us;
+#endif
+#if OTA_CPU_BUDGET_PCT > 0 && OTA_CPU_BUDGET_PCT < 100
+    int64_t cpu_us = work_us * (100 - OTA_CPU_BUDGET_PCT) / OTA_CPU_BUDGET_PCT;
+    if (cpu_us > pause_us) pause_us = cpu_us;
+#endif
+    if (pause_us > 0) {
+        vTaskDelay(pdMS_TO_TICKS(pause_us / 1000) + 1);
+    }
+    return (uint32_t)pause_us;
+}
+
+// Eine Verbindung lang in Schritten lesen und schreiben. *offset zählt die
+// bereits geschriebenen Bytes (Startpunkt für Range beim nächsten Versuch).
+static esp_err_t download_slices(esp_http_client_handle_t client, ota_stream_t *ota,
+                                 size_t *offset, uint64_t *paused_us)
+{
+    size_t cap;
+    uint8_t *buf = ota_stream_buf(ota, &cap);
+    size_t slice = cap < OTA_SLICE_SIZE ? cap : OTA_SLICE_SIZE;
+
+    while (1) {
+        *paused_us += wait_for_lin_gap();
+        int64_t t0 = esp_timer_get_time();
+
+        // Einen Schritt vollständig lesen, dann am Stück schreiben
+        size_t fill = 0;
+        bool eof = false;
+        while (fill < slice) {
+            int n = esp_http_client_read(client, (char *)buf + fill, slice - fill);
+            if (n < 0) {
+                break;
+            }
+            if (n == 0) {
+                eof = esp_http_client_is_complete_data_received(client);
+                break;
+            }
+            fill += n;
+        }
+        // Auch bei Abbruch den vollständig gelesenen Teil schreiben: so setzt der
+        // nächste Versuch genau dahinter an
+        if (fill > 0) {
+            esp_err_t err = ota_stream_commit(ota, fill);
+            if (err != ESP_OK) {
+                return err;
+            }
+            *offset += fill;
+        }
+        if (fill < slice) {
+            return eof ? ESP_OK : ESP_ERR_TIMEOUT;
+        }
+
+        *paused_us += throttle_slice(fill, esp_timer_get_time() - t0);
+        taskENTER_CRITICAL(&ota_status_lock);
+        ota_status.paused_ms = (uint32_t)(*paused_us / 1000);
+        taskEXIT_CRITICAL(&ota_status_lock);
+    }
+}
+
+// Start-Offset aus "Content-Range: bytes <start>-<end>/<total>", -1 wenn nicht lesbar
+static int64_t content_range_start(esp_http_client_handle_t client)
+{
+    char *value = NULL;
+    if (esp_http_client_get_header(client, "Content-Range", &value) != ESP_OK || !value) {
+        return -1;
+    }
+    unsigned long long start;
+    if (sscanf(value, "bytes %llu-", &start) != 1) {
+        return -1;
+    }
+    return (int64_t)start;
+}
+
 esp_err_t ota_update_from_url(const char *url)
 {
     ESP_LOGI(TAG, "Starte OTA-Update von: %s", url);
@@ -27,32 +402,358 @@ esp_err_t ota_update_from_url(const char *url)
         .crt_bundle_attach = esp_crt_bundle_attach,
     };
 
-    esp_https_ota_config_t ota_cfg = {
-        .http_config = &http_cfg,
-    };
+    esp_http_client_handle_t client = esp_http_client_init(&http_cfg);
+    if (!client) {
+        ESP_LOGE(TAG, "HTTP-Client init fehlgeschlagen");
+        return ESP_FAIL;
+    }
 
-    esp_err_t ret = esp_https_ota(&ota_cfg);
-    
+    ota_stream_t *ota = NULL;
+    size_t offset = 0;
+    char etag[64] = {0};
+    uint64_t paused_us = 0;
+    esp_err_t ret = ESP_FAIL;
+
+    for (int attempt = 0; attempt <= OTA_RESUME_RETRIES; attempt++) {
+        if (attempt > 0) {
+            ESP_LOGW(TAG, "Download unterbrochen bei %u Byte, Versuch %d/%d in %d s",
+                     (unsigned)offset, attempt, OTA_RESUME_RETRIES, 2 * attempt);
+            vTaskDelay(pdMS_TO_TICKS(2000 * attempt));
+        }
+
+        // Fortsetzen ab dem letzten geschriebenen Byte; If-Range sorgt dafür,
+        // dass bei geändertem Image das vollständige neue Image kommt (200)
+        if (ota && offset > 0) {
+            char range[32];
+            snprintf(range, sizeof(range), "bytes=%u-", (unsigned)offset);
+            esp_http_client_set_header(client, "Range", range);
+            if (etag[0]) {
+                esp_http_client_set_header(client, "If-Range", etag);
+            }
+        }
+
+        ret = esp_http_client_open(client, 0);
+        if (ret != ESP_OK) {
+            ESP_LOGE(TAG, "OTA-Verbindung fehlgeschlagen: %s (0x%x)", esp_err_to_name(ret), ret);
+            ESP_LOGE(TAG, "URL: %s", url);
+            if (ret == ESP_ERR_HTTP_CONNECT) {
+                ESP_LOGE(TAG, "Kann Server nicht erreichen - prüfe Netzwerk und URL");
+            }
+            continue;
+        }
+
+        int64_t content_length = esp_http_client_fetch_headers(client);
+        int status = esp_http_client_get_status_code(client);
+
+        if (status == 206 && ota && offset > 0) {
+            int64_t start = content_range_start(client);
+            if (start != (int64_t)offset) {
+                // Teil passt nicht an das Geschriebene: ohne Range von vorn
+                ESP_LOGW(TAG, "Content-Range beginnt bei %lld statt %u Byte, beginne neu",
+                         start, (unsigned)offset);
+                ota_stream_abort(ota, "Content-Range passt nicht");
+                ota = NULL;
+                offset = 0;
+                ret = ESP_ERR_TIMEOUT;
+                esp_http_client_close(client);
+                esp_http_client_delete_header(client, "Range");
+                esp_http_client_delete_header(client, "If-Range");
+                continue;
+            }
+            ESP_LOGI(TAG, "Setze Download bei %u Byte fort (%lld Byte verbleibend)",
+                     (unsigned)offset, content_length);
+        } else if (status == 200) {
+            if (ota) {
+                // Server ignoriert Range oder Image hat sich geändert: von vorn
+                ESP_LOGW(TAG, "Server liefert vollständiges Image, beginne neu");
+                ota_stream_abort(ota, "Image geändert");
+                ota = NULL;
+            }
+            char *value = NULL;
+            etag[0] = '\0';
+            if (esp_http_client_get_header(client, "ETag", &value) == ESP_OK && value) {
+                snprintf(etag, sizeof(etag), "%s", value);
+            }
+            offset = 0;
+            // Chunked (keine Länge): Größe unbekannt, Ende über das letzte Chunk
+            ret = ota_stream_begin(content_length > 0 ? (size_t)content_length : 0, NULL, &ota);
+            if (ret != ESP_OK) {
+                break;
+            }
+        } else {
+            ESP_LOGE(TAG, "HTTP-Header-Fehler - Server antwortet nicht korrekt (Status %d)", status);
+            ret = ESP_ERR_HTTP_FETCH_HEADER;
+            // 4xx: Wiederholen ist sinnlos
+            if (status >= 400 && status < 500) {
+                break;
+            }
+            esp_http_client_close(client);
+            continue;
+        }
+
+        ret = download_slices(client, ota, &offset, &paused_us);
+        esp_http_client_close(client);
+        esp_http_client_delete_header(client, "Range");
+        esp_http_client_delete_header(client, "If-Range");
+        if (ret != ESP_ERR_TIMEOUT) {
+            break;
+        }
+    }
+    esp_http_client_cleanup(client);
+
+    if (ret != ESP_OK) {
+        if (ota) {
+            ota_stream_abort(ota, esp_err_to_name(ret));
+        }
+        if (ret == ESP_ERR_TIMEOUT) {
+            ESP_LOGE(TAG, "Timeout beim Download - Server zu langsam oder nicht erreichbar");
+        }
+        return ret;
+    }
+
+    ESP_LOGI(TAG, "Download gedrosselt: %llu ms Pausen (LIN-Lücken und Budget)", paused_us / 1000);
+    ret = ota_stream_finish(ota);
     if (ret == ESP_OK) {
         ESP_LOGI(TAG, "OTA-Update erfolgreich! Reboot...");
         vTaskDelay(pdMS_TO_TICKS(1000));
         esp_restart();
-    } else {
-        ESP_LOGE(TAG, "OTA-Update fehlgeschlagen: %s (0x%x)", esp_err_to_name(ret), ret);
-        ESP_LOGE(TAG, "URL: %s", url);
-        
-        if (ret == ESP_ERR_HTTP_CONNECT) {
-            ESP_LOGE(TAG, "Kann Server nicht erreichen - prüfe Netzwerk und URL");
-        } else if (ret == ESP_ERR_TIMEOUT) {
-            ESP_LOGE(TAG, "Timeout beim Download - Server zu langsam oder nicht erreichbar");
-        } else if (ret == ESP_ERR_HTTP_FETCH_HEADER) {
-            ESP_LOGE(TAG, "HTTP-Header-Fehler - Server antwortet nicht korrekt");
-        }
     }
-    
     return ret;
 }
 
+// Genau n Byte aus dem HTTP-Stream lesen
+static esp_err_t http_read_exact(esp_http_client_handle_t client, void *dst, size_t n)
+{
+    size_t got = 0;
+    while (got < n) {
+        int r = esp_http_client_read(client, (char *)dst + got, n - got);
+        if (r <= 0) {
+            return ESP_ERR_TIMEOUT;
+        }
+        got += r;
+    }
+    return ESP_OK;
+}
+
+// SHA-256 über die ersten len Byte einer Partition
+static esp_err_t partition_sha256(const esp_partition_t *part, size_t len, uint8_t *buf, size_t cap,
+                                  uint8_t out[32])
+{
+    mbedtls_sha256_context sha;
+    mbedtls_sha256_init(&sha);
+    mbedtls_sha256_starts(&sha, 0);
+    esp_err_t err = ESP_OK;
+    for (size_t off = 0; off < len && err == ESP_OK; off += cap) {
+        size_t n = len - off < cap ? len - off : cap;
+        err = esp_partition_read(part, off, buf, n);
+        if (err == ESP_OK) {
+            mbedtls_sha256_update(&sha, buf, n);
+        }
+    }
+    mbedtls_sha256_finish(&sha, out);
+    mbedtls_sha256_free(&sha);
+    return err;
+}
+
+// Operationen des Patches anwenden. Ausgabe wird im Stream-Puffer gesammelt
+// und in Schritten von OTA_SLICE_SIZE geschrieben (gleiche Drosselung wie beim Download).
+static esp_err_t delta_apply_ops(esp_http_client_handle_t client, ota_stream_t *ota,
+                                 const esp_partition_t *running, const ota_delta_hdr_t *hdr,
+                                 uint64_t *paused_us)
+{
+    size_t cap;
+    uint8_t *buf = ota_stream_buf(ota, &cap);
+    size_t slice = cap < OTA_SLICE_SIZE ? cap : OTA_SLICE_SIZE;
+    size_t fill = 0;
+    uint32_t out_total = 0;
+    int64_t t0 = esp_timer_get_time();
+
+    while (1) {
+        uint8_t op;
+        uint32_t args[2];
+        esp_err_t err = http_read_exact(client, &op, 1);
+        if (err != ESP_OK) return err;
+        if (op == DELTA_OP_END) break;
+
+        uint32_t src_off = 0, len;
+        if (op == DELTA_OP_COPY) {
+            if ((err = http_read_exact(client, args, 8)) != ESP_OK) return err;
+            src_off = args[0];
+            len = args[1];
+            if ((uint64_t)src_off + len > hdr->src_size) {
+                ESP_LOGE(TAG, "Delta: COPY außerhalb des Quell-Images (%u+%u)", (unsigned)src_off, (unsigned)len);
+                return ESP_ERR_INVALID_SIZE;
+            }
+        } else if (op == DELTA_OP_INSERT) {
+            if ((err = http_read_exact(client, args, 4)) != ESP_OK) return err;
+            len = args[0];
+        } else {
+            ESP_LOGE(TAG, "Delta: unbekannte Operation %u", op);
+            return ESP_ERR_INVALID_RESPONSE;
+        }
+        if ((uint64_t)out_total + len > hdr->dst_size) {
+            ESP_LOGE(TAG, "Delta: Ausgabe größer als angekündigt");
+            return ESP_ERR_INVALID_SIZE;
+        }
+        out_total += len;
+
+        while (len > 0) {
+            size_t n = slice - fill < len ? slice - fill : len;
+            err = op == DELTA_OP_COPY ? esp_partition_read(running, src_off, buf + fill, n)
+                                      : http_read_exact(client, buf + fill, n);
+            if (err != ESP_OK) return err;
+            src_off += n;
+            fill += n;
+            len -= n;
+
+            if (fill == slice) {
+                if ((err = ota_stream_commit(ota, fill)) != ESP_OK) return err;
+                fill = 0;
+                *paused_us += throttle_slice(slice, esp_timer_get_time() - t0);
+                *paused_us += wait_for_lin_gap();
+                t0 = esp_timer_get_time();
+            }
+        }
+    }
+
+    if (fill > 0) {
+        esp_err_t err = ota_stream_commit(ota, fill);
+        if (err != ESP_OK) return err;
+    }
+    if (out_total != hdr->dst_size) {
+        ESP_LOGE(TAG, "Delta: %u Byte erzeugt, erwartet %u", (unsigned)out_total, (unsigned)hdr->dst_size);
+        return ESP_ERR_INVALID_SIZE;
+    }
+    return ESP_OK;
+}
+
+esp_err_t ota_delta_update_from_url(const char *url)
+{
+    char delta_url[288];
+    snprintf(delta_url, sizeof(delta_url), "%s.from-%s.delta", url, FW_VERSION);
+    ESP_LOGI(TAG, "Versuche Delta-Update von: %s", delta_url);
+
+    esp_http_client_config_t http_cfg = {
+        .url = delta_url,
+        .timeout_ms = 30000,
+        .crt_bundle_attach = esp_crt_bundle_attach,
+    };
+    esp_http_client_handle_t client = esp_http_client_init(&http_cfg);
+    if (!client) {
+        return ESP_FAIL;
+    }
+
+    ota_stream_t *ota = NULL;
+    uint64_t paused_us = 0;
+    ota_delta_hdr_t hdr;
+    esp_err_t err = esp_http_client_open(client, 0);
+    if (err == ESP_OK) {
+        esp_http_client_fetch_headers(client);
+        int status = esp_http_client_get_status_code(client);
+        if (status != 200) {
+            ESP_LOGW(TAG, "Kein Delta verfügbar (Status %d)", status);
+            err = ESP_ERR_NOT_FOUND;
+        }
+    }
+    if (err == ESP_OK) {
+        err = http_read_exact(client, &hdr, sizeof(hdr));
+    }
+    if (err == ESP_OK && (hdr.magic != OTA_DELTA_MAGIC || hdr.version != OTA_DELTA_VERSION)) {
+        ESP_LOGE(TAG, "Delta: ungültiger Kopf (magic 0x%08x, v%u)", (unsigned)hdr.magic, hdr.version);
+        err = ESP_ERR_INVALID_VERSION;
+    }
+
+    const esp_partition_t *running = esp_ota_get_running_partition();
+    if (err == ESP_OK && hdr.src_size > running->size) {
+        err = ESP_ERR_INVALID_SIZE;
+    }
+
+    if (err == ESP_OK) {
+        char dst_hex[65];
+        for (int i = 0; i < 32; i++) {
+            snprintf(dst_hex + 2 * i, 3, "%02x", hdr.dst_sha256[i]);
+        }
+        err = ota_stream_begin(hdr.dst_size, dst_hex, &ota);
+    }
+
+    // Patch passt nur auf genau das Image, gegen das er erzeugt wurde
+    if (err == ESP_OK) {
+        size_t cap;
+        uint8_t *buf = ota_stream_buf(ota, &cap);
+        uint8_t src_sha[32];
+        err = partition_sha256(running, hdr.src_size, buf, cap, src_sha);
+        if (err == ESP_OK && memcmp(src_sha, hdr.src_sha256, sizeof(src_sha)) != 0) {
+            ESP_LOGW(TAG, "Delta: laufende Firmware passt nicht zum Patch");
+            err = ESP_ERR_INVALID_CRC;
+        }
+    }
+
+    if (err == ESP_OK) {
+        int64_t len = esp_http_client_get_content_length(client);
+        ESP_LOGI(TAG, "Delta: %lld Byte Patch für %u Byte Image (%lld%%)", len, (unsigned)hdr.dst_size,
+                 len > 0 && hdr.dst_size ? len * 100 / hdr.dst_size : -1LL);
+        err = delta_apply_ops(client, ota, running, &hdr, &paused_us);
+    }
+    esp_http_client_cleanup(client);
+
+    if (err != ESP_OK) {
+        if (ota) {
+            ota_stream_abort(ota, "Delta fehlgeschlagen");
+        }
+        return err;
+    }
+
+    // Prüft den Ziel-Hash aus dem Kopf
+    err = ota_stream_finish(ota);
+    if (err == ESP_OK) {
+        ESP_LOGI(TAG, "Delta-Update erfolgreich! Reboot...");
+        vTaskDelay(pdMS_TO_TICKS(1000));
+        esp_restart();
+    }
+    return err;
+}
+
+// Semantic Versioning: "1.2.3", "v1.2.3", "1.2.3-rc1". Fehlende Teile zählen
+// als 0, eine Vorabversion ist kleiner als die zugehörige Release-Version.
+int ota_version_compare(const char *a, const char *b)
+{
+    if (*a == 'v' || *a == 'V') a++;
+    if (*b == 'v' || *b == 'V') b++;
+
+    for (int part = 0; part < 3; part++) {
+        char *end_a, *end_b;
+        unsigned long va = strtoul(a, &end_a, 10);
+        unsigned long vb = strtoul(b, &end_b, 10);
+        if (va != vb) {
+            return va < vb ? -1 : 1;
+        }
+        a = *end_a == '.' ? end_a + 1 : end_a;
+        b = *end_b == '.' ? end_b + 1 : end_b;
+    }
+
+    // Build-Metadaten (+...) werden ignoriert
+    bool pre_a = *a == '-', pre_b = *b == '-';
+    if (pre_a != pre_b) {
+        return pre_a ? -1 : 1;
+    }
+    if (!pre_a) {
+        return 0;
+    }
+    size_t len_a = strcspn(a, "+"), len_b = strcspn(b, "+");
+    int c = strncmp(a, b, len_a < len_b ? len_a : len_b);
+    if (c != 0) {
+        return c < 0 ? -1 : 1;
+    }
+    return len_a == len_b ? 0 : (len_a < len_b ? -1 : 1);
+}
+
+// Validatoren der letzten Versions-Antwort: unveränderte Checks kosten nur ein 304
+static struct {
+    char etag[64];
+    char last_modified[40];
+    char version[32];
+} version_cache;
+
 static esp_err_t check_new_version(const char *url, bool *update_available)
 {
     // Versions-Check: Lade Version-Info vom Server
@@ -73,6 +774,15 @@ static esp_err_t check_new_version(const char *url, bool *update_available)
         ESP_LOGE(TAG, "HTTP-Client init fehlgeschlagen");
         return ESP_FAIL;
     }
+
+    if (version_cache.version[0]) {
+        if (version_cache.etag[0]) {
+            esp_http_client_set_header(client, "If-None-Match", version_cache.etag);
+        }
+        if (version_cache.last_modified[0]) {
+            esp_http_client_set_header(client, "If-Modified-Since", version_cache.last_modified);
+        }
+    }
     
     esp_err_t err = esp_http_client_open(client, 0);
     
@@ -90,25 +800,46 @@ static esp_err_t check_new_version(const char *url, bool *update_available)
     // Lese Versions-Info
     char server_version[32] = {0};
     int content_length = esp_http_client_fetch_headers(client);
-    
-    if (content_length > 0 && content_length < sizeof(server_version)) {
+    int status = esp_http_client_get_status_code(client);
+
+    if (status == 304) {
+        ESP_LOGI(TAG, "Versions-Datei unverändert (304), Server-Version: %s", version_cache.version);
+        snprintf(server_version, sizeof(server_version), "%s", version_cache.version);
+    } else if (status == 200 && content_length > 0 && content_length < sizeof(server_version)) {
         esp_http_client_read(client, server_version, content_length);
         server_version[content_length] = '\0';
         
         // Entferne Newlines
-        char *newline = strchr(server_version, '\n');
+        char *newline = strpbrk(server_version, "\r\n");
         if (newline) *newline = '\0';
-        
-        ESP_LOGI(TAG, "Aktuelle Version: %s, Server-Version: %s", 
-                 FW_VERSION, server_version);
-        
-        // Einfacher String-Vergleich (für Semantic Versioning müsste man parsen)
-        if (strcmp(server_version, FW_VERSION) != 0) {
-            *update_available = true;
-            ESP_LOGI(TAG, "Neue Version verfügbar!");
-        } else {
-            *update_available = false;
+
+        // Validatoren für den nächsten Check merken
+        char *value = NULL;
+        version_cache.etag[0] = '\0';
+        version_cache.last_modified[0] = '\0';
+        if (esp_http_client_get_header(client, "ETag", &value) == ESP_OK && value) {
+            snprintf(version_cache.etag, sizeof(version_cache.etag), "%s", value);
+        }
+        value = NULL;
+        if (esp_http_client_get_header(client, "Last-Modified", &value) == ESP_OK && value) {
+            snprintf(version_cache.last_modified, sizeof(version_cache.last_modified), "%s", value);
         }
+        snprintf(version_cache.version, sizeof(version_cache.version), "%s", server_version);
+    } else {
+        ESP_LOGW(TAG, "Unerwartete Antwort auf Versions-Check (Status %d, %d Byte)", status, content_length);
+        esp_http_client_cleanup(client);
+        return ESP_ERR_INVALID_RESPONSE;
+    }
+
+    ESP_LOGI(TAG, "Aktuelle Version: %s, Server-Version: %s", 
+             FW_VERSION, server_version);
+
+    // Nur neuere Versionen installieren (kein Downgrade)
+    if (ota_version_compare(server_version, FW_VERSION) > 0) {
+        *update_available = true;
+        ESP_LOGI(TAG, "Neue Version verfügbar!");
+    } else {
+        *update_available = false;
     }
     
     esp_http_client_cleanup(client);
@@ -127,6 +858,12 @@ void ota_check_and_update_task(void *pvParameters)
         if (check_new_version(FW_UPDATE_URL, &update_available) == ESP_OK) {
             if (update_available) {
                 ESP_LOGI(TAG, "Starte automatisches Update...");
+#if OTA_DELTA_ENABLED
+                // Kehrt nur bei Fehler zurück: dann vollständiges Image laden
+                if (ota_delta_update_from_url(FW_UPDATE_URL) != ESP_OK) {
+                    ESP_LOGW(TAG, "Delta-Update nicht möglich, lade vollständiges Image");
+                }
+#endif
                 ota_update_from_url(FW_UPDATE_URL);
             }
         }
@@ -148,7 +885,8 @@ esp_err_t ota_init(void)
     
 #if AUTO_UPDATE
     // Starte Auto-Update-Task
-    xTaskCreate(ota_check_and_update_task, "ota_update", 8192, NULL, 5, NULL);
+    // Priorität unter Proxy (12), TCP-Sink (6) und Live-Stream (4)
+    xTaskCreate(ota_check_and_update_task, "ota_update", 8192, NULL, 3, NULL);
     ESP_LOGI(TAG, "Auto-Update aktiviert (Check alle %d Sekunden)", UPDATE_INTERVAL);
 #endif
     
@@ -1,17 +1,100 @@
 #ifndef OTA_H
 #define OTA_H
 
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
 #include "esp_err.h"
 
+typedef enum {
+    OTA_STATE_IDLE = 0,
+    OTA_STATE_RUNNING,
+    OTA_STATE_DONE,
+    OTA_STATE_FAILED,
+} ota_state_t;
+
+// Zustand des laufenden/letzten Streaming-Updates (für /api/ota/status)
+typedef struct {
+    ota_state_t state;
+    uint32_t total;             // erwartete Eingangsgröße in Byte (0 = unbekannt)
+    uint32_t received;          // empfangene Eingangs-Bytes (bei gzip komprimiert)
+    uint32_t written;           // bereits in den Flash geschrieben
+    bool compressed;            // Image kam gzip-komprimiert
+    uint32_t elapsed_ms;
+    uint32_t max_write_us;      // längster esp_ota_write()-Aufruf (Flash-Cache gesperrt)
+    uint32_t paused_ms;         // Wartezeit auf LIN-Pausen und Budget (nur Download)
+    uint32_t lin_p99_us;        // p99 der Proxy-Latenz während des Updates
+    uint32_t lin_max_us;
+    bool sha_checked;           // Digest wurde vorgegeben und geprüft
+    char sha256[65];            // berechneter SHA-256 (Hex), gesetzt nach Abschluss
+    char error[48];
+} ota_status_t;
+
+typedef struct ota_stream ota_stream_t;
+
+// Delta-Update (tools/ota_delta.py): Kopf, danach Operationen bis DELTA_OP_END.
+//   DELTA_OP_COPY   u8 op, u32 src_offset, u32 len   Bytes aus laufender Partition
+//   DELTA_OP_INSERT u8 op, u32 len, data[len]        neue Bytes aus dem Patch
+#define OTA_DELTA_MAGIC   0x544C444C  // "LDLT"
+#define OTA_DELTA_VERSION 1
+
+enum {
+    DELTA_OP_END = 0,
+    DELTA_OP_COPY = 1,
+    DELTA_OP_INSERT = 2,
+};
+
+typedef struct __attribute__((packed)) {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t flags;             // reserviert, 0
+    uint32_t src_size;          // Größe des Quell-Images (laufende Firmware)
+    uint32_t dst_size;          // Größe des Ziel-Images
+    uint8_t src_sha256[32];     // über die ersten src_size Byte der laufenden Partition
+    uint8_t dst_sha256[32];
+} ota_delta_hdr_t;
+
 // OTA-System initialisieren
 esp_err_t ota_init(void);
 
-// Firmware-Update über HTTP durchführen
+// Firmware-Update über HTTP durchführen. Lädt und schreibt in Schritten von
+// OTA_SLICE_SIZE, jeweils nur in LIN-Pausen und innerhalb von OTA_BW_LIMIT_KBPS
+// und OTA_CPU_BUDGET_PCT. Abgebrochene Downloads werden per HTTP Range ab dem
+// letzten geschriebenen Byte fortgesetzt (bis zu OTA_RESUME_RETRIES Mal).
 esp_err_t ota_update_from_url(const char *url);
 
 // Versions-Check und Auto-Update
 void ota_check_and_update_task(void *pvParameters);
 
+// Streaming-Update in die nächste OTA-Partition starten. total = 0 wenn
+// unbekannt, sha256_hex = NULL wenn kein Digest zur Prüfung vorliegt.
+// gzip-komprimierte Images (tools/ota_compress.py) werden am Magic erkannt und
+// beim Schreiben dekomprimiert; der SHA-256 gilt für das dekomprimierte Image.
+esp_err_t ota_stream_begin(size_t total, const char *sha256_hex, ota_stream_t **out);
+
+// Puffer (OTA_BUF_SIZE) zum direkten Befüllen durch den Aufrufer
+uint8_t* ota_stream_buf(ota_stream_t *s, size_t *cap);
+
+// len Byte aus dem Puffer (ggf. dekomprimieren,) hashen und in den Flash schreiben
+esp_err_t ota_stream_commit(ota_stream_t *s, size_t len);
+
+// Digest prüfen, Image abschließen und als Boot-Partition setzen (gibt s frei)
+esp_err_t ota_stream_finish(ota_stream_t *s);
+
+// Abbrechen und s freigeben
+void ota_stream_abort(ota_stream_t *s, const char *reason);
+
+// Status des laufenden/letzten Streaming-Updates
+void ota_get_status(ota_status_t *out);
+
+// Delta-Update von "<url>.from-<FW_VERSION>.delta" einspielen: liest die
+// laufende Partition, schreibt in die nächste und prüft den Ziel-Hash.
+// Bei Erfolg Neustart, sonst Fehler (Aufrufer fällt auf ota_update_from_url zurück).
+esp_err_t ota_delta_update_from_url(const char *url);
+
+// Versionen nach Semantic Versioning vergleichen (<0, 0, >0)
+int ota_version_compare(const char *a, const char *b);
+
 // Aktuelle Firmware-Version
 const char* ota_get_version(void);
 
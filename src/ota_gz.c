@@ -0,0 +1,215 @@
+#include "ota_gz.h"
+#include "config.h"
+#include "esp_log.h"
+#include "esp_rom_crc.h"
+#include "rom/miniz.h"
+#include <stdlib.h>
+#include <string.h>
+
+static const char *TAG = "OTA_GZ";
+
+#define GZ_WINDOW (1u << OTA_GZ_WINDOW_BITS)
+
+// gzip-Header-Flags (RFC 1952)
+#define GZ_FHCRC    0x02
+#define GZ_FEXTRA   0x04
+#define GZ_FNAME    0x08
+#define GZ_FCOMMENT 0x10
+
+typedef enum {
+    GZ_ST_HEADER,       // feste 10 Byte
+    GZ_ST_EXTRA_LEN,
+    GZ_ST_EXTRA,
+    GZ_ST_NAME,
+    GZ_ST_COMMENT,
+    GZ_ST_HCRC,
+    GZ_ST_DEFLATE,
+    GZ_ST_TRAILER,      // CRC32 + ISIZE
+    GZ_ST_DONE,
+} gz_state_t;
+
+struct ota_gz {
+    tinfl_decompressor inflator;
+    uint8_t window[GZ_WINDOW];  // Ringpuffer = Dekompressions-Fenster
+    size_t window_pos;
+    gz_state_t st;
+    uint8_t hdr[10];
+    uint8_t trailer[8];
+    uint32_t fill;              // Bytes im aktuellen Header-/Trailer-Abschnitt
+    uint32_t skip;              // verbleibende FEXTRA-Bytes
+    uint8_t flags;
+    bool more_output;           // tinfl hat noch Ausgabe, obwohl die Eingabe verbraucht ist
+    uint32_t crc;
+    uint32_t out_total;
+};
+
+bool ota_gz_is_gzip(const uint8_t *buf, size_t len)
+{
+    return len >= 2 && buf[0] == 0x1f && buf[1] == 0x8b;
+}
+
+ota_gz_t* ota_gz_new(void)
+{
+    ota_gz_t *gz = calloc(1, sizeof(ota_gz_t));
+    if (gz) {
+        tinfl_init(&gz->inflator);
+        gz->st = GZ_ST_HEADER;
+    }
+    return gz;
+}
+
+void ota_gz_free(ota_gz_t *gz)
+{
+    free(gz);
+}
+
+uint32_t ota_gz_output_size(const ota_gz_t *gz)
+{
+    return gz->out_total;
+}
+
+// Nach FEXTRA/FNAME/FCOMMENT/FHCRC: nächsten optionalen Abschnitt wählen
+static gz_state_t next_header_state(const ota_gz_t *gz, gz_state_t after)
+{
+    if (after < GZ_ST_EXTRA_LEN && (gz->flags & GZ_FEXTRA)) return GZ_ST_EXTRA_LEN;
+    if (after < GZ_ST_NAME && (gz->flags & GZ_FNAME)) return GZ_ST_NAME;
+    if (after < GZ_ST_COMMENT && (gz->flags & GZ_FCOMMENT)) return GZ_ST_COMMENT;
+    if (after < GZ_ST_HCRC && (gz->flags & GZ_FHCRC)) return GZ_ST_HCRC;
+    return GZ_ST_DEFLATE;
+}
+
+// Ein Header-Byte verarbeiten
+static esp_err_t header_byte(ota_gz_t *gz, uint8_t b)
+{
+    switch (gz->st) {
+        case GZ_ST_HEADER:
+            gz->hdr[gz->fill++] = b;
+            if (gz->fill == sizeof(gz->hdr)) {
+                if (gz->hdr[0] != 0x1f || gz->hdr[1] != 0x8b || gz->hdr[2] != 8) {
+                    ESP_LOGE(TAG, "Kein gzip/deflate-Stream");
+                    return ESP_ERR_INVALID_RESPONSE;
+                }
+                gz->flags = gz->hdr[3];
+                gz->fill = 0;
+                gz->st = next_header_state(gz, GZ_ST_HEADER);
+            }
+            break;
+        case GZ_ST_EXTRA_LEN:
+            gz->skip |= (uint32_t)b << (8 * gz->fill++);
+            if (gz->fill == 2) {
+                gz->fill = 0;
+                gz->st = gz->skip ? GZ_ST_EXTRA : next_header_state(gz, GZ_ST_EXTRA);
+            }
+            break;
+        case GZ_ST_EXTRA:
+            if (--gz->skip == 0) gz->st = next_header_state(gz, GZ_ST_EXTRA);
+            break;
+        case GZ_ST_NAME:
+        case GZ_ST_COMMENT:
+            if (b == 0) gz->st = next_header_state(gz, gz->st);
+            break;
+        case GZ_ST_HCRC:
+            if (++gz->fill == 2) {
+                gz->fill = 0;
+                gz->st = GZ_ST_DEFLATE;
+            }
+            break;
+        default:
+            break;
+    }
+    return ESP_OK;
+}
+
+// Der ROM-tinfl (miniz 1.15) gibt beim Stream-Ende vorausgelesene Bytes nicht
+// an die Eingabe zurück: Anfang des Trailers kann noch in m_bit_buf stehen.
+// Rest-Bits bis zur Bytegrenze verwerfen, dann ganze Bytes LSB-first als
+// Trailer übernehmen. miniz 2.x gibt die Bytes selbst zurück und lässt nur
+// < 8 Bits stehen, dann wird hier nichts übernommen.
+static void take_lookahead(ota_gz_t *gz)
+{
+    tinfl_bit_buf_t bit_buf = gz->inflator.m_bit_buf;
+    mz_uint32 num_bits = gz->inflator.m_num_bits;
+    bit_buf >>= num_bits & 7;
+    num_bits -= num_bits & 7;
+    while (num_bits >= 8 && gz->fill < sizeof(gz->trailer)) {
+        gz->trailer[gz->fill++] = (uint8_t)bit_buf;
+        bit_buf >>= 8;
+        num_bits -= 8;
+    }
+    if (gz->fill == sizeof(gz->trailer)) {
+        gz->st = GZ_ST_DONE;
+    }
+}
+
+esp_err_t ota_gz_feed(ota_gz_t *gz, const uint8_t *in, size_t len, ota_gz_out_fn out, void *ctx)
+{
+    while (len > 0 || gz->more_output) {
+        if (gz->st < GZ_ST_DEFLATE) {
+            esp_err_t err = header_byte(gz, *in++);
+            len--;
+            if (err != ESP_OK) return err;
+            continue;
+        }
+
+        if (gz->st == GZ_ST_DEFLATE) {
+            size_t in_size = len;
+            size_t out_size = GZ_WINDOW - gz->window_pos;
+            tinfl_status status = tinfl_decompress(&gz->inflator, in, &in_size,
+                                                   gz->window, gz->window + gz->window_pos, &out_size,
+                                                   TINFL_FLAG_HAS_MORE_INPUT);
+            in += in_size;
+            len -= in_size;
+
+            if (out_size > 0) {
+                const uint8_t *chunk = gz->window + gz->window_pos;
+                gz->crc = esp_rom_crc32_le(gz->crc, chunk, out_size);
+                gz->out_total += out_size;
+                gz->window_pos = (gz->window_pos + out_size) & (GZ_WINDOW - 1);
+                esp_err_t err = out(ctx, chunk, out_size);
+                if (err != ESP_OK) return err;
+            }
+
+            gz->more_output = status == TINFL_STATUS_HAS_MORE_OUTPUT;
+            if (status < TINFL_STATUS_DONE) {
+                ESP_LOGE(TAG, "Deflate-Fehler %d nach %u Byte", status, (unsigned)gz->out_total);
+                return ESP_ERR_INVALID_RESPONSE;
+            }
+            if (status == TINFL_STATUS_DONE) {
+                gz->st = GZ_ST_TRAILER;
+                gz->fill = 0;
+                take_lookahead(gz);
+            }
+            continue;
+        }
+
+        if (gz->st == GZ_ST_TRAILER) {
+            gz->trailer[gz->fill++] = *in++;
+            len--;
+            if (gz->fill == sizeof(gz->trailer)) {
+                gz->st = GZ_ST_DONE;
+            }
+            continue;
+        }
+
+        // Daten nach dem Trailer (z.B. zweites gzip-Member) werden nicht unterstützt
+        ESP_LOGW(TAG, "%u Byte nach Stream-Ende ignoriert", (unsigned)len);
+        break;
+    }
+    return ESP_OK;
+}
+
+esp_err_t ota_gz_finish(ota_gz_t *gz)
+{
+    if (gz->st != GZ_ST_DONE) {
+        ESP_LOGE(TAG, "gzip-Stream unvollständig (Zustand %d)", gz->st);
+        return ESP_ERR_INVALID_SIZE;
+    }
+    uint32_t crc = gz->trailer[0] | gz->trailer[1] << 8 | gz->trailer[2] << 16 | (uint32_t)gz->trailer[3] << 24;
+    uint32_t isize = gz->trailer[4] | gz->trailer[5] << 8 | gz->trailer[6] << 16 | (uint32_t)gz->trailer[7] << 24;
+    if (crc != gz->crc || isize != gz->out_total) {
+        ESP_LOGE(TAG, "CRC32/Länge falsch (CRC %08x/%08x, %u/%u Byte) - Fenster größer als %u?",
+                 (unsigned)crc, (unsigned)gz->crc, (unsigned)isize, (unsigned)gz->out_total, GZ_WINDOW);
+        return ESP_ERR_INVALID_CRC;
+    }
+    return ESP_OK;
+}
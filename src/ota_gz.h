@@ -0,0 +1,34 @@
+#ifndef OTA_GZ_H
+#define OTA_GZ_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "esp_err.h"
+
+// Streaming-gzip-Dekompression für OTA-Images (ROM-tinfl).
+// Das Fenster ist fest 1 << OTA_GZ_WINDOW_BITS Byte groß; das Image muss mit
+// demselben Fenster komprimiert sein (tools/ota_compress.py). Ein zu großes
+// Fenster fällt spätestens bei der CRC32-Prüfung in ota_gz_finish auf.
+
+typedef struct ota_gz ota_gz_t;
+
+// Empfängt die dekomprimierten Daten (zusammenhängend, max. Fenstergröße)
+typedef esp_err_t (*ota_gz_out_fn)(void *ctx, const uint8_t *data, size_t len);
+
+// true, wenn der Puffer mit dem gzip-Magic beginnt
+bool ota_gz_is_gzip(const uint8_t *buf, size_t len);
+
+ota_gz_t* ota_gz_new(void);
+void ota_gz_free(ota_gz_t *gz);
+
+// Beliebig gestückelte Eingabe verarbeiten
+esp_err_t ota_gz_feed(ota_gz_t *gz, const uint8_t *in, size_t len, ota_gz_out_fn out, void *ctx);
+
+// Stream vollständig und CRC32/Länge korrekt?
+esp_err_t ota_gz_finish(ota_gz_t *gz);
+
+// Bisher erzeugte Bytes (dekomprimiert)
+uint32_t ota_gz_output_size(const ota_gz_t *gz);
+
+#endif // OTA_GZ_H
@@ -0,0 +1,261 @@
+#include "proxy_config.h"
+#include "config.h"
+#include "lin_proxy.h"
+#include "log_filter.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "nvs.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+
+static const char *TAG = "PROXY_CFG";
+
+#define NVS_NAMESPACE "proxy_cfg"
+
+#define PARAM(field, type, min, max, def, restart) \
+    { #field, type, offsetof(proxy_config_t, field), min, max, def, restart }
+#define PARAM_AT(name, field, type, min, max, def, restart) \
+    { name, type, offsetof(proxy_config_t, field), min, max, def, restart }
+
+// LIN_SNIFFER_MODE wählt nur noch die Start-Betriebsart
+#if LIN_SNIFFER_MODE
+#define MODE_DEFAULT LIN_MODE_SNIFFER
+#else
+#define MODE_DEFAULT LIN_MODE_PROXY
+#endif
+
+static const char *mode_names[LIN_MODE_COUNT] = { "proxy", "tap", "sniffer", "bypass" };
+
+// Defaults entsprechen den bisherigen #defines in lin_proxy.c
+static const proxy_config_param_t params[] = {
+    PARAM(sync_max_bytes, PCFG_TYPE_UINT, 0,    16,    3,    false),
+    PARAM(sync_max_us,    PCFG_TYPE_UINT, 100,  10000, 600,  false),
+    PARAM(break_us,       PCFG_TYPE_UINT, 700,  10000, 1500, false),  // LIN: min. 13 Bit = 1354 µs
+    PARAM(rx_timeout,     PCFG_TYPE_UINT, 1,    100,   2,    false),
+    PARAM(uart_buf,       PCFG_TYPE_UINT, 256,  8192,  2048, true),   // > UART-FIFO (128 Byte)
+    PARAM(master_link,    PCFG_TYPE_LINK, LOG_LINK_LIN1, LOG_LINK_LIN2, LOG_LINK_LIN1, false),
+    PARAM_AT("lin1_mode", mode[LOG_LINK_LIN1], PCFG_TYPE_MODE, 0, LIN_MODE_COUNT - 1, MODE_DEFAULT, false),
+    PARAM_AT("lin2_mode", mode[LOG_LINK_LIN2], PCFG_TYPE_MODE, 0, LIN_MODE_COUNT - 1, MODE_DEFAULT, false),
+};
+#define PARAM_COUNT (int)(sizeof(params) / sizeof(params[0]))
+
+// Doppelpuffer: g_proxy_config zeigt immer auf einen der beiden
+static proxy_config_t cfg_buf[2];
+const proxy_config_t *volatile g_proxy_config = &cfg_buf[0];
+
+// Stand beim Boot (für Parameter, die einen Neustart brauchen)
+static proxy_config_t boot_cfg;
+
+// Schreiber serialisieren (HTTP-Task); Leser brauchen kein Lock
+static SemaphoreHandle_t write_lock;
+static int64_t last_swap_us;
+
+static uint32_t* field_ptr(proxy_config_t *cfg, const proxy_config_param_t *p)
+{
+    return (uint32_t *)((uint8_t *)cfg + p->offset);
+}
+
+int proxy_config_param_count(void)
+{
+    return PARAM_COUNT;
+}
+
+const proxy_config_param_t* proxy_config_param(int i)
+{
+    return (i >= 0 && i < PARAM_COUNT) ? &params[i] : NULL;
+}
+
+const proxy_config_param_t* proxy_config_find(const char *name)
+{
+    for (int i = 0; i < PARAM_COUNT; i++) {
+        if (strcmp(params[i].name, name) == 0) return &params[i];
+    }
+    return NULL;
+}
+
+uint32_t proxy_config_value(const proxy_config_t *cfg, const proxy_config_param_t *p)
+{
+    return *(const uint32_t *)((const uint8_t *)cfg + p->offset);
+}
+
+esp_err_t proxy_config_parse(proxy_config_t *draft, const proxy_config_param_t *p, const char *text)
+{
+    uint32_t v;
+    if (p->type == PCFG_TYPE_LINK) {
+        int found = -1;
+        for (int l = 0; l < LOG_LINK_COUNT; l++) {
+            if (strcasecmp(text, log_filter_link_name(l)) == 0) found = l;
+        }
+        if (found < 0) return ESP_ERR_INVALID_ARG;
+        v = found;
+    } else if (p->type == PCFG_TYPE_MODE) {
+        int found = -1;
+        for (int m = 0; m < LIN_MODE_COUNT; m++) {
+            if (strcasecmp(text, mode_names[m]) == 0) found = m;
+        }
+        if (found < 0) return ESP_ERR_INVALID_ARG;
+        v = found;
+    } else {
+        char *end = NULL;
+        unsigned long ul = strtoul(text, &end, 0);
+        if (end == text || *end != '\0') return ESP_ERR_INVALID_ARG;
+        v = ul;
+    }
+    if (v < p->min || v > p->max) return ESP_ERR_INVALID_ARG;
+    *field_ptr(draft, p) = v;
+    return ESP_OK;
+}
+
+const char* proxy_config_format(const proxy_config_param_t *p, uint32_t value, char *buf, size_t len)
+{
+    if (p->type == PCFG_TYPE_LINK) {
+        snprintf(buf, len, "\"%s\"", log_filter_link_name(value));
+    } else if (p->type == PCFG_TYPE_MODE) {
+        snprintf(buf, len, "\"%s\"", proxy_config_mode_name(value));
+    } else {
+        snprintf(buf, len, "%u", (unsigned)value);
+    }
+    return buf;
+}
+
+static void set_defaults(proxy_config_t *cfg)
+{
+    for (int i = 0; i < PARAM_COUNT; i++) {
+        *field_ptr(cfg, &params[i]) = params[i].def;
+    }
+}
+
+static esp_err_t save(const proxy_config_t *cfg)
+{
+    nvs_handle_t nvs;
+    esp_err_t err = nvs_open(NVS_NAMESPACE, NVS_READWRITE, &nvs);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "NVS öffnen fehlgeschlagen: %s", esp_err_to_name(err));
+        return err;
+    }
+    // Ein Key pro Parameter: neue Parameter in späteren Versionen bekommen einfach ihren Default
+    for (int i = 0; i < PARAM_COUNT && err == ESP_OK; i++) {
+        err = nvs_set_u32(nvs, params[i].name, proxy_config_value(cfg, &params[i]));
+    }
+    if (err == ESP_OK) {
+        err = nvs_commit(nvs);
+    }
+    nvs_close(nvs);
+
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Konfiguration speichern fehlgeschlagen: %s", esp_err_to_name(err));
+    }
+    return err;
+}
+
+esp_err_t proxy_config_init(void)
+{
+    proxy_config_t cfg = {0};
+    set_defaults(&cfg);
+
+    nvs_handle_t nvs;
+    if (nvs_open(NVS_NAMESPACE, NVS_READONLY, &nvs) == ESP_OK) {
+        int loaded = 0;
+        for (int i = 0; i < PARAM_COUNT; i++) {
+            uint32_t v;
+            if (nvs_get_u32(nvs, params[i].name, &v) != ESP_OK) continue;
+            if (v < params[i].min || v > params[i].max) {
+                ESP_LOGW(TAG, "%s=%u außerhalb [%u..%u] -> Default %u", params[i].name, (unsigned)v,
+                         (unsigned)params[i].min, (unsigned)params[i].max, (unsigned)params[i].def);
+                continue;
+            }
+            *field_ptr(&cfg, &params[i]) = v;
+            loaded++;
+        }
+        nvs_close(nvs);
+        ESP_LOGI(TAG, "%d Parameter aus NVS geladen", loaded);
+    } else {
+        ESP_LOGI(TAG, "Keine gespeicherte Konfiguration, nutze Defaults");
+    }
+
+    if (!write_lock) {
+        write_lock = xSemaphoreCreateMutex();
+    }
+    cfg.gen = 1;
+    cfg_buf[0] = cfg;
+    cfg_buf[1] = cfg;
+    boot_cfg = cfg;
+    g_proxy_config = &cfg_buf[0];
+
+    ESP_LOGI(TAG, "sync_max_bytes=%u sync_max_us=%u break_us=%u rx_timeout=%u uart_buf=%u master=%s modes=%s/%s",
+             (unsigned)cfg.sync_max_bytes, (unsigned)cfg.sync_max_us, (unsigned)cfg.break_us,
+             (unsigned)cfg.rx_timeout, (unsigned)cfg.uart_buf, log_filter_link_name(cfg.master_link),
+             proxy_config_mode_name(cfg.mode[LOG_LINK_LIN1]), proxy_config_mode_name(cfg.mode[LOG_LINK_LIN2]));
+    return ESP_OK;
+}
+
+esp_err_t proxy_config_apply(const proxy_config_t *draft, bool persist)
+{
+    for (int i = 0; i < PARAM_COUNT; i++) {
+        uint32_t v = proxy_config_value(draft, &params[i]);
+        if (v < params[i].min || v > params[i].max) return ESP_ERR_INVALID_ARG;
+    }
+    if (!write_lock) return ESP_ERR_INVALID_STATE;
+
+    xSemaphoreTake(write_lock, portMAX_DELAY);
+
+    // Der inaktive Puffer kann noch von einem Frame benutzt werden, das vor dem
+    // letzten Umschalten begonnen hat. Ein Frame dauert höchstens LIN_FRAME_MAX_US.
+    int64_t since = esp_timer_get_time() - last_swap_us;
+    if (since < LIN_FRAME_MAX_US) {
+        vTaskDelay(pdMS_TO_TICKS((LIN_FRAME_MAX_US - since) / 1000 + 1));
+    }
+
+    const proxy_config_t *cur = g_proxy_config;
+    proxy_config_t *next = (cur == &cfg_buf[0]) ? &cfg_buf[1] : &cfg_buf[0];
+    *next = *draft;
+    next->gen = cur->gen + 1;
+    __atomic_store_n(&g_proxy_config, next, __ATOMIC_RELEASE);
+    last_swap_us = esp_timer_get_time();
+
+    ESP_LOGI(TAG, "Konfiguration Generation %u aktiv", (unsigned)next->gen);
+
+    esp_err_t err = persist ? save(next) : ESP_OK;
+    xSemaphoreGive(write_lock);
+    return err;
+}
+
+esp_err_t proxy_config_reset(void)
+{
+    proxy_config_t cfg = {0};
+    set_defaults(&cfg);
+    esp_err_t err = proxy_config_apply(&cfg, false);
+    if (err != ESP_OK) return err;
+
+    nvs_handle_t nvs;
+    err = nvs_open(NVS_NAMESPACE, NVS_READWRITE, &nvs);
+    if (err != ESP_OK) return err;
+    err = nvs_erase_all(nvs);
+    if (err == ESP_OK) {
+        err = nvs_commit(nvs);
+    }
+    nvs_close(nvs);
+    return err;
+}
+
+const char* proxy_config_mode_name(lin_mode_t mode)
+{
+    return mode < LIN_MODE_COUNT ? mode_names[mode] : "?";
+}
+
+bool proxy_config_restart_pending(void)
+{
+    const proxy_config_t *cur = proxy_config_get();
+    for (int i = 0; i < PARAM_COUNT; i++) {
+        if (params[i].restart && proxy_config_value(cur, &params[i]) != proxy_config_value(&boot_cfg, &params[i])) {
+            return true;
+        }
+    }
+    return false;
+}
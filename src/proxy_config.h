@@ -0,0 +1,86 @@
+#ifndef PROXY_CONFIG_H
+#define PROXY_CONFIG_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "esp_err.h"
+
+// Betriebsart je Eingangs-Link (Richtung), umschaltbar an Frame-Grenzen
+typedef enum {
+    LIN_MODE_PROXY = 0,     // Header regenerieren bzw. Antwort durchreichen, Capture + Log
+    LIN_MODE_TAP,           // wie PROXY, zusätzlich Detail-Analyse (Analyse-Task, nicht im Hot-Path)
+    LIN_MODE_SNIFFER,       // nur mitlesen und analysieren, nichts weiterleiten
+    LIN_MODE_BYPASS,        // BREAK + Rohbytes sofort weiterleiten, kein Parsen/Log/Capture
+    LIN_MODE_COUNT
+} lin_mode_t;
+
+// Laufzeit-Parameter des Proxys (früher #defines in lin_proxy.c)
+typedef struct {
+    uint32_t gen;               // Generation, bei jeder Übernahme +1
+    uint32_t sync_max_bytes;    // max. Nicht-0x55 Bytes nach BREAK
+    uint32_t sync_max_us;       // max. Zeitfenster nach BREAK für SYNC
+    uint32_t break_us;          // Länge des regenerierten BREAK
+    uint32_t rx_timeout;        // UART-RX-Timeout in Symbolen
+    uint32_t uart_buf;          // UART-Treiberpuffer (erst nach Neustart)
+    uint32_t master_link;       // Link, an dem der Master hängt (log_link_t)
+    uint32_t mode[2];           // lin_mode_t je Eingangs-Link (Index log_link_t)
+} proxy_config_t;
+
+// Eintrag der Parameter-Registry
+typedef enum {
+    PCFG_TYPE_UINT = 0,
+    PCFG_TYPE_LINK,             // "LIN1"/"LIN2"
+    PCFG_TYPE_MODE,             // "proxy"/"tap"/"sniffer"/"bypass"
+} proxy_config_type_t;
+
+typedef struct {
+    const char *name;           // API-Name = NVS-Key (max. 15 Zeichen)
+    proxy_config_type_t type;
+    uint16_t offset;            // Offset in proxy_config_t
+    uint32_t min;
+    uint32_t max;
+    uint32_t def;
+    bool restart;               // wirkt erst nach Neustart
+} proxy_config_param_t;
+
+// Aktiver Snapshot; zwei Puffer, der Schreiber füllt immer den inaktiven und
+// schaltet dann den Zeiger um. Der Proxy-Task liest ohne Lock und holt sich den
+// Zeiger nur an Frame-Grenzen (BREAK), damit ein Frame konsistente Werte sieht.
+extern const proxy_config_t *volatile g_proxy_config;
+
+static inline const proxy_config_t* proxy_config_get(void)
+{
+    return g_proxy_config;
+}
+
+// Werte aus NVS laden (fehlende/ungültige Keys -> Default)
+esp_err_t proxy_config_init(void);
+
+// Registry durchlaufen (für API/JSON)
+int proxy_config_param_count(void);
+const proxy_config_param_t* proxy_config_param(int i);
+const proxy_config_param_t* proxy_config_find(const char *name);
+
+// Wert eines Parameters aus einem Snapshot lesen
+uint32_t proxy_config_value(const proxy_config_t *cfg, const proxy_config_param_t *p);
+
+// Text ("1600", "LIN2") prüfen und in den Entwurf schreiben
+esp_err_t proxy_config_parse(proxy_config_t *draft, const proxy_config_param_t *p, const char *text);
+
+// Wert als Text (für JSON)
+const char* proxy_config_format(const proxy_config_param_t *p, uint32_t value, char *buf, size_t len);
+
+// Entwurf übernehmen: in den inaktiven Puffer schreiben, Zeiger umschalten,
+// optional in NVS speichern. Wartet ggf. bis der vorherige Puffer frei ist.
+esp_err_t proxy_config_apply(const proxy_config_t *draft, bool persist);
+
+// Alle Parameter auf Default (NVS-Einträge werden gelöscht)
+esp_err_t proxy_config_reset(void);
+
+// Name der Betriebsart ("proxy", ...)
+const char* proxy_config_mode_name(lin_mode_t mode);
+
+// Gespeicherte Neustart-Parameter weichen vom laufenden Stand ab
+bool proxy_config_restart_pending(void);
+
+#endif // PROXY_CONFIG_H
@@ -0,0 +1,262 @@
+#include "sysmon.h"
+#include "config.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "esp_heap_caps.h"
+#include "freertos/task.h"
+#include <stdlib.h>
+#include <string.h>
+
+static const char *TAG = "SYSMON";
+
+#define STATUS_MAX (SYSMON_MAX_TASKS + 8)   // Reserve für kurzlebige Tasks
+
+typedef struct {
+    char name[16];
+    uart_port_t port;
+    QueueHandle_t q;
+    uint8_t peak;
+} queue_slot_t;
+
+// Verlauf (Ring) und Slot-Tabellen; nur der Mess-Task schreibt,
+// Leser (HTTP) kopieren unter dem Lock
+static portMUX_TYPE sysmon_lock = portMUX_INITIALIZER_UNLOCKED;
+static sysmon_sample_t *hist;
+static uint32_t hist_count;         // Messungen insgesamt
+static sysmon_task_info_t tasks[SYSMON_MAX_TASKS];
+static queue_slot_t queues[SYSMON_MAX_QUEUES];
+static int queue_count;
+static uint32_t untracked;
+
+// Nur im Mess-Task
+static TaskStatus_t status[STATUS_MAX];
+static configRUN_TIME_COUNTER_TYPE prev_run[SYSMON_MAX_TASKS];
+static configRUN_TIME_COUNTER_TYPE prev_total;
+
+void sysmon_register_uart(const char *name, uart_port_t port, QueueHandle_t q)
+{
+    if (!q) return;
+    taskENTER_CRITICAL(&sysmon_lock);
+    if (queue_count < SYSMON_MAX_QUEUES) {
+        queue_slot_t *s = &queues[queue_count++];
+        strncpy(s->name, name, sizeof(s->name) - 1);
+        s->port = port;
+        s->q = q;
+        s->peak = 0;
+    }
+    taskEXIT_CRITICAL(&sysmon_lock);
+}
+
+#if configUSE_TRACE_FACILITY
+
+// Slot für eine Task suchen bzw. neu vergeben (freie Slots und Slots von
+// beendeten Tasks werden wiederverwendet)
+static int task_slot(sysmon_task_info_t *t, const bool *seen, const TaskStatus_t *ts, bool *is_new)
+{
+    for (int i = 0; i < SYSMON_MAX_TASKS; i++) {
+        if (t[i].number == ts->xTaskNumber) {
+            *is_new = false;
+            return i;
+        }
+    }
+    for (int i = 0; i < SYSMON_MAX_TASKS; i++) {
+        if (t[i].number == 0 || (!seen[i] && !t[i].alive)) {
+            *is_new = true;
+            return i;
+        }
+    }
+    return -1;
+}
+
+static void sample(void)
+{
+    static sysmon_task_info_t t[SYSMON_MAX_TASKS];
+    sysmon_sample_t s;
+    memset(&s, 0, sizeof(s));
+    memset(s.cpu_pm, 0xFF, sizeof(s.cpu_pm));
+    memset(s.stack_free, 0xFF, sizeof(s.stack_free));
+
+    s.t_ms = (uint32_t)(esp_timer_get_time() / 1000);
+    s.heap_free = heap_caps_get_free_size(MALLOC_CAP_8BIT);
+    s.heap_min = heap_caps_get_minimum_free_size(MALLOC_CAP_8BIT);
+    s.heap_largest = heap_caps_get_largest_free_block(MALLOC_CAP_8BIT);
+
+    configRUN_TIME_COUNTER_TYPE total = 0;
+    UBaseType_t n = uxTaskGetSystemState(status, STATUS_MAX, &total);
+    // Erste Messung: noch keine Vergleichsbasis für CPU-Anteile
+    configRUN_TIME_COUNTER_TYPE d_total = prev_total ? total - prev_total : 0;
+    prev_total = total;
+
+    taskENTER_CRITICAL(&sysmon_lock);
+    memcpy(t, tasks, sizeof(t));
+    taskEXIT_CRITICAL(&sysmon_lock);
+
+    // Erst bekannte Tasks zuordnen, dann neue auf freie Slots verteilen
+    bool seen[SYSMON_MAX_TASKS] = {0};
+    int slot_of[STATUS_MAX];
+    uint32_t missing = 0;
+    for (int pass = 0; pass < 2; pass++) {
+        for (UBaseType_t i = 0; i < n; i++) {
+            if (pass == 0) slot_of[i] = -1;
+            if (slot_of[i] >= 0) continue;
+            bool is_new = false;
+            int slot = task_slot(t, seen, &status[i], &is_new);
+            if (slot < 0 || (pass == 0 && is_new)) continue;
+            slot_of[i] = slot;
+            seen[slot] = true;
+            if (is_new) {
+                strncpy(t[slot].name, status[i].pcTaskName, sizeof(t[slot].name) - 1);
+                t[slot].name[sizeof(t[slot].name) - 1] = '\0';
+                t[slot].number = status[i].xTaskNumber;
+                prev_run[slot] = status[i].ulRunTimeCounter;
+            }
+        }
+    }
+
+    for (UBaseType_t i = 0; i < n; i++) {
+        int slot = slot_of[i];
+        if (slot < 0) {
+            missing++;
+            continue;
+        }
+        BaseType_t core = xTaskGetCoreID(status[i].xHandle);
+        t[slot].prio = status[i].uxCurrentPriority;
+        t[slot].core = core == tskNO_AFFINITY ? -1 : core;
+        s.stack_free[slot] = status[i].usStackHighWaterMark > 0xFFFE ? 0xFFFE : status[i].usStackHighWaterMark;
+
+#if configGENERATE_RUN_TIME_STATS
+        // Anteil an der Rechenzeit beider Kerne; neue Tasks erst ab der nächsten Messung
+        configRUN_TIME_COUNTER_TYPE d = status[i].ulRunTimeCounter - prev_run[slot];
+        prev_run[slot] = status[i].ulRunTimeCounter;
+        if (d_total > 0) {
+            uint64_t pm = (uint64_t)d * 1000 / ((uint64_t)d_total * portNUM_PROCESSORS);
+            s.cpu_pm[slot] = pm > 1000 ? 1000 : (uint16_t)pm;
+        }
+        for (int c = 0; c < portNUM_PROCESSORS && c < 2; c++) {
+            if (status[i].xHandle == xTaskGetIdleTaskHandleForCore(c) && d_total > 0) {
+                uint64_t idle = (uint64_t)d * 100 / d_total;
+                s.core_load[c] = idle >= 100 ? 0 : (uint8_t)(100 - idle);
+            }
+        }
+#endif
+    }
+    for (int i = 0; i < SYSMON_MAX_TASKS; i++) {
+        t[i].alive = seen[i];
+    }
+
+    // UART-Event-Queues und RX-Puffer
+    taskENTER_CRITICAL(&sysmon_lock);
+    int nq = queue_count;
+    taskEXIT_CRITICAL(&sysmon_lock);
+    for (int i = 0; i < nq; i++) {
+        UBaseType_t depth = uxQueueMessagesWaiting(queues[i].q);
+        size_t rx = 0;
+        uart_get_buffered_data_len(queues[i].port, &rx);
+        s.q_depth[i] = depth > 0xFF ? 0xFF : depth;
+        s.q_rx[i] = rx > 0xFFFF ? 0xFFFF : rx;
+    }
+
+    taskENTER_CRITICAL(&sysmon_lock);
+    memcpy(tasks, t, sizeof(tasks));
+    for (int i = 0; i < nq; i++) {
+        if (s.q_depth[i] > queues[i].peak) queues[i].peak = s.q_depth[i];
+    }
+    untracked = missing;
+    hist[hist_count % SYSMON_HISTORY] = s;
+    hist_count++;
+    taskEXIT_CRITICAL(&sysmon_lock);
+
+    if (n == 0) {
+        ESP_LOGW(TAG, "Mehr als %d Tasks, Messung unvollständig", STATUS_MAX);
+    }
+}
+
+static void sysmon_task(void *arg)
+{
+    TickType_t last = xTaskGetTickCount();
+    while (1) {
+        sample();
+        vTaskDelayUntil(&last, pdMS_TO_TICKS(SYSMON_INTERVAL_MS));
+    }
+}
+
+#endif // configUSE_TRACE_FACILITY
+
+esp_err_t sysmon_init(void)
+{
+#if SYSMON_ENABLED && configUSE_TRACE_FACILITY
+    hist = calloc(SYSMON_HISTORY, sizeof(sysmon_sample_t));
+    if (!hist) {
+        ESP_LOGE(TAG, "Kein Speicher für Verlauf (%u Byte)", (unsigned)(SYSMON_HISTORY * sizeof(sysmon_sample_t)));
+        return ESP_ERR_NO_MEM;
+    }
+    if (xTaskCreate(sysmon_task, "sysmon", 3072, NULL, 1, NULL) != pdPASS) {
+        free(hist);
+        hist = NULL;
+        return ESP_ERR_NO_MEM;
+    }
+#if !configGENERATE_RUN_TIME_STATS
+    ESP_LOGW(TAG, "CONFIG_FREERTOS_GENERATE_RUN_TIME_STATS aus: keine CPU-Anteile");
+#endif
+    ESP_LOGI(TAG, "Systemmonitor gestartet (%d ms, Verlauf %d)", SYSMON_INTERVAL_MS, SYSMON_HISTORY);
+    return ESP_OK;
+#else
+    ESP_LOGW(TAG, "Systemmonitor deaktiviert (SYSMON_ENABLED / CONFIG_FREERTOS_USE_TRACE_FACILITY)");
+    return ESP_ERR_NOT_SUPPORTED;
+#endif
+}
+
+int sysmon_history_count(void)
+{
+    taskENTER_CRITICAL(&sysmon_lock);
+    uint32_t n = hist_count;
+    taskEXIT_CRITICAL(&sysmon_lock);
+    return n < SYSMON_HISTORY ? (int)n : SYSMON_HISTORY;
+}
+
+bool sysmon_history_get(int index, sysmon_sample_t *out)
+{
+    bool ok = false;
+    taskENTER_CRITICAL(&sysmon_lock);
+    uint32_t n = hist_count < SYSMON_HISTORY ? hist_count : SYSMON_HISTORY;
+    if (hist && index >= 0 && (uint32_t)index < n) {
+        *out = hist[(hist_count - n + index) % SYSMON_HISTORY];
+        ok = true;
+    }
+    taskEXIT_CRITICAL(&sysmon_lock);
+    return ok;
+}
+
+int sysmon_get_tasks(sysmon_task_info_t *out, int max)
+{
+    int n = 0;
+    taskENTER_CRITICAL(&sysmon_lock);
+    for (int i = 0; i < SYSMON_MAX_TASKS && i < max; i++) {
+        out[i] = tasks[i];
+        if (tasks[i].number) n = i + 1;
+    }
+    taskEXIT_CRITICAL(&sysmon_lock);
+    return n;
+}
+
+int sysmon_get_queues(sysmon_queue_info_t *out, int max)
+{
+    QueueHandle_t q[SYSMON_MAX_QUEUES];
+    int n = 0;
+    taskENTER_CRITICAL(&sysmon_lock);
+    for (; n < queue_count && n < max; n++) {
+        memcpy(out[n].name, queues[n].name, sizeof(out[n].name));
+        out[n].peak = queues[n].peak;
+        q[n] = queues[n].q;
+    }
+    taskEXIT_CRITICAL(&sysmon_lock);
+    for (int i = 0; i < n; i++) {
+        out[i].size = uxQueueMessagesWaiting(q[i]) + uxQueueSpacesAvailable(q[i]);
+    }
+    return n;
+}
+
+uint32_t sysmon_untracked_tasks(void)
+{
+    return untracked;
+}
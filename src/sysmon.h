@@ -0,0 +1,65 @@
+#ifndef SYSMON_H
+#define SYSMON_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "esp_err.h"
+#include "config.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+#include "driver/uart.h"
+
+// Systemmonitor: misst alle SYSMON_INTERVAL_MS die CPU-Anteile pro Task
+// (Run-Time-Counter aus uxTaskGetSystemState), Stack-Reserven, Heap und die
+// Füllstände der UART-Event-Queues und hält SYSMON_HISTORY Messungen vor.
+// Läuft mit Priorität 1, stört also höchstens Idle.
+
+#define SYSMON_MAX_QUEUES 4
+#define SYSMON_NONE       0xFFFF    // Task lebte bei dieser Messung nicht
+
+// Eine Messung im Verlauf (Task-Spalten siehe sysmon_task_info)
+typedef struct {
+    uint32_t t_ms;                          // ms seit Boot
+    uint32_t heap_free;
+    uint32_t heap_min;                      // Minimum seit Boot
+    uint32_t heap_largest;                  // größter freier Block
+    uint16_t cpu_pm[SYSMON_MAX_TASKS];      // CPU-Anteil in Promille (beide Kerne = 1000)
+    uint16_t stack_free[SYSMON_MAX_TASKS];  // kleinste Stack-Reserve in Byte
+    uint8_t  q_depth[SYSMON_MAX_QUEUES];    // Einträge in der Event-Queue
+    uint16_t q_rx[SYSMON_MAX_QUEUES];       // Bytes im UART-RX-Puffer
+    uint8_t  core_load[2];                  // Last je Kern in Prozent (100 - Idle)
+} sysmon_sample_t;
+
+// Task-Spalte (Slot) im Verlauf
+typedef struct {
+    char name[16];
+    uint32_t number;        // xTaskNumber, 0 = Slot frei
+    uint8_t prio;
+    int8_t core;            // -1 = keine Affinität
+    bool alive;             // bei der letzten Messung gesehen
+} sysmon_task_info_t;
+
+typedef struct {
+    char name[16];
+    uint8_t size;           // Queue-Länge
+    uint8_t peak;           // höchster gemessener Füllstand
+} sysmon_queue_info_t;
+
+// UART-Event-Queue zur Überwachung anmelden (vor oder nach sysmon_init)
+void sysmon_register_uart(const char *name, uart_port_t port, QueueHandle_t q);
+
+// Mess-Task starten
+esp_err_t sysmon_init(void);
+
+// Messungen im Verlauf (max. SYSMON_HISTORY), index 0 = älteste
+int sysmon_history_count(void);
+bool sysmon_history_get(int index, sysmon_sample_t *out);
+
+// Slot-Tabellen lesen; Rückgabe = Anzahl belegter Einträge
+int sysmon_get_tasks(sysmon_task_info_t *out, int max);
+int sysmon_get_queues(sysmon_queue_info_t *out, int max);
+
+// Tasks, die wegen SYSMON_MAX_TASKS keinen Slot bekommen haben
+uint32_t sysmon_untracked_tasks(void);
+
+#endif // SYSMON_H
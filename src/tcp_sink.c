@@ -0,0 +1,249 @@
+#include "tcp_sink.h"
+#include "capture.h"
+#include "config.h"
+#include "esp_log.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "lwip/sockets.h"
+#include <string.h>
+#include <errno.h>
+
+static const char *TAG = "TCP_SINK";
+
+#define SINK_POLL_MS        10      // Wartezeit, wenn der Ring leer ist
+#define SINK_RETRY_MS       2000    // Pause vor erneutem Verbindungsaufbau
+#define SINK_SEND_TIMEOUT_MS 200    // send() blockiert höchstens so lange
+#define SINK_HELLO_TIMEOUT_S 2      // Wartezeit auf Start-Sequenz des Collectors
+// Rückstand, ab dem übersprungen wird: so bleibt zwischen gesendetem Abschnitt
+// und Schreibposition genug Abstand, dass er während send() nicht überschrieben wird
+#define SINK_MAX_LAG        (CAPTURE_RING_SIZE * 3 / 4)
+#define SINK_RESYNC_LAG     (CAPTURE_RING_SIZE / 2)
+
+static tcp_sink_stats_t stats;
+
+void tcp_sink_get_stats(tcp_sink_stats_t *out)
+{
+    *out = stats;
+}
+
+#if TCP_SINK_MODE
+static int recv_all(int sock, void *buf, size_t len)
+{
+    size_t got = 0;
+    while (got < len) {
+        int n = recv(sock, (uint8_t *)buf + got, len - got, 0);
+        if (n <= 0) return -1;
+        got += n;
+    }
+    return 0;
+}
+
+static int send_all(int sock, const void *buf, size_t len)
+{
+    size_t done = 0;
+    while (done < len) {
+        int n = send(sock, (const uint8_t *)buf + done, len - done, 0);
+        if (n < 0) {
+            if (errno == EAGAIN || errno == EWOULDBLOCK) continue;
+            return -1;
+        }
+        done += n;
+    }
+    return 0;
+}
+
+static void set_timeouts(int sock)
+{
+    struct timeval tv = { .tv_sec = 0, .tv_usec = SINK_SEND_TIMEOUT_MS * 1000 };
+    setsockopt(sock, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));
+    tv.tv_sec = SINK_HELLO_TIMEOUT_S;
+    tv.tv_usec = 0;
+    setsockopt(sock, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+    int keepalive = 1;
+    setsockopt(sock, SOL_SOCKET, SO_KEEPALIVE, &keepalive, sizeof(keepalive));
+}
+
+#if TCP_SINK_MODE == 1
+// Gerät verbindet sich zum Collector
+static int sink_open(void)
+{
+    struct sockaddr_in addr = {
+        .sin_family = AF_INET,
+        .sin_port = htons(TCP_SINK_PORT),
+    };
+    if (inet_pton(AF_INET, TCP_SINK_HOST, &addr.sin_addr) != 1) {
+        ESP_LOGE(TAG, "Ungültige Collector-Adresse: %s", TCP_SINK_HOST);
+        return -1;
+    }
+
+    int sock = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    if (sock < 0) return -1;
+
+    if (connect(sock, (struct sockaddr *)&addr, sizeof(addr)) != 0) {
+        ESP_LOGD(TAG, "Verbindung zu %s:%d fehlgeschlagen: errno %d", TCP_SINK_HOST, TCP_SINK_PORT, errno);
+        close(sock);
+        return -1;
+    }
+    return sock;
+}
+#else
+// Collector verbindet sich zum Gerät
+static int sink_open(void)
+{
+    static int listen_sock = -1;
+
+    if (listen_sock < 0) {
+        listen_sock = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+        if (listen_sock < 0) return -1;
+        int reuse = 1;
+        setsockopt(listen_sock, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+        struct sockaddr_in addr = {
+            .sin_family = AF_INET,
+            .sin_port = htons(TCP_SINK_PORT),
+            .sin_addr.s_addr = htonl(INADDR_ANY),
+        };
+        if (bind(listen_sock, (struct sockaddr *)&addr, sizeof(addr)) != 0 ||
+            listen(listen_sock, 1) != 0) {
+            ESP_LOGE(TAG, "Lauschen auf Port %d fehlgeschlagen: errno %d", TCP_SINK_PORT, errno);
+            close(listen_sock);
+            listen_sock = -1;
+            return -1;
+        }
+        ESP_LOGI(TAG, "Warte auf Collector an Port %d", TCP_SINK_PORT);
+    }
+
+    // Nur ein Collector gleichzeitig; weitere warten im Backlog
+    return accept(listen_sock, NULL, NULL);
+}
+#endif
+
+// Hello senden, Start-Sequenz empfangen
+static bool sink_handshake(int sock, uint32_t *next_seq)
+{
+    tcp_sink_hello_t hello = {
+        .magic = TCP_SINK_MAGIC,
+        .version = TCP_SINK_VERSION,
+        .rec_size = sizeof(capture_rec_t),
+        .ring_size = CAPTURE_RING_SIZE,
+        .head = capture_head(),
+    };
+    uint32_t resume = 0;
+
+    if (send_all(sock, &hello, sizeof(hello)) != 0 || recv_all(sock, &resume, sizeof(resume)) != 0) {
+        return false;
+    }
+
+    // 0 bzw. nicht mehr im Ring: ab ältestem Eintrag (capture_peek zählt die Lücke)
+    uint32_t head = capture_head();
+    if (resume == 0 || resume - 1 > head) {
+        // resume > head+1: Gerät wurde neu gestartet, Sequenzen beginnen wieder bei 1
+        *next_seq = head >= CAPTURE_RING_SIZE ? head - CAPTURE_RING_SIZE + 1 : 1;
+    } else {
+        *next_seq = resume;
+    }
+    ESP_LOGI(TAG, "Collector verbunden, Start bei seq=%lu (head=%lu)",
+             (unsigned long)*next_seq, (unsigned long)head);
+    return true;
+}
+
+// Ring streamen bis zum Verbindungsabbruch
+static void sink_stream(int sock, uint32_t next_seq)
+{
+    size_t part = 0;   // bereits gesendete Bytes des Datensatzes next_seq
+
+    while (1) {
+        // Weit zurückliegend: vor dem Senden nach vorne springen (nur an Datensatzgrenze)
+        uint32_t lag = capture_head() - next_seq + 1;
+        if (part == 0 && (int32_t)lag > SINK_MAX_LAG) {
+            uint32_t skip_to = capture_head() - SINK_RESYNC_LAG + 1;
+            stats.lost += skip_to - next_seq;
+            next_seq = skip_to;
+        }
+
+        const capture_rec_t *span = NULL;
+        uint32_t span_seq = next_seq;
+        size_t n = capture_peek(&next_seq, &span, &stats.lost);
+        if (next_seq != span_seq && part != 0) {
+            // Mitten im Datensatz überholt: Stream nicht mehr konsistent
+            ESP_LOGW(TAG, "Ring während Teil-Write überholt -> Reconnect");
+            return;
+        }
+        stats.depth = (int32_t)lag > 0 ? lag : 0;
+        if (n == 0) {
+            vTaskDelay(pdMS_TO_TICKS(SINK_POLL_MS));
+            continue;
+        }
+
+        // Direkt aus dem Ring senden, kein Zwischenpuffer
+        size_t len = n * sizeof(capture_rec_t) - part;
+        int sent = send(sock, (const uint8_t *)span + part, len, 0);
+        if (sent < 0) {
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                continue;   // Sendepuffer voll, Timeout -> Rückstand prüfen und erneut
+            }
+            ESP_LOGW(TAG, "send fehlgeschlagen: errno %d", errno);
+            return;
+        }
+
+        // Wurde der Abschnitt während send() überschrieben, sind gesendete Daten evtl. inkonsistent
+        if (capture_lapped(next_seq)) {
+            ESP_LOGW(TAG, "Ring während send() überholt (seq=%lu) -> Reconnect", (unsigned long)next_seq);
+            return;
+        }
+
+        if ((size_t)sent < len) {
+            stats.partial++;
+        }
+        size_t total = part + sent;
+        next_seq += total / sizeof(capture_rec_t);
+        stats.sent += total / sizeof(capture_rec_t);
+        part = total % sizeof(capture_rec_t);
+    }
+}
+
+static void tcp_sink_task(void *arg)
+{
+    while (1) {
+        int sock = sink_open();
+        if (sock < 0) {
+            vTaskDelay(pdMS_TO_TICKS(SINK_RETRY_MS));
+            continue;
+        }
+        set_timeouts(sock);
+
+        uint32_t next_seq;
+        if (sink_handshake(sock, &next_seq)) {
+            stats.connects++;
+            stats.connected = true;
+            sink_stream(sock, next_seq);
+            stats.connected = false;
+        } else {
+            ESP_LOGW(TAG, "Handshake fehlgeschlagen");
+        }
+
+        shutdown(sock, SHUT_RDWR);
+        close(sock);
+        ESP_LOGI(TAG, "Verbindung getrennt (gesendet=%lu, verloren=%lu)",
+                 (unsigned long)stats.sent, (unsigned long)stats.lost);
+        vTaskDelay(pdMS_TO_TICKS(SINK_RETRY_MS));
+    }
+}
+#endif // TCP_SINK_MODE
+
+esp_err_t tcp_sink_init(void)
+{
+#if TCP_SINK_MODE
+    // Unterhalb der Proxy-Tasks (12), damit Netzwerklast den LIN-Pfad nicht verzögert
+    if (xTaskCreate(tcp_sink_task, "tcp_sink", 3072, NULL, 6, NULL) != pdPASS) {
+        return ESP_ERR_NO_MEM;
+    }
+#if TCP_SINK_MODE == 1
+    ESP_LOGI(TAG, "TCP-Sink aktiv -> %s:%d", TCP_SINK_HOST, TCP_SINK_PORT);
+#else
+    ESP_LOGI(TAG, "TCP-Sink aktiv, lauscht auf Port %d", TCP_SINK_PORT);
+#endif
+    return ESP_OK;
+#else
+    return ESP_ERR_NOT_SUPPORTED;
+#endif
+}
@@ -0,0 +1,44 @@
+#ifndef TCP_SINK_H
+#define TCP_SINK_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "esp_err.h"
+
+// TCP-Sink: streamt den Capture-Ring binär an einen Collector.
+//
+// Protokoll (Little Endian):
+//   Gerät -> Collector: Hello (16 Byte), siehe tcp_sink_hello_t
+//   Collector -> Gerät: u32 Start-Sequenz (0 = ältester Eintrag im Ring,
+//                       sonst letzte empfangene Sequenz + 1)
+//   Gerät -> Collector: fortlaufend capture_rec_t (32 Byte), direkt aus dem Ring
+// Lücken in seq sind Verluste (Ring überholt). Bricht die Verbindung ab,
+// setzt der Collector nach dem Reconnect an seiner letzten Sequenz fort.
+
+#define TCP_SINK_MAGIC   0x434E494C  // "LINC"
+#define TCP_SINK_VERSION 1
+
+typedef struct __attribute__((packed)) {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t rec_size;     // sizeof(capture_rec_t)
+    uint32_t ring_size;    // CAPTURE_RING_SIZE
+    uint32_t head;         // aktuelle Sequenz im Ring
+} tcp_sink_hello_t;
+
+typedef struct {
+    uint32_t connects;     // erfolgreiche Verbindungen
+    uint32_t sent;         // gesendete Datensätze
+    uint32_t lost;         // vom Ring überholt, bevor sie gesendet wurden
+    uint32_t partial;      // Teil-Writes (send() < angefordert)
+    uint32_t depth;        // aktueller Rückstand in Datensätzen
+    bool connected;
+} tcp_sink_stats_t;
+
+// Sink-Task starten (Modus/Ziel aus config.h)
+esp_err_t tcp_sink_init(void);
+
+// Zähler lesen
+void tcp_sink_get_stats(tcp_sink_stats_t *out);
+
+#endif // TCP_SINK_H
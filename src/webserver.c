@@ -1,10 +1,21 @@
 #include "webserver.h"
 #include "config.h"
 #include "ota.h"
+#include "log_filter.h"
+#include "proxy_config.h"
+#include "sysmon.h"
+#include "live.h"
+#include "lin_proxy.h"
+#include "network.h"
 #include "esp_log.h"
 #include "esp_http_server.h"
 #include "esp_ota_ops.h"
+#include "esp_timer.h"
+#include "esp_system.h"
+#include "lwip/sockets.h"
 #include <string.h>
+#include <strings.h>
+#include <stdlib.h>
 
 #ifndef MIN
 #define MIN(a,b) ((a) < (b) ? (a) : (b))
@@ -13,144 +24,331 @@
 static const char *TAG = "WEBSERVER";
 static httpd_handle_t server = NULL;
 
-// HTML-Seite für Web-Interface
-static const char* html_page = 
-"<!DOCTYPE html>"
-"<html><head><meta charset='UTF-8'><meta name='viewport' content='width=device-width,initial-scale=1'>"
-"<title>LIN Proxy</title>"
-"<style>"
-"body{font-family:Arial,sans-serif;margin:20px;background:#f0f0f0}"
-"h1{color:#333}.box{background:white;padding:20px;margin:10px 0;border-radius:5px;box-shadow:0 2px 5px rgba(0,0,0,0.1)}"
-".info{display:flex;justify-content:space-between;margin:10px 0}"
-"button{background:#007bff;color:white;border:none;padding:10px 20px;cursor:pointer;border-radius:3px;font-size:16px}"
-"button:hover{background:#0056b3}"
-".upload{margin:20px 0}"
-"input[type=file]{margin:10px 0}"
-".status{padding:10px;margin:10px 0;border-radius:3px}"
-".success{background:#d4edda;color:#155724;border:1px solid #c3e6cb}"
-".error{background:#f8d7da;color:#721c24;border:1px solid #f5c6cb}"
-"</style></head><body>"
-"<h1>🚗 LIN Proxy Control</h1>"
-"<div class='box'><h2>System Info</h2>"
-"<div class='info'><span>Firmware Version:</span><span id='version'>%s</span></div>"
-"<div class='info'><span>WiFi SSID:</span><span>" WIFI_SSID "</span></div>"
-"<div class='info'><span>AP SSID:</span><span>" AP_SSID "</span></div>"
-"</div>"
-"<div class='box'><h2>Firmware Update</h2>"
-"<div class='upload'>"
-"<input type='file' id='firmwareFile' accept='.bin'>"
-"<button onclick='uploadFirmware()'>Upload Firmware</button>"
-"</div>"
-"<button onclick='checkUpdate()'>Check for Updates</button>"
-"<div id='status'></div>"
-"</div>"
-"<div class='box'><h2>Actions</h2>"
-"<button onclick='reboot()'>Reboot ESP32</button>"
-"</div>"
-"<script>"
-"document.getElementById('version').textContent='%s';"
-"function showStatus(msg,isError){"
-"const s=document.getElementById('status');"
-"s.innerHTML='<div class=\"status '+(isError?'error':'success')+'\">'+msg+'</div>';}"
-"async function uploadFirmware(){"
-"const file=document.getElementById('firmwareFile').files[0];"
-"if(!file){showStatus('Bitte Datei auswählen',true);return;}"
-"showStatus('Uploading...',false);"
-"const formData=new FormData();formData.append('file',file);"
-"try{"
-"const r=await fetch('/upload',{method:'POST',body:formData});"
-"if(r.ok){showStatus('Update erfolgreich! Reboot...',false);setTimeout(()=>location.reload(),5000);}"
-"else{showStatus('Upload fehlgeschlagen',true);}"
-"}catch(e){showStatus('Fehler: '+e,true);}}"
-"async function checkUpdate(){"
-"showStatus('Prüfe Updates...',false);"
-"try{"
-"const r=await fetch('/check-update');"
-"const d=await r.json();"
-"if(d.available){showStatus('Neue Version verfügbar: '+d.version,false);}"
-"else{showStatus('Aktuelle Version ist aktuell',false);}"
-"}catch(e){showStatus('Check fehlgeschlagen',true);}}"
-"async function reboot(){"
-"if(confirm('ESP32 neu starten?')){"
-"await fetch('/reboot');showStatus('Rebooting...',false);}}"
-"</script></body></html>";
-
-// Handler: Hauptseite
-static esp_err_t root_handler(httpd_req_t *req)
-{
-    const char *version = ota_get_version();
-    // Allokation auf dem Heap, um Stack des HTTP-Tasks nicht zu überlaufen
-    char *response = (char *)calloc(1, 4096);
-    if (!response) {
-        httpd_resp_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR, "alloc fail");
-        return ESP_FAIL;
+// Web-Assets aus src/www, beim Build gzip-komprimiert in den Flash eingebettet (src/CMakeLists.txt)
+extern const uint8_t index_html_gz_start[] asm("_binary_index_html_gz_start");
+extern const uint8_t index_html_gz_end[]   asm("_binary_index_html_gz_end");
+extern const uint8_t live_html_gz_start[]  asm("_binary_live_html_gz_start");
+extern const uint8_t live_html_gz_end[]    asm("_binary_live_html_gz_end");
+
+typedef struct {
+    const char *uri;
+    const uint8_t *start;
+    const uint8_t *end;
+    const char *type;
+    char etag[20];          // "<16 Hex-Zeichen>" inkl. Anführungszeichen
+} web_asset_t;
+
+static web_asset_t web_assets[] = {
+    { "/",     index_html_gz_start, index_html_gz_end, "text/html" },
+    { "/live", live_html_gz_start,  live_html_gz_end,  "text/html" },
+};
+
+// Starker ETag: FNV-1a (64 Bit) über den komprimierten Inhalt, einmal beim Start berechnet
+static void web_asset_etag(web_asset_t *a)
+{
+    uint64_t h = 0xcbf29ce484222325ULL;
+    for (const uint8_t *p = a->start; p < a->end; p++) {
+        h = (h ^ *p) * 0x100000001b3ULL;
+    }
+    snprintf(a->etag, sizeof(a->etag), "\"%016llx\"", (unsigned long long)h);
+}
+
+// Handler: statisches Asset direkt aus dem Flash (kein Heap, kein Kopieren)
+static esp_err_t asset_handler(httpd_req_t *req)
+{
+    const web_asset_t *a = (const web_asset_t *)req->user_ctx;
+    char inm[sizeof(a->etag) + 8];
+
+    // Browser hat die aktuelle Version bereits: nur 304 ohne Body
+    if (httpd_req_get_hdr_value_str(req, "If-None-Match", inm, sizeof(inm)) == ESP_OK &&
+        strstr(inm, a->etag) != NULL) {
+        httpd_resp_set_status(req, "304 Not Modified");
+        httpd_resp_set_hdr(req, "ETag", a->etag);
+        return httpd_resp_send(req, NULL, 0);
     }
 
-    snprintf(response, 4096, html_page, version, version);
-    
-    httpd_resp_set_type(req, "text/html");
-    httpd_resp_send(req, response, strlen(response));
-    free(response);
-    return ESP_OK;
+    httpd_resp_set_type(req, a->type);
+    httpd_resp_set_hdr(req, "Content-Encoding", "gzip");
+    httpd_resp_set_hdr(req, "ETag", a->etag);
+    // Immer revalidieren: nach OTA ändert sich der ETag, die Seite wird sofort neu geladen
+    httpd_resp_set_hdr(req, "Cache-Control", "no-cache");
+    return httpd_resp_send(req, (const char *)a->start, a->end - a->start);
+}
+
+// Boot-Zeitpunkt in ms, -1 = noch nicht erreicht
+static long long boot_ms(int64_t us)
+{
+    return us ? (long long)(us / 1000) : -1;
+}
+
+// Handler: dynamische Werte für die Hauptseite als JSON
+static esp_err_t info_handler(httpd_req_t *req)
+{
+    // Boot-Phasen in ms seit Start der Firmware (-1 = noch nicht erreicht)
+    lin_proxy_boot_t boot;
+    lin_proxy_boot_get(&boot);
+
+    char json[384];
+    snprintf(json, sizeof(json),
+             "{\"version\":\"%s\",\"wifi_ssid\":\"%s\",\"ap_ssid\":\"%s\",\"ip\":\"%s\","
+             "\"uptime_s\":%lld,\"free_heap\":%lu,"
+             "\"boot_ms\":{\"proxy_ready\":%lld,\"first_frame\":%lld,\"network\":%lld,\"web\":%lld}}",
+             ota_get_version(), WIFI_SSID, AP_SSID, network_get_ip_string(),
+             (long long)(esp_timer_get_time() / 1000000),
+             (unsigned long)esp_get_free_heap_size(),
+             boot_ms(boot.proxy_ready_us), boot_ms(boot.first_frame_us),
+             boot_ms(boot.network_us), boot_ms(boot.web_us));
+
+    httpd_resp_set_type(req, "application/json");
+    httpd_resp_set_hdr(req, "Cache-Control", "no-store");
+    return httpd_resp_sendstr(req, json);
+}
+
+// Handler: Status des Streaming-Updates als JSON (Polling statt Log pro Block)
+static esp_err_t ota_status_handler(httpd_req_t *req)
+{
+    static const char *states[] = { "idle", "running", "done", "failed" };
+    ota_status_t st;
+    ota_get_status(&st);
+
+    uint32_t kbps = st.elapsed_ms ? (uint32_t)((uint64_t)st.received * 1000 / 1024 / st.elapsed_ms) : 0;
+    char json[448];
+    snprintf(json, sizeof(json),
+             "{\"state\":\"%s\",\"total\":%lu,\"received\":%lu,\"written\":%lu,\"compressed\":%s,"
+             "\"percent\":%d,\"elapsed_ms\":%lu,"
+             "\"kbps\":%lu,\"max_write_us\":%lu,\"paused_ms\":%lu,\"lin_p99_us\":%lu,\"lin_max_us\":%lu,"
+             "\"sha256\":\"%s\",\"sha_checked\":%s,\"error\":\"%s\"}",
+             states[st.state], (unsigned long)st.total, (unsigned long)st.received,
+             (unsigned long)st.written, st.compressed ? "true" : "false",
+             st.total ? (int)((uint64_t)st.received * 100 / st.total) : 0,
+             (unsigned long)st.elapsed_ms, (unsigned long)kbps, (unsigned long)st.max_write_us,
+             (unsigned long)st.paused_ms, (unsigned long)st.lin_p99_us, (unsigned long)st.lin_max_us,
+             st.sha256, st.sha_checked ? "true" : "false", st.error);
+
+    httpd_resp_set_type(req, "application/json");
+    httpd_resp_set_hdr(req, "Cache-Control", "no-store");
+    return httpd_resp_sendstr(req, json);
+}
+
+// Handler: Latenz-Histogramm ID->Header (?reset=1 setzt zurück)
+static esp_err_t lin_latency_handler(httpd_req_t *req)
+{
+    lin_latency_hist_t h;
+    lin_proxy_latency_get(&h);
+
+    char json[640];
+    int n = snprintf(json, sizeof(json),
+                     "{\"frames\":%lu,\"p50_us\":%lu,\"p99_us\":%lu,\"max_us\":%lu,\"budget_us\":%d,\"buckets\":[",
+                     (unsigned long)h.total, (unsigned long)lin_proxy_latency_percentile(&h, 50),
+                     (unsigned long)lin_proxy_latency_percentile(&h, 99), (unsigned long)h.max_us,
+                     LIN_LATENCY_BUDGET_US);
+    for (int i = 0; i < LIN_LAT_BUCKETS && n < (int)sizeof(json); i++) {
+        uint32_t edge = lin_proxy_latency_edge(i);
+        if (edge == UINT32_MAX) {
+            n += snprintf(json + n, sizeof(json) - n, "%s{\"le\":null,\"n\":%lu}",
+                          i ? "," : "", (unsigned long)h.count[i]);
+        } else {
+            n += snprintf(json + n, sizeof(json) - n, "%s{\"le\":%lu,\"n\":%lu}",
+                          i ? "," : "", (unsigned long)edge, (unsigned long)h.count[i]);
+        }
+    }
+    if (n < (int)sizeof(json)) {
+        snprintf(json + n, sizeof(json) - n, "]}");
+    }
+
+    char query[32], val[4];
+    if (httpd_req_get_url_query_str(req, query, sizeof(query)) == ESP_OK &&
+        httpd_query_key_value(query, "reset", val, sizeof(val)) == ESP_OK && val[0] == '1') {
+        lin_proxy_latency_reset();
+    }
+
+    httpd_resp_set_type(req, "application/json");
+    httpd_resp_set_hdr(req, "Cache-Control", "no-store");
+    return httpd_resp_sendstr(req, json);
+}
+
+// uint16-Werte eines Messwerts als JSON-Array, SYSMON_NONE -> null.
+// Liefert die Länge oder -1, wenn das Array nicht vollständig in len passt.
+static int sysmon_json_u16(char *buf, size_t len, const char *key, const uint16_t *v, int n)
+{
+    int off = snprintf(buf, len, ",\"%s\":[", key);
+    for (int i = 0; i < n && off < (int)len; i++) {
+        if (v[i] == SYSMON_NONE) {
+            off += snprintf(buf + off, len - off, "%snull", i ? "," : "");
+        } else {
+            off += snprintf(buf + off, len - off, "%s%u", i ? "," : "", v[i]);
+        }
+    }
+    if (off < (int)len) off += snprintf(buf + off, len - off, "]");
+    return off < (int)len ? off : -1;
+}
+
+// Handler: Systemmonitor
+// GET /api/sysmon            letzte Messung mit Task- und Queue-Tabelle
+// GET /api/sysmon?history=1  alle Messungen im Verlauf (Spalten = Tasks)
+static esp_err_t sysmon_handler(httpd_req_t *req)
+{
+    static sysmon_task_info_t tasks[SYSMON_MAX_TASKS];  // nur im HTTP-Task benutzt
+    sysmon_queue_info_t queues[SYSMON_MAX_QUEUES];
+    sysmon_sample_t smp;
+    char buf[768];
+
+    int nt = sysmon_get_tasks(tasks, SYSMON_MAX_TASKS);
+    int nq = sysmon_get_queues(queues, SYSMON_MAX_QUEUES);
+    int count = sysmon_history_count();
+
+    char query[32], val[4];
+    bool history = httpd_req_get_url_query_str(req, query, sizeof(query)) == ESP_OK &&
+                   httpd_query_key_value(query, "history", val, sizeof(val)) == ESP_OK && val[0] == '1';
+
+    httpd_resp_set_type(req, "application/json");
+    httpd_resp_set_hdr(req, "Cache-Control", "no-store");
+
+    if (count == 0 || !sysmon_history_get(count - 1, &smp)) {
+        return httpd_resp_sendstr(req, "{\"samples\":0}");
+    }
+
+    if (!history) {
+        int off = snprintf(buf, sizeof(buf),
+                           "{\"t_ms\":%lu,\"interval_ms\":%d,\"heap\":{\"free\":%lu,\"min_free\":%lu,\"largest\":%lu},"
+                           "\"core_load\":[%u,%u],\"untracked\":%lu,\"tasks\":[",
+                           (unsigned long)smp.t_ms, SYSMON_INTERVAL_MS, (unsigned long)smp.heap_free,
+                           (unsigned long)smp.heap_min, (unsigned long)smp.heap_largest,
+                           smp.core_load[0], smp.core_load[1], (unsigned long)sysmon_untracked_tasks());
+        httpd_resp_send_chunk(req, buf, off);
+
+        bool first = true;
+        for (int i = 0; i < nt; i++) {
+            if (!tasks[i].alive) continue;
+            off = snprintf(buf, sizeof(buf),
+                           "%s{\"name\":\"%s\",\"prio\":%u,\"core\":%d,\"cpu_pm\":%u,\"stack_free\":%u}",
+                           first ? "" : ",", tasks[i].name, tasks[i].prio, tasks[i].core,
+                           smp.cpu_pm[i] == SYSMON_NONE ? 0 : smp.cpu_pm[i], smp.stack_free[i]);
+            httpd_resp_send_chunk(req, buf, off);
+            first = false;
+        }
+
+        httpd_resp_send_chunk(req, "],\"queues\":[", HTTPD_RESP_USE_STRLEN);
+        for (int i = 0; i < nq; i++) {
+            off = snprintf(buf, sizeof(buf),
+                           "%s{\"name\":\"%s\",\"size\":%u,\"depth\":%u,\"peak\":%u,\"rx_bytes\":%u}",
+                           i ? "," : "", queues[i].name, queues[i].size, smp.q_depth[i],
+                           queues[i].peak, smp.q_rx[i]);
+            httpd_resp_send_chunk(req, buf, off);
+        }
+        httpd_resp_send_chunk(req, "]}", 2);
+        return httpd_resp_send_chunk(req, NULL, 0);
+    }
+
+    // Verlauf: Spaltenköpfe, dann eine Zeile pro Messung.
+    // Namen einzeln senden, die Anzahl hängt von SYSMON_MAX_TASKS ab.
+    int off = snprintf(buf, sizeof(buf), "{\"interval_ms\":%d,\"tasks\":[", SYSMON_INTERVAL_MS);
+    httpd_resp_send_chunk(req, buf, off);
+    for (int i = 0; i < nt; i++) {
+        off = snprintf(buf, sizeof(buf), "%s\"%s\"", i ? "," : "", tasks[i].name);
+        httpd_resp_send_chunk(req, buf, off);
+    }
+    httpd_resp_send_chunk(req, "],\"queues\":[", HTTPD_RESP_USE_STRLEN);
+    for (int i = 0; i < nq; i++) {
+        off = snprintf(buf, sizeof(buf), "%s\"%s\"", i ? "," : "", queues[i].name);
+        httpd_resp_send_chunk(req, buf, off);
+    }
+    httpd_resp_send_chunk(req, "],\"samples\":[", HTTPD_RESP_USE_STRLEN);
+
+    for (int k = 0; k < count; k++) {
+        if (!sysmon_history_get(k, &smp)) break;
+        uint16_t depth[SYSMON_MAX_QUEUES];
+        for (int i = 0; i < nq; i++) depth[i] = smp.q_depth[i];
+
+        off = snprintf(buf, sizeof(buf), "%s{\"t_ms\":%lu,\"heap\":[%lu,%lu,%lu],\"load\":[%u,%u]",
+                       k ? "," : "", (unsigned long)smp.t_ms, (unsigned long)smp.heap_free,
+                       (unsigned long)smp.heap_min, (unsigned long)smp.heap_largest,
+                       smp.core_load[0], smp.core_load[1]);
+        // Die Arrays brauchen bis zu 2 * (SYSMON_MAX_TASKS + SYSMON_MAX_QUEUES) Zahlen. Passen sie nicht in buf,
+        // geht die Zeile ohne sie raus, "}" bleibt immer frei.
+        int head = off;
+        int n = sysmon_json_u16(buf + off, sizeof(buf) - 1 - off, "cpu_pm", smp.cpu_pm, nt);
+        if (n >= 0) {
+            off += n;
+            n = sysmon_json_u16(buf + off, sizeof(buf) - 1 - off, "stack_free", smp.stack_free, nt);
+        }
+        if (n >= 0) {
+            off += n;
+            n = sysmon_json_u16(buf + off, sizeof(buf) - 1 - off, "q_depth", depth, nq);
+        }
+        if (n >= 0) {
+            off += n;
+            n = sysmon_json_u16(buf + off, sizeof(buf) - 1 - off, "rx_bytes", smp.q_rx, nq);
+        }
+        if (n >= 0) {
+            off += n;
+        } else {
+            off = head + snprintf(buf + head, sizeof(buf) - 1 - head, ",\"truncated\":true");
+        }
+        off += snprintf(buf + off, sizeof(buf) - off, "}");
+        httpd_resp_send_chunk(req, buf, off);
+    }
+
+    httpd_resp_send_chunk(req, "]}", 2);
+    return httpd_resp_send_chunk(req, NULL, 0);
 }
 
-// Handler: Firmware-Upload
+// Handler: Firmware-Upload (Rohdaten im Body, optional SHA-256 per
+// Header "X-SHA256" oder ?sha256=<hex>)
 static esp_err_t upload_handler(httpd_req_t *req)
 {
-    esp_ota_handle_t ota_handle;
-    const esp_partition_t *update_partition = esp_ota_get_next_update_partition(NULL);
-    
-    if (!update_partition) {
-        httpd_resp_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR, "No OTA partition");
-        return ESP_FAIL;
+    char sha_hex[72] = {0};
+    if (httpd_req_get_hdr_value_str(req, "X-SHA256", sha_hex, sizeof(sha_hex)) != ESP_OK) {
+        char query[96];
+        if (httpd_req_get_url_query_str(req, query, sizeof(query)) != ESP_OK ||
+            httpd_query_key_value(query, "sha256", sha_hex, sizeof(sha_hex)) != ESP_OK) {
+            sha_hex[0] = '\0';
+        }
     }
-    
-    ESP_LOGI(TAG, "Starting OTA to partition: %s", update_partition->label);
-    
-    esp_err_t err = esp_ota_begin(update_partition, OTA_SIZE_UNKNOWN, &ota_handle);
+
+    ota_stream_t *ota;
+    esp_err_t err = ota_stream_begin(req->content_len, sha_hex, &ota);
     if (err != ESP_OK) {
-        httpd_resp_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR, "OTA begin failed");
+        httpd_resp_send_err(req, err == ESP_ERR_INVALID_ARG ? HTTPD_400_BAD_REQUEST : HTTPD_500_INTERNAL_SERVER_ERROR,
+                            err == ESP_ERR_INVALID_ARG ? "Invalid SHA-256" : "OTA begin failed");
         return ESP_FAIL;
     }
-    
-    char buf[1024];
+
+    size_t cap;
+    uint8_t *buf = ota_stream_buf(ota, &cap);
     int remaining = req->content_len;
-    int received = 0;
-    
+
     while (remaining > 0) {
-        int recv_len = httpd_req_recv(req, buf, MIN(remaining, sizeof(buf)));
-        if (recv_len <= 0) {
-            if (recv_len == HTTPD_SOCK_ERR_TIMEOUT) continue;
-            esp_ota_abort(ota_handle);
-            httpd_resp_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR, "Upload failed");
-            return ESP_FAIL;
+        // Puffer vollständig füllen, damit der Flash in großen Blöcken geschrieben wird
+        size_t fill = 0;
+        while (fill < cap && remaining > 0) {
+            int recv_len = httpd_req_recv(req, (char *)buf + fill, MIN((size_t)remaining, cap - fill));
+            if (recv_len <= 0) {
+                if (recv_len == HTTPD_SOCK_ERR_TIMEOUT) continue;
+                ota_stream_abort(ota, "Upload abgebrochen");
+                httpd_resp_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR, "Upload failed");
+                return ESP_FAIL;
+            }
+            fill += recv_len;
+            remaining -= recv_len;
         }
-        
-        err = esp_ota_write(ota_handle, buf, recv_len);
-        if (err != ESP_OK) {
-            esp_ota_abort(ota_handle);
+
+        if (ota_stream_commit(ota, fill) != ESP_OK) {
+            ota_stream_abort(ota, "Flash-Schreibfehler");
             httpd_resp_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR, "OTA write failed");
             return ESP_FAIL;
         }
-        
-        received += recv_len;
-        remaining -= recv_len;
-        ESP_LOGI(TAG, "OTA Progress: %d%%", (received * 100) / req->content_len);
-    }
-    
-    err = esp_ota_end(ota_handle);
-    if (err != ESP_OK) {
-        httpd_resp_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR, "OTA end failed");
-        return ESP_FAIL;
     }
-    
-    err = esp_ota_set_boot_partition(update_partition);
+
+    err = ota_stream_finish(ota);
     if (err != ESP_OK) {
-        httpd_resp_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR, "Set boot partition failed");
+        httpd_resp_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR,
+                            err == ESP_ERR_INVALID_CRC ? "SHA-256 mismatch" : "OTA end failed");
         return ESP_FAIL;
     }
     
-    httpd_resp_sendstr(req, "OK");
+    // Antwort mit Durchsatz und berechnetem SHA-256
+    ota_status_handler(req);
     
     ESP_LOGI(TAG, "OTA Success! Rebooting...");
     vTaskDelay(pdMS_TO_TICKS(1000));
@@ -173,6 +371,218 @@ static esp_err_t check_update_handler(httpd_req_t *req)
     return ESP_OK;
 }
 
+// Handler: Log-Filter lesen
+static esp_err_t log_filter_get_handler(httpd_req_t *req)
+{
+    // 2 Links x 4 Schweregrade x ~30 Zeichen
+    char json[512];
+    int off = snprintf(json, sizeof(json), "{");
+
+    for (int l = 0; l < LOG_LINK_COUNT; l++) {
+        off += snprintf(json + off, sizeof(json) - off, "%s\"%s\":{",
+                        l ? "," : "", log_filter_link_name(l));
+        for (int sev = 0; sev < LOG_SEV_COUNT; sev++) {
+            off += snprintf(json + off, sizeof(json) - off, "%s\"%s\":\"%016llX\"",
+                            sev ? "," : "", log_filter_sev_name(sev), log_filter_get(l, sev));
+        }
+        off += snprintf(json + off, sizeof(json) - off, "}");
+    }
+    snprintf(json + off, sizeof(json) - off, "}");
+
+    httpd_resp_set_type(req, "application/json");
+    httpd_resp_sendstr(req, json);
+    return ESP_OK;
+}
+
+// Handler: Log-Filter setzen
+// POST /api/log-filter?link=LIN1|LIN2|all&sev=error|warn|info|debug|all&mask=<hex64>
+// POST /api/log-filter?link=...&sev=...&pids=0x18,0x3C
+// POST /api/log-filter?reset=1
+static esp_err_t log_filter_set_handler(httpd_req_t *req)
+{
+    char query[192];
+    char val[128];
+
+    if (httpd_req_get_url_query_str(req, query, sizeof(query)) != ESP_OK) {
+        httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "Query fehlt");
+        return ESP_FAIL;
+    }
+
+    if (httpd_query_key_value(query, "reset", val, sizeof(val)) == ESP_OK && atoi(val) == 1) {
+        log_filter_reset();
+        return log_filter_get_handler(req);
+    }
+
+    // Link-Auswahl
+    int link_from = 0, link_to = LOG_LINK_COUNT - 1;
+    if (httpd_query_key_value(query, "link", val, sizeof(val)) == ESP_OK && strcasecmp(val, "all") != 0) {
+        int found = -1;
+        for (int l = 0; l < LOG_LINK_COUNT; l++) {
+            if (strcasecmp(val, log_filter_link_name(l)) == 0) found = l;
+        }
+        if (found < 0) {
+            httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "Unbekannter link");
+            return ESP_FAIL;
+        }
+        link_from = link_to = found;
+    }
+
+    // Schweregrad-Auswahl
+    int sev_from = 0, sev_to = LOG_SEV_COUNT - 1;
+    if (httpd_query_key_value(query, "sev", val, sizeof(val)) == ESP_OK && strcasecmp(val, "all") != 0) {
+        int found = -1;
+        for (int sev = 0; sev < LOG_SEV_COUNT; sev++) {
+            if (strcasecmp(val, log_filter_sev_name(sev)) == 0) found = sev;
+        }
+        if (found < 0) {
+            httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "Unbekannter sev");
+            return ESP_FAIL;
+        }
+        sev_from = sev_to = found;
+    }
+
+    // Neue PID-Maske
+    uint64_t mask = 0;
+    if (httpd_query_key_value(query, "mask", val, sizeof(val)) == ESP_OK) {
+        char *end = NULL;
+        mask = strtoull(val, &end, 16);
+        if (end == val || *end != '\0') {
+            httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "mask ungültig");
+            return ESP_FAIL;
+        }
+    } else if (httpd_query_key_value(query, "pids", val, sizeof(val)) == ESP_OK) {
+        if (!log_filter_parse_pids(val, &mask)) {
+            httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "pids ungültig");
+            return ESP_FAIL;
+        }
+    } else {
+        httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "mask oder pids fehlt");
+        return ESP_FAIL;
+    }
+
+    for (int l = link_from; l <= link_to; l++) {
+        for (int sev = sev_from; sev <= sev_to; sev++) {
+            log_filter_set(l, sev, mask);
+        }
+    }
+
+    if (log_filter_save() != ESP_OK) {
+        httpd_resp_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR, "Speichern fehlgeschlagen");
+        return ESP_FAIL;
+    }
+
+    return log_filter_get_handler(req);
+}
+
+// Handler: Proxy-Konfiguration lesen
+static esp_err_t config_get_handler(httpd_req_t *req)
+{
+    const proxy_config_t *cfg = proxy_config_get();
+    char json[768];
+    char val[16], def[16];
+    int n = snprintf(json, sizeof(json), "{\"gen\":%lu,\"restart_pending\":%s,\"params\":{",
+                     (unsigned long)cfg->gen, proxy_config_restart_pending() ? "true" : "false");
+
+    for (int i = 0; i < proxy_config_param_count() && n < (int)sizeof(json); i++) {
+        const proxy_config_param_t *p = proxy_config_param(i);
+        n += snprintf(json + n, sizeof(json) - n,
+                      "%s\"%s\":{\"value\":%s,\"default\":%s,\"min\":%lu,\"max\":%lu,\"restart\":%s}",
+                      i ? "," : "", p->name,
+                      proxy_config_format(p, proxy_config_value(cfg, p), val, sizeof(val)),
+                      proxy_config_format(p, p->def, def, sizeof(def)),
+                      (unsigned long)p->min, (unsigned long)p->max, p->restart ? "true" : "false");
+    }
+    if (n < (int)sizeof(json)) {
+        snprintf(json + n, sizeof(json) - n, "}}");
+    }
+
+    httpd_resp_set_type(req, "application/json");
+    httpd_resp_set_hdr(req, "Cache-Control", "no-store");
+    return httpd_resp_sendstr(req, json);
+}
+
+// Handler: Proxy-Konfiguration ändern
+// PUT /api/config?break_us=1600&sync_max_us=800   (alle Werte gemeinsam, ab dem nächsten Frame)
+// PUT /api/config?master_link=LIN2&persist=0      (nur bis zum Neustart)
+// PUT /api/config?reset=1
+// Parameter im Query-String oder als application/x-www-form-urlencoded-Body
+static esp_err_t config_put_handler(httpd_req_t *req)
+{
+    char args[256];
+    int len = 0;
+
+    if (req->content_len > 0) {
+        if (req->content_len >= sizeof(args)) {
+            httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "Body zu lang");
+            return ESP_FAIL;
+        }
+        while (len < (int)req->content_len) {
+            int r = httpd_req_recv(req, args + len, req->content_len - len);
+            if (r <= 0) {
+                if (r == HTTPD_SOCK_ERR_TIMEOUT) continue;
+                return ESP_FAIL;
+            }
+            len += r;
+        }
+        args[len] = '\0';
+    } else if (httpd_req_get_url_query_str(req, args, sizeof(args)) != ESP_OK) {
+        httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "Parameter fehlen");
+        return ESP_FAIL;
+    }
+
+    char val[16];
+    if (httpd_query_key_value(args, "reset", val, sizeof(val)) == ESP_OK && atoi(val) == 1) {
+        if (proxy_config_reset() != ESP_OK) {
+            httpd_resp_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR, "Zurücksetzen fehlgeschlagen");
+            return ESP_FAIL;
+        }
+        return config_get_handler(req);
+    }
+
+    bool persist = true;
+    if (httpd_query_key_value(args, "persist", val, sizeof(val)) == ESP_OK) {
+        persist = atoi(val) != 0;
+    }
+
+    // Entwurf auf Basis des aktiven Snapshots; erst wenn alle Werte gültig sind, übernehmen
+    proxy_config_t draft = *proxy_config_get();
+    int changed = 0;
+    char *save = NULL;
+    for (char *tok = strtok_r(args, "&", &save); tok; tok = strtok_r(NULL, "&", &save)) {
+        char *eq = strchr(tok, '=');
+        if (!eq) continue;
+        *eq = '\0';
+        if (strcmp(tok, "persist") == 0) continue;
+
+        const proxy_config_param_t *p = proxy_config_find(tok);
+        if (!p) {
+            char msg[48];
+            snprintf(msg, sizeof(msg), "Unbekannter Parameter %.24s", tok);
+            httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, msg);
+            return ESP_FAIL;
+        }
+        if (proxy_config_parse(&draft, p, eq + 1) != ESP_OK) {
+            char msg[80];
+            snprintf(msg, sizeof(msg), "%s ungültig (%lu..%lu)", p->name,
+                     (unsigned long)p->min, (unsigned long)p->max);
+            httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, msg);
+            return ESP_FAIL;
+        }
+        changed++;
+    }
+    if (changed == 0) {
+        httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "Kein Parameter angegeben");
+        return ESP_FAIL;
+    }
+
+    if (proxy_config_apply(&draft, persist) != ESP_OK) {
+        httpd_resp_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR, "Speichern fehlgeschlagen");
+        return ESP_FAIL;
+    }
+
+    return config_get_handler(req);
+}
+
 // Handler: Reboot
 static esp_err_t reboot_handler(httpd_req_t *req)
 {
@@ -182,24 +592,43 @@ static esp_err_t reboot_handler(httpd_req_t *req)
     return ESP_OK;
 }
 
+// Session-Ende: Live-Clients austragen, danach Socket schließen (Pflicht bei eigenem close_fn)
+static void session_close(httpd_handle_t hd, int sockfd)
+{
+    live_session_closed(sockfd);
+    close(sockfd);
+}
+
 esp_err_t webserver_init(void)
 {
 #if WEB_SERVER_ENABLED
     httpd_config_t config = HTTPD_DEFAULT_CONFIG();
     config.server_port = WEB_SERVER_PORT;
-    config.max_uri_handlers = 8;
-    // Erhöhte Stack-Größe, da Handler JSON/HTML generieren
+    config.max_uri_handlers = 16;
+    // Erhöhte Stack-Größe, da Handler JSON generieren
     config.stack_size = 6144;
+    config.close_fn = session_close;
     
     ESP_LOGI(TAG, "Starte HTTP-Server auf Port %d", WEB_SERVER_PORT);
     
     if (httpd_start(&server, &config) == ESP_OK) {
-        httpd_uri_t root = {
-            .uri = "/",
+        for (size_t i = 0; i < sizeof(web_assets) / sizeof(web_assets[0]); i++) {
+            web_asset_etag(&web_assets[i]);
+            httpd_uri_t asset = {
+                .uri = web_assets[i].uri,
+                .method = HTTP_GET,
+                .handler = asset_handler,
+                .user_ctx = &web_assets[i],
+            };
+            httpd_register_uri_handler(server, &asset);
+        }
+        
+        httpd_uri_t info = {
+            .uri = "/api/info",
             .method = HTTP_GET,
-            .handler = root_handler,
+            .handler = info_handler,
         };
-        httpd_register_uri_handler(server, &root);
+        httpd_register_uri_handler(server, &info);
         
         httpd_uri_t upload = {
             .uri = "/upload",
@@ -208,6 +637,27 @@ esp_err_t webserver_init(void)
         };
         httpd_register_uri_handler(server, &upload);
         
+        httpd_uri_t ota_status = {
+            .uri = "/api/ota/status",
+            .method = HTTP_GET,
+            .handler = ota_status_handler,
+        };
+        httpd_register_uri_handler(server, &ota_status);
+        
+        httpd_uri_t latency = {
+            .uri = "/api/lin/latency",
+            .method = HTTP_GET,
+            .handler = lin_latency_handler,
+        };
+        httpd_register_uri_handler(server, &latency);
+        
+        httpd_uri_t sysmon = {
+            .uri = "/api/sysmon",
+            .method = HTTP_GET,
+            .handler = sysmon_handler,
+        };
+        httpd_register_uri_handler(server, &sysmon);
+        
         httpd_uri_t check = {
             .uri = "/check-update",
             .method = HTTP_GET,
@@ -222,6 +672,36 @@ esp_err_t webserver_init(void)
         };
         httpd_register_uri_handler(server, &reboot);
         
+        httpd_uri_t filter_get = {
+            .uri = "/api/log-filter",
+            .method = HTTP_GET,
+            .handler = log_filter_get_handler,
+        };
+        httpd_register_uri_handler(server, &filter_get);
+        
+        httpd_uri_t filter_set = {
+            .uri = "/api/log-filter",
+            .method = HTTP_POST,
+            .handler = log_filter_set_handler,
+        };
+        httpd_register_uri_handler(server, &filter_set);
+        
+        httpd_uri_t config_get = {
+            .uri = "/api/config",
+            .method = HTTP_GET,
+            .handler = config_get_handler,
+        };
+        httpd_register_uri_handler(server, &config_get);
+        
+        httpd_uri_t config_put = {
+            .uri = "/api/config",
+            .method = HTTP_PUT,
+            .handler = config_put_handler,
+        };
+        httpd_register_uri_handler(server, &config_put);
+        
+        live_register(server);
+        
         ESP_LOGI(TAG, "Web-Interface verfügbar unter http://<IP>:%d", WEB_SERVER_PORT);
         return ESP_OK;
     }
@@ -2,12 +2,32 @@
 """
 Einfacher Syslog-Server für LIN-Proxy
 Empfängt UDP-Syslog-Nachrichten auf Port 514 und schreibt sie in eine Datei.
+
+Modi:
+  (ohne)   Live-Modus: jede Zeile auf Konsole und in lin_proxy_syslog.log
+  collect  Collector für mehrere Geräte: gebündeltes Schreiben, Rotation,
+           ein Stream pro Gerät, Index-Datei je Segment
+  query    Alle Zeilen einer PID in einem Zeitraum über den Index abfragen
+
+Nachrichten im RFC-5424-Format werden zerlegt und pro Gerät (HOSTNAME)
+ausgewertet:
+  - One-Way-Delay:  Empfangszeit Host minus Wall-Clock-Zeitstempel des Geräts
+                    (nur aussagekräftig, wenn beide Seiten per NTP synchron sind)
+  - Verlust/Reorder: Lücken und Rücksprünge in meta/sequenceId
+  - Jitter:          Abweichung der Empfangsabstände von den mono_us-Abständen
+Nachrichten im alten Format (reiner Text) werden unverändert protokolliert.
 """
 
-import socket
+import argparse
+import bisect
 import datetime
-import sys
+import json
 import os
+import re
+import socket
+import struct
+import sys
+import time
 from pathlib import Path
 
 # Konfiguration
@@ -15,55 +35,621 @@ SYSLOG_PORT = 514
 SYSLOG_HOST = "0.0.0.0"  # Lauscht auf allen Interfaces
 LOG_FILE = "lin_proxy_syslog.log"
 MAX_PACKET_SIZE = 4096
+STATS_INTERVAL = 60      # Sekunden zwischen Statistik-Ausgaben
+SEQ_MAX = 2147483647     # meta/sequenceId läuft danach auf 1
 
-def main():
-    # Log-Datei öffnen (append mode)
-    log_path = Path(LOG_FILE)
-    print(f"Syslog-Server gestartet")
-    print(f"Lauscht auf {SYSLOG_HOST}:{SYSLOG_PORT}")
-    print(f"Schreibt in: {log_path.absolute()}")
-    print(f"Drücke Ctrl+C zum Beenden\n")
-    
+# Collector-Modus
+COLLECT_DIR = "syslog"
+FLUSH_INTERVAL = 0.5            # Sekunden zwischen Batch-Schreibvorgängen
+FLUSH_LINES = 2000              # oder sobald so viele Zeilen anstehen
+ROTATE_BYTES = 64 * 1024 * 1024 # Segmentgröße
+ROTATE_SECONDS = 3600           # Segmentalter
+RCVBUF_BYTES = 4 * 1024 * 1024  # Kernel-Empfangspuffer gegen Verlust bei Lastspitzen
+
+# Index-Eintrag pro Logzeile: Empfangszeit, Offset im Segment, PID (0xFF = keine)
+INDEX_REC = struct.Struct('<dQB')
+NO_PID = 0xFF
+# Eintrag im PID-Index (eine Datei pro PID und Segment): Empfangszeit, Offset im Segment
+PID_REC = struct.Struct('<dQ')
+
+SEVERITY_NAMES = ["emerg", "alert", "crit", "error", "warn", "notice", "info", "debug"]
+
+# <PRI>1 TIMESTAMP HOSTNAME APP-NAME PROCID MSGID STRUCTURED-DATA [MSG]
+RFC5424_RE = re.compile(
+    r'^<(?P<pri>\d{1,3})>1 (?P<ts>\S+) (?P<host>\S+) (?P<app>\S+) (?P<procid>\S+) (?P<msgid>\S+) '
+    r'(?P<sd>-|(?:\[[^\]]*\])+)(?: (?P<msg>.*))?$', re.DOTALL)
+SD_ELEMENT_RE = re.compile(r'\[(?P<id>[^\s\]]+)(?P<params>[^\]]*)\]')
+SD_PARAM_RE = re.compile(r'(?P<name>[^\s=]+)="(?P<value>(?:[^"\\]|\\.)*)"')
+
+
+def parse_rfc5424(message):
+    """Zerlegt eine RFC-5424-Nachricht, None bei altem Format."""
+    m = RFC5424_RE.match(message)
+    if not m:
+        return None
+
+    pri = int(m.group('pri'))
+    sd = {}
+    if m.group('sd') != '-':
+        for el in SD_ELEMENT_RE.finditer(m.group('sd')):
+            sd[el.group('id')] = {p.group('name'): p.group('value')
+                                  for p in SD_PARAM_RE.finditer(el.group('params'))}
+
+    msg = m.group('msg') or ''
+    if msg.startswith('\ufeff'):
+        msg = msg[1:]
+
+    return {
+        'facility': pri >> 3,
+        'severity': pri & 7,
+        'timestamp': m.group('ts'),
+        'host': m.group('host'),
+        'app': m.group('app'),
+        'msgid': m.group('msgid'),
+        'sd': sd,
+        'msg': msg,
+    }
+
+
+def parse_timestamp(ts):
+    """RFC-3339-Zeitstempel -> Unix-Zeit (float), None bei '-'."""
+    if ts == '-':
+        return None
+    try:
+        return datetime.datetime.fromisoformat(ts.replace('Z', '+00:00')).timestamp()
+    except ValueError:
+        return None
+
+
+def sd_param(rec, name):
+    """Parameter aus beliebigem SD-Element holen."""
+    for params in rec['sd'].values():
+        if name in params:
+            return params[name]
+    return None
+
+
+class DeviceStats:
+    """Laufende Statistik je Gerät (Welford für Mittelwert/Streuung)."""
+
+    def __init__(self):
+        self.received = 0
+        self.lost = 0
+        self.reordered = 0
+        self.duplicates = 0
+        self.highest_seq = None
+        self.owd = RunningStat()
+        self.jitter_us = 0.0          # RFC-3550-Glättung (1/16)
+        self.last_rx = None
+        self.last_mono = None
+
+    def update(self, rec, rx_time):
+        self.received += 1
+
+        seq = sd_param(rec, 'sequenceId')
+        if seq is not None and seq.isdigit():
+            self._update_seq(int(seq))
+
+        # One-Way-Delay nur bei synchronisierter Geräteuhr
+        dev_time = parse_timestamp(rec['timestamp'])
+        if dev_time is not None and sd_param(rec, 'isSynced') != '0':
+            self.owd.add((rx_time - dev_time) * 1000.0)
+
+        mono = sd_param(rec, 'mono_us')
+        if mono is not None and mono.lstrip('-').isdigit():
+            mono = int(mono)
+            if self.last_mono is not None and mono > self.last_mono:
+                d = abs((rx_time - self.last_rx) * 1e6 - (mono - self.last_mono))
+                self.jitter_us += (d - self.jitter_us) / 16.0
+            if self.last_mono is None or mono > self.last_mono:
+                self.last_mono = mono
+                self.last_rx = rx_time
+            elif mono < self.last_mono - 10_000_000:
+                # Gerät neu gestartet
+                self.last_mono = mono
+                self.last_rx = rx_time
+
+    def _update_seq(self, seq):
+        if self.highest_seq is None:
+            self.highest_seq = seq
+            return
+        diff = (seq - self.highest_seq) % SEQ_MAX
+        if diff == 0:
+            self.duplicates += 1
+        elif diff < SEQ_MAX // 2:
+            self.lost += diff - 1
+            self.highest_seq = seq
+        elif seq < 16:
+            # Neustart des Geräts: Zähler beginnt wieder bei 1
+            self.highest_seq = seq
+        else:
+            # Verspätetes Paket, bereits als verloren gezählt
+            self.reordered += 1
+            self.lost = max(0, self.lost - 1)
+
+    def summary(self):
+        total = self.received + self.lost
+        loss = 100.0 * self.lost / total if total else 0.0
+        s = (f"empfangen={self.received} verloren={self.lost} ({loss:.2f}%) "
+             f"reorder={self.reordered} dup={self.duplicates} jitter={self.jitter_us:.0f}µs")
+        if self.owd.n:
+            s += (f" owd={self.owd.mean:.1f}ms (min {self.owd.min:.1f}, "
+                  f"max {self.owd.max:.1f}, σ {self.owd.stddev:.1f})")
+        else:
+            s += " owd=n/a (Gerät nicht synchronisiert)"
+        return s
+
+
+class RunningStat:
+    def __init__(self):
+        self.n = 0
+        self.mean = 0.0
+        self.m2 = 0.0
+        self.min = float('inf')
+        self.max = float('-inf')
+
+    def add(self, x):
+        self.n += 1
+        d = x - self.mean
+        self.mean += d / self.n
+        self.m2 += d * (x - self.mean)
+        self.min = min(self.min, x)
+        self.max = max(self.max, x)
+
+    @property
+    def stddev(self):
+        return (self.m2 / (self.n - 1)) ** 0.5 if self.n > 1 else 0.0
+
+
+def print_stats(devices):
+    if not devices:
+        return
+    print("\n--- Statistik je Gerät ---")
+    for host, st in sorted(devices.items()):
+        print(f"{host}: {st.summary()}")
+    print("--------------------------\n")
+
+
+def format_line(timestamp, addr, message, rec):
+    if rec is None:
+        return f"[{timestamp}] {addr[0]}:{addr[1]} | {message}"
+
+    sev = SEVERITY_NAMES[rec['severity']]
+    fields = []
+    for name in ('link', 'pid', 'lat_us'):
+        v = sd_param(rec, name)
+        if v is not None:
+            fields.append(f"{name}={v}")
+    extra = f" [{' '.join(fields)}]" if fields else ""
+    return (f"[{timestamp}] {rec['host']} {sev:<5} {rec['msgid']:<6}"
+            f" seq={sd_param(rec, 'sequenceId')}{extra} | {rec['msg']}")
+
+
+def bind_socket(host, port, rcvbuf=None):
     # UDP-Socket erstellen
     sock = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
     sock.setsockopt(socket.SOL_SOCKET, socket.SO_REUSEADDR, 1)
-    
+    if rcvbuf:
+        sock.setsockopt(socket.SOL_SOCKET, socket.SO_RCVBUF, rcvbuf)
+
     try:
-        sock.bind((SYSLOG_HOST, SYSLOG_PORT))
+        sock.bind((host, port))
     except PermissionError:
-        print(f"FEHLER: Port {SYSLOG_PORT} benötigt Root-Rechte!")
+        print(f"FEHLER: Port {port} benötigt Root-Rechte!")
         print(f"Starte mit: sudo python3 {sys.argv[0]}")
         print(f"ODER nutze Port >1024 und passe ESP32 config_local.h an (SYSLOG_PORT)")
         sys.exit(1)
     except OSError as e:
-        print(f"FEHLER: Kann nicht auf Port {SYSLOG_PORT} binden: {e}")
+        print(f"FEHLER: Kann nicht auf Port {port} binden: {e}")
         sys.exit(1)
-    
+    return sock
+
+
+def decode(data):
+    try:
+        return data.decode('utf-8').strip()
+    except UnicodeDecodeError:
+        return data.decode('latin-1').strip()
+
+
+def format_rx_time(rx_time):
+    return datetime.datetime.fromtimestamp(rx_time).strftime("%Y-%m-%d %H:%M:%S.%f")[:-3]
+
+
+def live_main(args):
+    # Log-Datei öffnen (append mode)
+    log_path = Path(LOG_FILE)
+    print(f"Syslog-Server gestartet")
+    print(f"Lauscht auf {args.host}:{args.port}")
+    print(f"Schreibt in: {log_path.absolute()}")
+    print(f"Drücke Ctrl+C zum Beenden\n")
+
+    sock = bind_socket(args.host, args.port)
+    sock.settimeout(1.0)
+
+    devices = {}
+    next_stats = time.monotonic() + STATS_INTERVAL
+
     with open(log_path, 'a', encoding='utf-8') as log_file:
         try:
             while True:
+                if time.monotonic() >= next_stats:
+                    print_stats(devices)
+                    next_stats = time.monotonic() + STATS_INTERVAL
+
                 # Empfange Daten
-                data, addr = sock.recvfrom(MAX_PACKET_SIZE)
-                timestamp = datetime.datetime.now().strftime("%Y-%m-%d %H:%M:%S.%f")[:-3]
-                
                 try:
-                    message = data.decode('utf-8').strip()
-                except UnicodeDecodeError:
-                    message = data.decode('latin-1').strip()
-                
+                    data, addr = sock.recvfrom(MAX_PACKET_SIZE)
+                except socket.timeout:
+                    continue
+                rx_time = time.time()
+                message = decode(data)
+
+                rec = parse_rfc5424(message)
+                if rec is not None:
+                    devices.setdefault(rec['host'], DeviceStats()).update(rec, rx_time)
+
                 # Formatiere Log-Zeile
-                log_line = f"[{timestamp}] {addr[0]}:{addr[1]} | {message}"
-                
+                log_line = format_line(format_rx_time(rx_time), addr, message, rec)
+
                 # Schreibe in Datei und auf Konsole
                 print(log_line)
                 log_file.write(log_line + '\n')
                 log_file.flush()  # Sofort auf Disk schreiben
-                
+
         except KeyboardInterrupt:
             print("\n\nServer wird beendet...")
+            print_stats(devices)
         finally:
             sock.close()
             print(f"Log-Datei: {log_path.absolute()}")
 
+
+# ---------------------------------------------------------------------------
+# Collector-Modus
+#
+# Verzeichnislayout:
+#   <dir>/<gerät>/<gerät>-YYYYmmdd-HHMMSS-NN.log   Logzeilen (eine Zeile pro Nachricht)
+#   <dir>/<gerät>/<gerät>-YYYYmmdd-HHMMSS-NN.idx   INDEX_REC pro Zeile, zeitlich sortiert
+#   <dir>/<gerät>/<gerät>-YYYYmmdd-HHMMSS-NN.pXX   PID_REC pro Zeile mit PID XX (hex), zeitlich sortiert
+#   <dir>/<gerät>/<gerät>-YYYYmmdd-HHMMSS-NN.meta  JSON nach Rotation: Zeitraum + PIDs
+# Das aktive Segment hat noch keine .meta-Datei.
+# ---------------------------------------------------------------------------
+
+def pid_index_path(base, pid):
+    return f"{base}.p{pid:02X}"
+
+
+def safe_name(host):
+    return re.sub(r'[^A-Za-z0-9._-]', '_', host) or 'unknown'
+
+
+def parse_pid(value):
+    """PID aus SD-Parameter oder CLI ("0x18", "24")."""
+    try:
+        return int(value, 0) & 0x3F
+    except (TypeError, ValueError):
+        return None
+
+
+class DeviceStream:
+    """Segmentierte Log-Datei mit Index für ein Gerät."""
+
+    def __init__(self, root, host, rotate_bytes, rotate_seconds):
+        self.dir = Path(root) / safe_name(host)
+        self.dir.mkdir(parents=True, exist_ok=True)
+        self.host = safe_name(host)
+        self.rotate_bytes = rotate_bytes
+        self.rotate_seconds = rotate_seconds
+        self.log = None
+        self.idx = None
+        self.lines = []
+        self.index = []
+        self.pid_index = {}
+
+    def _open_segment(self, rx_time):
+        stamp = time.strftime('%Y%m%d-%H%M%S', time.localtime(rx_time))
+        # Laufende Nummer, damit mehrere Segmente pro Sekunde lexikografisch sortiert bleiben
+        n = 0
+        name = f"{self.host}-{stamp}-{n:02d}"
+        while (self.dir / f"{name}.log").exists():
+            n += 1
+            name = f"{self.host}-{stamp}-{n:02d}"
+        # Kein with_suffix(): Hostnamen können Punkte enthalten (IP bei altem Format)
+        self.base = self.dir / name
+        self.log = open(f"{self.base}.log", 'ab')
+        self.idx = open(f"{self.base}.idx", 'ab')
+        self.offset = 0
+        self.opened = rx_time
+        self.first = None
+        self.last = None
+        self.count = 0
+        self.pids = set()
+
+    def _close_segment(self):
+        self.flush()
+        self.log.close()
+        self.idx.close()
+        meta = {'first': self.first, 'last': self.last, 'lines': self.count,
+                'pids': sorted(self.pids), 'pid_index': True}
+        with open(f"{self.base}.meta", 'w') as f:
+            json.dump(meta, f)
+        self.log = None
+
+    def append(self, rx_time, line, pid):
+        if self.log is None:
+            self._open_segment(rx_time)
+        elif (self.offset >= self.rotate_bytes or
+              rx_time - self.opened >= self.rotate_seconds):
+            self._close_segment()
+            self._open_segment(rx_time)
+
+        # Zeitstempel im Index monoton halten (Binärsuche), auch bei Uhrsprüngen
+        if self.last is not None and rx_time < self.last:
+            rx_time = self.last
+        if self.first is None:
+            self.first = rx_time
+        self.last = rx_time
+
+        data = line.encode('utf-8') + b'\n'
+        self.lines.append(data)
+        self.index.append(INDEX_REC.pack(rx_time, self.offset, NO_PID if pid is None else pid))
+        if pid is not None:
+            self.pid_index.setdefault(pid, []).append(PID_REC.pack(rx_time, self.offset))
+            self.pids.add(pid)
+        self.offset += len(data)
+        self.count += 1
+
+    def flush(self):
+        if not self.lines:
+            return
+        # Erst Daten, dann Index: ein Index-Eintrag zeigt nie hinter das Dateiende
+        self.log.write(b''.join(self.lines))
+        self.log.flush()
+        self.idx.write(b''.join(self.index))
+        self.idx.flush()
+        # PID-Dateien nur kurz öffnen: pro Segment können bis zu 64 entstehen
+        for pid, recs in self.pid_index.items():
+            with open(pid_index_path(self.base, pid), 'ab') as f:
+                f.write(b''.join(recs))
+        self.lines.clear()
+        self.index.clear()
+        self.pid_index.clear()
+
+    def close(self):
+        if self.log is not None:
+            self._close_segment()
+
+
+def collect_main(args):
+    root = Path(args.dir)
+    root.mkdir(parents=True, exist_ok=True)
+    print(f"Syslog-Collector gestartet")
+    print(f"Lauscht auf {args.host}:{args.port}")
+    print(f"Schreibt nach: {root.absolute()}/<gerät>/")
+    print(f"Rotation: {args.rotate_mb} MB / {args.rotate_min} min")
+    print(f"Drücke Ctrl+C zum Beenden\n")
+
+    sock = bind_socket(args.host, args.port, RCVBUF_BYTES)
+    sock.settimeout(FLUSH_INTERVAL)
+
+    streams = {}
+    devices = {}
+    pending = 0
+    next_flush = time.monotonic() + FLUSH_INTERVAL
+    next_stats = time.monotonic() + STATS_INTERVAL
+
+    def flush_all():
+        for st in streams.values():
+            st.flush()
+
+    try:
+        while True:
+            try:
+                data, addr = sock.recvfrom(MAX_PACKET_SIZE)
+            except socket.timeout:
+                data = None
+
+            if data is not None:
+                rx_time = time.time()
+                message = decode(data)
+                rec = parse_rfc5424(message)
+
+                if rec is not None:
+                    host = rec['host'] if rec['host'] != '-' else addr[0]
+                    devices.setdefault(host, DeviceStats()).update(rec, rx_time)
+                    pid = parse_pid(sd_param(rec, 'pid'))
+                else:
+                    host = addr[0]
+                    pid = None
+
+                # Mehrzeilige Nachrichten (Sniffer) auf eine Zeile bringen
+                line = format_line(format_rx_time(rx_time), addr, message, rec).replace('\n', '\\n')
+                if args.echo:
+                    print(line)
+
+                st = streams.get(host)
+                if st is None:
+                    st = streams[host] = DeviceStream(root, host, args.rotate_mb * 1024 * 1024,
+                                                      args.rotate_min * 60)
+                st.append(rx_time, line, pid)
+                pending += 1
+
+            now = time.monotonic()
+            if pending >= FLUSH_LINES or (pending and now >= next_flush):
+                flush_all()
+                pending = 0
+                next_flush = now + FLUSH_INTERVAL
+            if now >= next_stats:
+                print_stats(devices)
+                next_stats = now + STATS_INTERVAL
+
+    except KeyboardInterrupt:
+        print("\n\nCollector wird beendet...")
+        print_stats(devices)
+    finally:
+        for st in streams.values():
+            st.close()
+        sock.close()
+
+
+# ---------------------------------------------------------------------------
+# Query
+# ---------------------------------------------------------------------------
+
+def parse_time_arg(value):
+    """Zeitangabe für die CLI: Unix-Zeit oder ISO-Format (lokale Zeit)."""
+    if value is None:
+        return None
+    try:
+        return float(value)
+    except ValueError:
+        return datetime.datetime.fromisoformat(value).timestamp()
+
+
+class IndexView:
+    """Zugriff auf eine Index-Datei (.idx oder PID-Index) mit Binärsuche über die Zeit."""
+
+    def __init__(self, path, rec=INDEX_REC):
+        with open(path, 'rb') as f:
+            self.data = f.read()
+        self.rec = rec
+        self.count = len(self.data) // rec.size
+
+    def __len__(self):
+        return self.count
+
+    def __getitem__(self, i):
+        return self.rec.unpack_from(self.data, i * self.rec.size)
+
+    def time_at(self, i):
+        return self[i][0]
+
+
+class _TimeKeys:
+    def __init__(self, view):
+        self.view = view
+
+    def __len__(self):
+        return len(self.view)
+
+    def __getitem__(self, i):
+        return self.view.time_at(i)
+
+
+def segment_candidates(device_dir, t_from, t_to, pid):
+    """Segmente, die laut .meta Treffer enthalten können (aktive Segmente immer)."""
+    for log_path in sorted(device_dir.glob('*.log')):
+        meta_path = log_path.with_suffix('.meta')
+        if meta_path.exists():
+            try:
+                meta = json.loads(meta_path.read_text())
+            except (OSError, ValueError):
+                meta = None
+            if meta and meta.get('first') is not None:
+                if t_from is not None and meta['last'] < t_from:
+                    continue
+                if t_to is not None and meta['first'] > t_to:
+                    continue
+                if pid is not None and pid not in meta.get('pids', []):
+                    continue
+        yield log_path
+
+
+def segment_has_pid_index(log_path):
+    """Segmente ohne .meta sind aktiv und damit vom aktuellen Collector geschrieben."""
+    meta_path = log_path.with_suffix('.meta')
+    if not meta_path.exists():
+        return True
+    try:
+        return bool(json.loads(meta_path.read_text()).get('pid_index'))
+    except (OSError, ValueError):
+        return False
+
+
+def query_segment(log_path, t_from, t_to, pid):
+    base = log_path.with_suffix('')
+    if pid is not None and segment_has_pid_index(log_path):
+        # Eigene Offset-Liste pro PID: kein Durchlauf über die Zeilen anderer PIDs
+        idx_path = Path(pid_index_path(base, pid))
+        rec = PID_REC
+    else:
+        # Ältere Segmente ohne PID-Index: Filter über das Feld im .idx
+        idx_path = log_path.with_suffix('.idx')
+        rec = INDEX_REC
+    if not idx_path.exists():
+        return
+    view = IndexView(idx_path, rec)
+    keys = _TimeKeys(view)
+    start = bisect.bisect_left(keys, t_from) if t_from is not None else 0
+
+    with open(log_path, 'rb') as log:
+        for i in range(start, len(view)):
+            entry = view[i]
+            rx_time, offset = entry[0], entry[1]
+            if t_to is not None and rx_time > t_to:
+                break
+            if pid is not None and rec is INDEX_REC and entry[2] != pid:
+                continue
+            log.seek(offset)
+            yield log.readline().decode('utf-8', 'replace').rstrip('\n')
+
+
+def query_main(args):
+    root = Path(args.dir)
+    pid = parse_pid(args.pid) if args.pid is not None else None
+    if args.pid is not None and pid is None:
+        print(f"FEHLER: ungültige PID '{args.pid}'")
+        sys.exit(1)
+    t_from = parse_time_arg(args.time_from)
+    t_to = parse_time_arg(args.time_to)
+
+    if args.device:
+        device_dirs = [root / safe_name(args.device)]
+    else:
+        device_dirs = sorted(p for p in root.iterdir() if p.is_dir()) if root.exists() else []
+
+    found = 0
+    for device_dir in device_dirs:
+        for log_path in segment_candidates(device_dir, t_from, t_to, pid):
+            for line in query_segment(log_path, t_from, t_to, pid):
+                print(line)
+                found += 1
+                if args.limit and found >= args.limit:
+                    return
+    if found == 0:
+        print("Keine Treffer", file=sys.stderr)
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Syslog-Server für LIN-Proxy")
+    parser.add_argument('--host', default=SYSLOG_HOST, help="Bind-Adresse")
+    parser.add_argument('--port', type=int, default=SYSLOG_PORT, help="UDP-Port")
+    sub = parser.add_subparsers(dest='mode')
+
+    p_collect = sub.add_parser('collect', help="Collector für mehrere Geräte")
+    p_collect.add_argument('--dir', default=COLLECT_DIR, help="Zielverzeichnis")
+    p_collect.add_argument('--rotate-mb', type=int, default=ROTATE_BYTES // (1024 * 1024),
+                           help="Segment rotieren ab dieser Größe (MB)")
+    p_collect.add_argument('--rotate-min', type=int, default=ROTATE_SECONDS // 60,
+                           help="Segment rotieren nach dieser Zeit (Minuten)")
+    p_collect.add_argument('--echo', action='store_true', help="Zeilen zusätzlich auf Konsole")
+
+    p_query = sub.add_parser('query', help="Zeilen über den Index abfragen")
+    p_query.add_argument('--dir', default=COLLECT_DIR, help="Collector-Verzeichnis")
+    p_query.add_argument('--device', help="Gerät (Hostname), Default: alle")
+    p_query.add_argument('--pid', help="LIN-ID, z.B. 0x18")
+    p_query.add_argument('--from', dest='time_from', help="Start (ISO oder Unix-Zeit)")
+    p_query.add_argument('--to', dest='time_to', help="Ende (ISO oder Unix-Zeit)")
+    p_query.add_argument('--limit', type=int, default=0, help="Max. Anzahl Zeilen")
+
+    args = parser.parse_args()
+    if args.mode == 'collect':
+        collect_main(args)
+    elif args.mode == 'query':
+        query_main(args)
+    else:
+        live_main(args)
+
 if __name__ == "__main__":
     main()
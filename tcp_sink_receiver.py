@@ -0,0 +1,194 @@
+#!/usr/bin/env python3
+"""
+TCP-Empfänger für den Capture-Stream des LIN-Proxy (TCP_SINK_MODE in config.h)
+
+Empfängt die 32-Byte-Datensätze aus dem Capture-Ring, hängt sie an eine
+Binärdatei an und prüft die Sequenznummern auf Lücken. Nach einem
+Verbindungsabbruch wird an der letzten empfangenen Sequenz fortgesetzt.
+
+  Gerät verbindet sich (TCP_SINK_MODE 1):  python3 tcp_sink_receiver.py listen
+  Empfänger verbindet sich (MODE 2):       python3 tcp_sink_receiver.py connect <ESP32-IP>
+
+Für Lasttests: --duration begrenzt die Laufzeit, --fail-on-loss liefert
+Exit-Code 1, sobald ein Datensatz fehlt.
+"""
+
+import argparse
+import socket
+import struct
+import sys
+import time
+from pathlib import Path
+
+DEFAULT_PORT = 5515
+CAPTURE_FILE = "lin_capture.bin"
+STATS_INTERVAL = 10
+
+HELLO = struct.Struct('<IHHII')          # magic, version, rec_size, ring_size, head
+HELLO_MAGIC = 0x434E494C                 # "LINC"
+# seq, t_us, resp_us, sync_us, id_us, link, pid, len, flags, data[10]
+RECORD = struct.Struct('<IQHHHBBBB10s')
+
+FLAG_PARITY_OK = 0x01
+FLAG_CLASSIC_OK = 0x02
+FLAG_ENHANCED_OK = 0x04
+FLAG_NO_RESPONSE = 0x08
+
+
+def recv_exact(sock, n):
+    buf = bytearray()
+    while len(buf) < n:
+        chunk = sock.recv(n - len(buf))
+        if not chunk:
+            raise ConnectionError("Verbindung geschlossen")
+        buf += chunk
+    return bytes(buf)
+
+
+class Receiver:
+    def __init__(self, out_path, verbose):
+        self.out = open(out_path, 'ab')
+        self.verbose = verbose
+        self.last_seq = None
+        self.received = 0
+        self.lost = 0
+        self.connects = 0
+        self.rx_bytes = 0
+        self.started = time.monotonic()
+
+    def handshake(self, sock):
+        magic, version, rec_size, ring_size, head = HELLO.unpack(recv_exact(sock, HELLO.size))
+        if magic != HELLO_MAGIC or rec_size != RECORD.size:
+            raise ConnectionError(f"Unerwartetes Hello (magic={magic:#x}, rec_size={rec_size})")
+
+        # Gerät neu gestartet: Sequenz beginnt wieder bei 1
+        if self.last_seq is not None and head < self.last_seq:
+            print(f"Gerät neu gestartet (head={head} < letzte seq={self.last_seq})")
+            self.last_seq = None
+
+        resume = 0 if self.last_seq is None else self.last_seq + 1
+        sock.sendall(struct.pack('<I', resume))
+        self.connects += 1
+        print(f"Verbunden (v{version}, Ring {ring_size}, head={head}), Start bei seq={resume or 'ältester'}")
+
+    def stream(self, sock, deadline):
+        pending = b''
+        while deadline is None or time.monotonic() < deadline:
+            try:
+                chunk = sock.recv(65536)
+            except socket.timeout:
+                continue
+            if not chunk:
+                raise ConnectionError("Verbindung geschlossen")
+            self.rx_bytes += len(chunk)
+            data = pending + chunk
+            usable = len(data) - len(data) % RECORD.size
+            pending = data[usable:]
+            if usable:
+                self.out.write(data[:usable])
+                for off in range(0, usable, RECORD.size):
+                    self.record(data, off)
+            self.maybe_stats()
+
+    def record(self, data, off):
+        seq, t_us, resp_us, sync_us, id_us, link, pid, length, flags, payload = RECORD.unpack_from(data, off)
+        if self.last_seq is not None:
+            gap = seq - self.last_seq - 1
+            if gap > 0:
+                self.lost += gap
+                print(f"LÜCKE: {gap} Datensätze fehlen (seq {self.last_seq + 1}..{seq - 1})")
+            elif gap < 0:
+                print(f"Sequenz rückwärts: {self.last_seq} -> {seq}")
+        self.last_seq = seq
+        self.received += 1
+
+        if self.verbose:
+            if flags & FLAG_NO_RESPONSE:
+                status = "keine Antwort"
+            elif flags & FLAG_ENHANCED_OK:
+                status = "enh ok"
+            elif flags & FLAG_CLASSIC_OK:
+                status = "cls ok"
+            else:
+                status = "checksum?"
+            if not flags & FLAG_PARITY_OK:
+                status = "PARITÄT " + status
+            print(f"{seq:8d} {t_us / 1000:12.1f}ms LIN{link + 1} 0x{pid & 0x3F:02X} "
+                  f"{payload[:length].hex(' ').upper():<30} {status}")
+
+    def maybe_stats(self, force=False):
+        now = time.monotonic()
+        if not force and now - getattr(self, '_last_stats', 0) < STATS_INTERVAL:
+            return
+        self._last_stats = now
+        elapsed = max(now - self.started, 1e-6)
+        self.out.flush()
+        print(f"[Statistik] empfangen={self.received} verloren={self.lost} "
+              f"verbindungen={self.connects} rate={self.received / elapsed:.1f}/s "
+              f"({self.rx_bytes / elapsed / 1024:.1f} KB/s)")
+
+
+def open_connection(args, listen_sock):
+    if args.mode == 'listen':
+        sock, addr = listen_sock.accept()
+        print(f"Gerät verbunden: {addr[0]}:{addr[1]}")
+        return sock
+    return socket.create_connection((args.host, args.port), timeout=5)
+
+
+def main():
+    parser = argparse.ArgumentParser(description="TCP-Empfänger für den LIN-Proxy-Capture-Stream")
+    parser.add_argument('mode', choices=['listen', 'connect'])
+    parser.add_argument('host', nargs='?', default='0.0.0.0', help="Bind-Adresse bzw. ESP32-IP")
+    parser.add_argument('--port', type=int, default=DEFAULT_PORT)
+    parser.add_argument('--out', default=CAPTURE_FILE, help="Binärdatei (wird angehängt)")
+    parser.add_argument('--duration', type=float, help="Laufzeit in Sekunden")
+    parser.add_argument('--fail-on-loss', action='store_true', help="Exit-Code 1 bei Verlusten")
+    parser.add_argument('-v', '--verbose', action='store_true', help="Jeden Datensatz ausgeben")
+    args = parser.parse_args()
+
+    rx = Receiver(Path(args.out), args.verbose)
+    deadline = time.monotonic() + args.duration if args.duration else None
+
+    listen_sock = None
+    if args.mode == 'listen':
+        listen_sock = socket.socket(socket.AF_INET, socket.SOCK_STREAM)
+        listen_sock.setsockopt(socket.SOL_SOCKET, socket.SO_REUSEADDR, 1)
+        listen_sock.bind((args.host, args.port))
+        listen_sock.listen(1)
+        if deadline:
+            listen_sock.settimeout(1.0)
+        print(f"Warte auf Gerät an {args.host}:{args.port}")
+
+    try:
+        while deadline is None or time.monotonic() < deadline:
+            try:
+                sock = open_connection(args, listen_sock)
+            except socket.timeout:
+                continue
+            except OSError as e:
+                print(f"Verbindung fehlgeschlagen: {e}")
+                time.sleep(2)
+                continue
+            try:
+                sock.settimeout(1.0 if deadline else None)
+                rx.handshake(sock)
+                rx.stream(sock, deadline)
+            except (ConnectionError, OSError) as e:
+                print(f"Verbindung getrennt: {e}")
+            finally:
+                sock.close()
+    except KeyboardInterrupt:
+        print("\nEmpfänger wird beendet...")
+    finally:
+        rx.maybe_stats(force=True)
+        rx.out.close()
+        if listen_sock:
+            listen_sock.close()
+
+    if args.fail_on_loss and rx.lost:
+        sys.exit(1)
+
+
+if __name__ == "__main__":
+    main()
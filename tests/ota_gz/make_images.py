@@ -0,0 +1,62 @@
+#!/usr/bin/env python3
+"""
+Test-Images für test_ota_gz
+
+  make_images.py <Verzeichnis>
+
+Erzeugt Rohimages mit fester Saat (reproduzierbar). Komprimiert werden sie
+danach mit tools/ota_compress.py compress, genau wie nach dem Build.
+"""
+
+import random
+import sys
+from pathlib import Path
+
+SEED = 0x11B
+
+
+def firmware_like(rng, size):
+    # Abwechselnd Code (wenige Befehlswörter), Strings, 0xFF-Füllung und
+    # Konstanten - ergibt Huffman-Blöcke mit langen und kurzen Matches.
+    words = [rng.randbytes(4) for _ in range(32)]
+    out = bytearray(b'\xe9')  # App-Image-Magic
+    while len(out) < size:
+        kind = rng.randrange(4)
+        n = rng.randrange(16, 2048)
+        if kind == 0:
+            out += b''.join(rng.choice(words) for _ in range(n // 4))
+        elif kind == 1:
+            out += b''.join(b'lin_proxy: PID %02X Offset %u us\n' % (rng.randrange(64), rng.randrange(10000))
+                            for _ in range(n // 32 + 1))
+        elif kind == 2:
+            out += b'\xff' * n
+        else:
+            out += rng.randbytes(n)
+    return bytes(out[:size])
+
+
+def images(rng):
+    window = 1 << 12
+    return {
+        'tiny.bin': b'\xe9',
+        'short.bin': b'LIN-Proxy OTA ' * 7,
+        # Genau am Fensterrand: der Ringpuffer läuft mehrmals über
+        'window.bin': bytes(range(256)) * (3 * window // 256) + b'\x00',
+        'fill.bin': b'\xff' * (64 * 1024),
+        # Nicht komprimierbar: zlib schreibt Stored-Blöcke
+        'random.bin': rng.randbytes(48 * 1024 + 5),
+        'firmware.bin': firmware_like(rng, 512 * 1024 + 77),
+    }
+
+
+def main():
+    out = Path(sys.argv[1])
+    out.mkdir(parents=True, exist_ok=True)
+    rng = random.Random(SEED)
+    for name, data in images(rng).items():
+        (out / name).write_bytes(data)
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,2 @@
+#pragma once
+// Leer: der Test braucht nur die Defaults aus config.h (OTA_GZ_WINDOW_BITS, OTA_BUF_SIZE, OTA_SLICE_SIZE)
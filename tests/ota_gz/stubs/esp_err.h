@@ -0,0 +1,12 @@
+#pragma once
+// Host-Ersatz für ESP-IDF: die Fehlercodes, die ota_gz.c und der Test benutzen
+
+typedef int esp_err_t;
+
+#define ESP_OK                   0
+#define ESP_FAIL                 -1
+#define ESP_ERR_NO_MEM           0x101
+#define ESP_ERR_INVALID_ARG      0x102
+#define ESP_ERR_INVALID_SIZE     0x104
+#define ESP_ERR_INVALID_RESPONSE 0x108
+#define ESP_ERR_INVALID_CRC      0x109
@@ -0,0 +1,14 @@
+#include "esp_rom_crc.h"
+
+// Bitweise, reflektiert (Polynom 0xEDB88320); langsam, aber unabhängig von zlib
+uint32_t esp_rom_crc32_le(uint32_t crc, uint8_t const *buf, uint32_t len)
+{
+    crc = ~crc;
+    while (len--) {
+        crc ^= *buf++;
+        for (int i = 0; i < 8; i++) {
+            crc = (crc >> 1) ^ (0xEDB88320u & -(crc & 1));
+        }
+    }
+    return ~crc;
+}
@@ -0,0 +1,5 @@
+#pragma once
+// Host-Ersatz für die CRC32 aus dem ESP32-ROM (gleiche Definition wie zlib/gzip), siehe esp_rom_crc.c
+#include <stdint.h>
+
+uint32_t esp_rom_crc32_le(uint32_t crc, uint8_t const *buf, uint32_t len);
@@ -0,0 +1,5 @@
+#pragma once
+// Host-Ersatz für den ROM-Header des ESP32: die Deklarationen aus miniz.c 1.15 (MINIZ_DIR), derselben Version wie
+// im ROM. Die Implementierung übersetzt das Makefile als eigene Datei.
+#define MINIZ_HEADER_FILE_ONLY
+#include "miniz.c"
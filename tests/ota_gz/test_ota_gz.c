@@ -0,0 +1,183 @@
+// Host-Test für src/ota_gz.c mit dem tinfl aus miniz 1.15 (wie im ESP32-ROM)
+//
+//   test_ota_gz <image.bin>...   (<image.bin>.gz daneben, von tools/ota_compress.py compress)
+//
+// Jedes Image wird in den Stückelungen dekomprimiert, die auf dem Gerät
+// ankommen: 1 Byte, TCP-Segmente, OTA_SLICE_SIZE (Download), OTA_BUF_SIZE
+// (Upload) und wechselnde Größen. Dazu jede Trennstelle in den letzten Bytes,
+// damit der Trailer mal ganz, mal teilweise im Bit-Puffer von tinfl steht.
+// Geprüft werden die Ausgabe Byte für Byte und ota_gz_finish.
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "config.h"
+#include "ota_gz.h"
+
+// Letzte Bytes des Streams, an denen einzeln getrennt wird (Trailer + vorausgelesene Deflate-Bytes)
+#define SPLIT_TAIL 24
+
+static int checks;
+static int failures;
+
+#define CHECK(cond, ...)                                                          \
+    do {                                                                          \
+        checks++;                                                                 \
+        if (!(cond)) {                                                            \
+            failures++;                                                           \
+            fprintf(stderr, "%s:%d: CHECK(%s) fehlgeschlagen: ", __FILE__, __LINE__, #cond); \
+            fprintf(stderr, __VA_ARGS__);                                         \
+            fputc('\n', stderr);                                                  \
+        }                                                                         \
+    } while (0)
+
+typedef struct {
+    uint8_t *data;
+    size_t len;
+} blob_t;
+
+// Vergleicht die Ausgabe von ota_gz_feed mit dem Original
+typedef struct {
+    const blob_t *ref;
+    size_t pos;
+    bool mismatch;
+} sink_t;
+
+static bool read_file(const char *path, blob_t *b)
+{
+    FILE *f = fopen(path, "rb");
+    if (!f) return false;
+    fseek(f, 0, SEEK_END);
+    b->len = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    b->data = malloc(b->len ? b->len : 1);
+    bool ok = fread(b->data, 1, b->len, f) == b->len;
+    fclose(f);
+    return ok;
+}
+
+static esp_err_t sink_out(void *ctx, const uint8_t *data, size_t len)
+{
+    sink_t *s = ctx;
+    if (len == 0 || len > (1u << OTA_GZ_WINDOW_BITS) || s->pos + len > s->ref->len ||
+        memcmp(s->ref->data + s->pos, data, len) != 0) {
+        s->mismatch = true;
+        return ESP_FAIL;
+    }
+    s->pos += len;
+    return ESP_OK;
+}
+
+// gz in den Stückgrößen sizes[0], sizes[1], ... (zyklisch) füttern; bis split
+// (falls > 0) und ab dort getrennt, damit genau dort eine Grenze liegt.
+// Liefert das Ergebnis von ota_gz_finish bzw. den ersten Fehler.
+static esp_err_t run(const blob_t *ref, const blob_t *gz, const size_t *sizes, size_t n_sizes, size_t split,
+                     sink_t *sink)
+{
+    ota_gz_t *ctx = ota_gz_new();
+    if (!ctx) return ESP_ERR_NO_MEM;
+    memset(sink, 0, sizeof(*sink));
+    sink->ref = ref;
+
+    esp_err_t err = ESP_OK;
+    size_t off = 0;
+    for (size_t k = 0; off < gz->len && err == ESP_OK; k++) {
+        size_t n = sizes[k % n_sizes];
+        if (split > off && off + n > split) n = split - off;
+        if (n > gz->len - off) n = gz->len - off;
+        err = ota_gz_feed(ctx, gz->data + off, n, sink_out, sink);
+        off += n;
+    }
+    if (err == ESP_OK) {
+        err = ota_gz_finish(ctx);
+    }
+    if (err == ESP_OK && ota_gz_output_size(ctx) != ref->len) {
+        err = ESP_ERR_INVALID_SIZE;
+    }
+    ota_gz_free(ctx);
+    return err;
+}
+
+static void test_image(const char *name, const blob_t *ref, const blob_t *gz)
+{
+    // TCP-MSS (IPv4 Minimum, Ethernet, WLAN mit Optionen), Slice, Upload-Puffer
+    static const size_t fixed[] = {1, 2, 7, 536, 1436, 1460, OTA_SLICE_SIZE, OTA_BUF_SIZE};
+    static const size_t mixed[] = {1436, 1, 1460, 7, 536, 3, 2920, 1};
+    sink_t sink;
+
+    CHECK(ota_gz_is_gzip(gz->data, gz->len), "%s: kein gzip-Magic", name);
+
+    for (size_t i = 0; i < sizeof(fixed) / sizeof(fixed[0]); i++) {
+        esp_err_t err = run(ref, gz, &fixed[i], 1, 0, &sink);
+        CHECK(err == ESP_OK && !sink.mismatch && sink.pos == ref->len,
+              "%s, %u-Byte-Stücke: Fehler 0x%x, %u/%u Byte, Abweichung %d", name, (unsigned)fixed[i], err,
+              (unsigned)sink.pos, (unsigned)ref->len, sink.mismatch);
+    }
+
+    esp_err_t err = run(ref, gz, mixed, sizeof(mixed) / sizeof(mixed[0]), 0, &sink);
+    CHECK(err == ESP_OK && !sink.mismatch && sink.pos == ref->len, "%s, wechselnde Stücke: Fehler 0x%x", name, err);
+
+    // Grenze an jeder Stelle am Streamende, einmal mit großen Stücken und einmal mit TCP-Segmenten davor
+    for (size_t tail = 1; tail <= SPLIT_TAIL && tail < gz->len; tail++) {
+        size_t split = gz->len - tail;
+        size_t big = OTA_BUF_SIZE;
+        err = run(ref, gz, &big, 1, split, &sink);
+        CHECK(err == ESP_OK && !sink.mismatch, "%s, Grenze %u Byte vor Ende: Fehler 0x%x", name, (unsigned)tail, err);
+        size_t mss = 1436;
+        err = run(ref, gz, &mss, 1, split, &sink);
+        CHECK(err == ESP_OK && !sink.mismatch, "%s, MSS, Grenze %u Byte vor Ende: Fehler 0x%x", name,
+              (unsigned)tail, err);
+    }
+}
+
+// Beschädigte Trailer und abgeschnittene Streams müssen in ota_gz_finish auffallen
+static void test_broken(const char *name, const blob_t *ref, const blob_t *gz)
+{
+    size_t chunk = 1436;
+    sink_t sink;
+    blob_t bad = {malloc(gz->len), gz->len};
+    memcpy(bad.data, gz->data, gz->len);
+
+    bad.data[bad.len - 8] ^= 0x01;  // CRC32
+    CHECK(run(ref, &bad, &chunk, 1, 0, &sink) == ESP_ERR_INVALID_CRC, "%s: falsche CRC32 nicht erkannt", name);
+    bad.data[bad.len - 8] ^= 0x01;
+
+    bad.data[bad.len - 1] ^= 0x80;  // ISIZE
+    CHECK(run(ref, &bad, &chunk, 1, 0, &sink) == ESP_ERR_INVALID_CRC, "%s: falsche Länge nicht erkannt", name);
+    bad.data[bad.len - 1] ^= 0x80;
+
+    for (size_t cut = 1; cut <= 8; cut++) {
+        bad.len = gz->len - cut;
+        CHECK(run(ref, &bad, &chunk, 1, 0, &sink) == ESP_ERR_INVALID_SIZE, "%s: %u Byte abgeschnitten nicht erkannt",
+              name, (unsigned)cut);
+    }
+    free(bad.data);
+}
+
+int main(int argc, char **argv)
+{
+    if (argc < 2) {
+        fprintf(stderr, "Aufruf: %s <image.bin>...\n", argv[0]);
+        return 2;
+    }
+    for (int i = 1; i < argc; i++) {
+        char gz_path[512];
+        snprintf(gz_path, sizeof(gz_path), "%s.gz", argv[i]);
+        blob_t ref, gz;
+        if (!read_file(argv[i], &ref) || !read_file(gz_path, &gz)) {
+            fprintf(stderr, "%s oder %s nicht lesbar\n", argv[i], gz_path);
+            return 2;
+        }
+        test_image(argv[i], &ref, &gz);
+        test_broken(argv[i], &ref, &gz);
+        free(ref.data);
+        free(gz.data);
+    }
+    if (failures) {
+        fprintf(stderr, "test_ota_gz: %d von %d Prüfungen fehlgeschlagen\n", failures, checks);
+        return 1;
+    }
+    printf("test_ota_gz: %d Prüfungen bestanden\n", checks);
+    return 0;
+}
@@ -0,0 +1,163 @@
+#!/usr/bin/env python3
+"""
+Nachbildung des TCP-Sinks (src/tcp_sink.c, TCP_SINK_MODE 1) für Lasttests ohne Hardware
+
+  fake_device.py [--host 127.0.0.1] [--port 5515] [--duration 30] [--disconnect-every 5]
+
+Ein simulierter Capture-Ring (CAPTURE_RING_SIZE Einträge) füllt sich mit der
+Framerate eines voll ausgelasteten Busses. Gesendet wird wie auf dem Gerät:
+Hello, Start-Sequenz vom Empfänger, dann 32-Byte-Datensätze ab dieser
+Sequenz, Rückstand über ¾ Ring wird übersprungen (= Verlust). Zusätzlich:
+
+- jedes send() bekommt nur ein zufälliges Stück (Teil-Writes mitten im Datensatz)
+- alle --disconnect-every Sekunden bricht die Verbindung mitten in einem
+  Datensatz ab; nach SINK_RETRY_S verbindet sich das "Gerät" neu
+
+Inhalt jedes Datensatzes hängt nur von seq ab (record()), so kann der
+Empfänger-Mitschnitt Byte für Byte geprüft werden.
+"""
+
+import argparse
+import random
+import socket
+import struct
+import sys
+import time
+
+HELLO = struct.Struct('<IHHII')          # wie tcp_sink_hello_t
+HELLO_MAGIC = 0x434E494C                 # "LINC"
+VERSION = 1
+RECORD = struct.Struct('<IQHHHBBBB10s')  # wie capture_rec_t
+
+RING_SIZE = 256                          # CAPTURE_RING_SIZE
+MAX_LAG = RING_SIZE * 3 // 4             # SINK_MAX_LAG
+RESYNC_LAG = RING_SIZE // 2              # SINK_RESYNC_LAG
+POLL_S = 0.010                           # SINK_POLL_MS
+# Auf dem Gerät 2 s (SINK_RETRY_MS); verlustfrei nur, solange der Ring die
+# Pause überbrückt: 256 Einträge reichen bei 310 Frames/s für 0,8 s.
+SINK_RETRY_S = 0.2
+SPAN_MAX = 32                            # Datensätze pro send(), wie ein Abschnitt bis zum Ringende
+
+FLAG_PARITY_OK = 0x01
+FLAG_ENHANCED_OK = 0x04
+
+
+def bus_load_rate(baud=19200, links=2):
+    # 100 % Last: Frames mit 8 Datenbytes ohne Pause, Header 34 Bit + 9 Bytes à 10 Bit
+    return links * baud / (34 + 9 * 10)
+
+
+def record(seq, rate):
+    data = bytes((seq + i) & 0xFF for i in range(9))
+    return RECORD.pack(seq, int(seq * 1e6 / rate), 600 + seq % 400, 750, 520, seq % 2, seq & 0x3F, 9,
+                       FLAG_PARITY_OK | FLAG_ENHANCED_OK, data)
+
+
+class FakeDevice:
+    def __init__(self, host, port, rate, disconnect_every=None, seed=1):
+        self.addr = (host, port)
+        self.rate = rate
+        self.disconnect_every = disconnect_every
+        self.rng = random.Random(seed)
+        self.t0 = time.monotonic()
+        self.stop = False
+        # Zähler wie tcp_sink_stats_t
+        self.connects = 0
+        self.sent = 0
+        self.lost = 0
+        self.partial = 0
+        self.disconnects = 0
+
+    def head(self):
+        # Zuletzt geschriebene Sequenz (capture_head)
+        return int((time.monotonic() - self.t0) * self.rate)
+
+    def handshake(self, sock):
+        sock.sendall(HELLO.pack(HELLO_MAGIC, VERSION, RECORD.size, RING_SIZE, self.head()))
+        buf = b''
+        while len(buf) < 4:
+            chunk = sock.recv(4 - len(buf))
+            if not chunk:
+                raise ConnectionError("Empfänger hat geschlossen")
+            buf += chunk
+        resume, = struct.unpack('<I', buf)
+        head = self.head()
+        if resume == 0 or resume - 1 > head:
+            return head - RING_SIZE + 1 if head >= RING_SIZE else 1
+        return resume
+
+    def stream(self, sock, next_seq):
+        part = 0
+        deadline = time.monotonic() + self.disconnect_every if self.disconnect_every else None
+        while not self.stop:
+            head = self.head()
+            if part == 0 and head - next_seq + 1 > MAX_LAG:
+                skip_to = head - RESYNC_LAG + 1
+                self.lost += skip_to - next_seq
+                next_seq = skip_to
+            if next_seq <= head - RING_SIZE:
+                # Ring hat den Abschnitt überholt (auf dem Gerät: capture_lapped)
+                return
+            n = min(head - next_seq + 1, SPAN_MAX)
+            if n <= 0:
+                time.sleep(POLL_S)
+                continue
+            span = b''.join(record(s, self.rate) for s in range(next_seq, next_seq + n))[part:]
+            # Teil-Write: nur ein Stück, das selten an einer Datensatzgrenze endet
+            piece = self.rng.randint(1, len(span))
+            sent = sock.send(span[:piece])
+            if sent < len(span):
+                self.partial += 1
+            total = part + sent
+            next_seq += total // RECORD.size
+            self.sent += total // RECORD.size
+            part = total % RECORD.size
+            if deadline and time.monotonic() >= deadline and part != 0:
+                # Abbruch mitten im Datensatz
+                self.disconnects += 1
+                return
+
+    def run(self, duration):
+        end = time.monotonic() + duration
+        while not self.stop and time.monotonic() < end:
+            try:
+                sock = socket.create_connection(self.addr, timeout=2)
+            except OSError:
+                time.sleep(SINK_RETRY_S)
+                continue
+            try:
+                next_seq = self.handshake(sock)
+                self.connects += 1
+                self.stream(sock, next_seq)
+            except OSError:
+                pass
+            finally:
+                sock.close()
+            time.sleep(SINK_RETRY_S)
+
+    def summary(self):
+        return (f"Gerät: verbindungen={self.connects} abbrüche={self.disconnects} gesendet={self.sent} "
+                f"verloren={self.lost} teil-writes={self.partial} rate={self.rate:.1f}/s")
+
+
+def main():
+    parser = argparse.ArgumentParser(description="TCP-Sink-Nachbildung für Lasttests")
+    parser.add_argument('--host', default='127.0.0.1', help="Adresse von tcp_sink_receiver.py listen")
+    parser.add_argument('--port', type=int, default=5515)
+    parser.add_argument('--duration', type=float, default=30)
+    parser.add_argument('--baud', type=int, default=19200)
+    parser.add_argument('--links', type=int, default=2)
+    parser.add_argument('--disconnect-every', type=float, default=5, help="0 = nie")
+    args = parser.parse_args()
+
+    dev = FakeDevice(args.host, args.port, bus_load_rate(args.baud, args.links), args.disconnect_every or None)
+    try:
+        dev.run(args.duration)
+    except KeyboardInterrupt:
+        pass
+    print(dev.summary())
+    return 0 if dev.lost == 0 else 1
+
+
+if __name__ == '__main__':
+    sys.exit(main())
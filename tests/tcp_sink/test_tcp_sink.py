@@ -0,0 +1,99 @@
+#!/usr/bin/env python3
+"""
+Lasttest TCP-Sink ohne Hardware: fake_device.py gegen tcp_sink_receiver.py
+
+  test_tcp_sink.py [--duration 20] [--disconnect-every 4]
+
+Startet den Empfänger mit --duration und --fail-on-loss (listen auf einem
+freien Port), lässt das nachgebildete Gerät mit voller Buslast, Teil-Writes
+und Abbrüchen mitten im Datensatz senden und prüft danach:
+
+- Exit-Code 0 des Empfängers (keine Lücke)
+- mindestens ein Reconnect, Teil-Writes aufgetreten
+- der Mitschnitt ist lückenlos ab seq 1 und jeder Datensatz stimmt Byte für
+  Byte mit dem Original überein (keine verschobenen Teilstücke)
+- die Anzahl passt zur Framerate
+"""
+
+import argparse
+import socket
+import subprocess
+import sys
+import tempfile
+import threading
+import time
+from pathlib import Path
+
+from fake_device import RECORD, FakeDevice, bus_load_rate, record
+
+RECEIVER = Path(__file__).resolve().parents[2] / 'tcp_sink_receiver.py'
+
+
+def free_port():
+    with socket.socket() as s:
+        s.bind(('127.0.0.1', 0))
+        return s.getsockname()[1]
+
+
+def check_capture(path, rate):
+    data = path.read_bytes()
+    errors = []
+    if len(data) % RECORD.size:
+        errors.append(f"Mitschnitt {len(data)} Byte, kein Vielfaches von {RECORD.size}")
+    count = len(data) // RECORD.size
+    for i in range(count):
+        seq = i + 1
+        if data[i * RECORD.size:(i + 1) * RECORD.size] != record(seq, rate):
+            errors.append(f"Datensatz {i}: erwartet seq {seq}, Inhalt weicht ab")
+            break
+    return count, errors
+
+
+def main():
+    parser = argparse.ArgumentParser(description="TCP-Sink-Lasttest gegen tcp_sink_receiver.py")
+    parser.add_argument('--duration', type=float, default=20)
+    parser.add_argument('--disconnect-every', type=float, default=4)
+    args = parser.parse_args()
+
+    rate = bus_load_rate()
+    port = free_port()
+    errors = []
+    with tempfile.TemporaryDirectory() as tmp:
+        out = Path(tmp) / 'capture.bin'
+        receiver = subprocess.Popen(
+            [sys.executable, '-u', str(RECEIVER), 'listen', '127.0.0.1', '--port', str(port),
+             '--duration', str(args.duration), '--fail-on-loss', '--out', str(out)],
+            stdout=subprocess.PIPE, stderr=subprocess.STDOUT, text=True)
+        time.sleep(0.5)   # Empfänger lauscht
+
+        dev = FakeDevice('127.0.0.1', port, rate, args.disconnect_every)
+        thread = threading.Thread(target=dev.run, args=(args.duration + 5,), daemon=True)
+        thread.start()
+        log, _ = receiver.communicate(timeout=args.duration + 30)
+        dev.stop = True
+        thread.join(timeout=5)
+
+        print(log, end='')
+        print(dev.summary())
+        if receiver.returncode != 0:
+            errors.append(f"Empfänger: Exit-Code {receiver.returncode} (Verlust?)")
+        if dev.lost:
+            errors.append(f"Gerät: {dev.lost} Datensätze übersprungen")
+        if dev.disconnects == 0 or log.count('Verbunden') < 2:
+            errors.append("kein Abbruch mitten im Datensatz mit Reconnect")
+        if dev.partial == 0:
+            errors.append("keine Teil-Writes")
+        count, capture_errors = check_capture(out, rate)
+        errors += capture_errors
+        # Empfänger startet 0,5 s vor dem Gerät, am Ende fehlen höchstens Daten in Übertragung
+        if count < 0.9 * rate * (args.duration - 1):
+            errors.append(f"nur {count} Datensätze bei {rate:.0f}/s in {args.duration:.0f} s")
+
+    for e in errors:
+        print(f"FEHLER: {e}")
+    print(f"test_tcp_sink: {count} Datensätze, {'OK' if not errors else 'FEHLGESCHLAGEN'}")
+    return 1 if errors else 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
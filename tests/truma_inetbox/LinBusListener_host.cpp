@@ -0,0 +1,12 @@
+#ifdef USE_HOST
+#include "LinBusListener.h"
+
+namespace esphome {
+namespace truma_inetbox {
+
+// No UART task on the host, the test calls `onReceive` after feeding the UART.
+void LinBusListener::setup_framework() {}
+
+}  // namespace truma_inetbox
+}  // namespace esphome
+#endif  // USE_HOST
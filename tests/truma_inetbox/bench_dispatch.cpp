@@ -0,0 +1,77 @@
+// PID dispatch benchmark: the frame reader with the handler table (`register_lin_response_`, function pointer per
+// answered PID) against a listener selecting the reader for itself (`use_lin_reader_`, answer inlined), for both
+// checksum models. Every round is one answered frame (0x18, echo of the answer) and one master frame (0x21).
+#include <chrono>
+#include "LinBusFrameReader.h"
+#include "host.h"
+#include "test.h"
+
+using namespace esphome::truma_inetbox;
+
+static const int ROUNDS = 100000;
+static const int PASSES = 5;
+static const std::vector<uint8_t> ANSWER = {0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08};
+
+// Same answer as `TestListener::answer`, dispatched at compile time.
+class StaticListener : public host::TestListener {
+ protected:
+  friend class esphome::truma_inetbox::LinBusListener;
+  void select_lin_reader_() override { this->use_lin_reader_<StaticListener>(); }
+  const LinBusResponse *lin_response_(u_int8_t pid) { return pid == 0x18 ? &this->response_ : nullptr; }
+};
+
+// Host time per frame of one pass.
+template<typename Listener> static double pass(bool classic) {
+  host::FakeUART uart;
+  Listener listener;
+  listener.set_lin_checksum(classic ? LIN_CHECKSUM::LIN_CHECKSUM_VERSION_1 : LIN_CHECKSUM::LIN_CHECKSUM_VERSION_2);
+  listener.begin(&uart);
+  listener.answer(0x18, ANSWER);
+  std::vector<uint8_t> round = host::lin_frame(0x18, ANSWER, classic, false);
+  std::vector<uint8_t> master = host::lin_frame(0x21, ANSWER, classic);
+  round.insert(round.end(), master.begin(), master.end());
+
+  size_t received = 0;
+  size_t answered = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < ROUNDS; i++) {
+    uart.receive(round);
+    listener.onReceive();
+    answered += uart.tx.size() / (ANSWER.size() + 1);
+    uart.tx.clear();
+    // Drain like the LIN message task would.
+    if ((i & 7) == 7) {
+      listener.process_lin_msg_queue();
+      received += listener.messages.size();
+      listener.messages.clear();
+    }
+  }
+  listener.process_lin_msg_queue();
+  received += listener.messages.size();
+  auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+
+  // The classic checksum does not tell master from slave frames, the answer echo is passed on as well.
+  CHECK_EQ(received, classic ? 2 * ROUNDS : ROUNDS);
+  CHECK_EQ(answered, ROUNDS);
+  return (double) ns / (2 * ROUNDS);
+}
+
+// Best of a few passes, the host is not idle.
+template<typename Listener> static void run(const char *name, bool classic) {
+  double best = pass<Listener>(classic);
+  for (int i = 1; i < PASSES; i++) {
+    double ns = pass<Listener>(classic);
+    if (ns < best) {
+      best = ns;
+    }
+  }
+  printf("%-24s %7.1f ns/frame\n", name, best);
+}
+
+int main() {
+  run<host::TestListener>("table, enhanced", false);
+  run<StaticListener>("static, enhanced", false);
+  run<host::TestListener>("table, classic", true);
+  run<StaticListener>("static, classic", true);
+  return test::summary("bench_dispatch");
+}
@@ -0,0 +1,52 @@
+// Receive path benchmark: LIN frames through `onReceive_` and `read_lin_frame_` with an in memory UART.
+// Reports UART calls (each one takes the UART component lock) and host time per frame for one byte per UART event
+// (threshold 1, bytes trickling in) and one frame per UART event (task was late).
+#include <chrono>
+#include "host.h"
+#include "test.h"
+
+using namespace esphome::truma_inetbox;
+
+static const int FRAMES = 200000;
+
+static void run(const char *name, bool byte_per_event) {
+  host::FakeUART uart;
+  host::TestListener listener;
+  listener.begin(&uart);
+  std::vector<uint8_t> frame = host::lin_frame(0x21, {0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08});
+
+  size_t received = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < FRAMES; i++) {
+    if (byte_per_event) {
+      for (uint8_t b : frame) {
+        uart.receive({b});
+        listener.onReceive();
+      }
+    } else {
+      uart.receive(frame);
+      listener.onReceive();
+    }
+    // Drain like the LIN message task would.
+    if ((i & 7) == 7) {
+      listener.process_lin_msg_queue();
+      received += listener.messages.size();
+      listener.messages.clear();
+    }
+  }
+  listener.process_lin_msg_queue();
+  received += listener.messages.size();
+  auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+
+  CHECK_EQ(received, FRAMES);
+  CHECK_EQ(listener.get_lin_msg_dropped(), 0);
+  printf("%-16s %6.2f UART calls/frame (%5.2f available, %5.2f read_array) %7.1f ns/frame\n", name,
+         (double) (uart.available_calls + uart.read_calls) / FRAMES, (double) uart.available_calls / FRAMES,
+         (double) uart.read_calls / FRAMES, (double) ns / FRAMES);
+}
+
+int main() {
+  run("byte per event", true);
+  run("frame per event", false);
+  return test::summary("bench_lin_rx");
+}
@@ -0,0 +1,38 @@
+#pragma once
+#include <cstdint>
+#include <initializer_list>
+#include <mutex>
+#include <vector>
+#include "esphome/components/uart/uart.h"
+
+namespace host {
+
+struct TxByte {
+  uint32_t time;
+  uint8_t data;
+};
+
+// In memory UART. Bytes given to `receive` are handed out by `read_array`, written bytes are recorded with the
+// simulated time of the write. Every call takes a lock, like the ESPHome UART components.
+class FakeUART : public esphome::uart::UARTComponent {
+ public:
+  void receive(const std::vector<uint8_t> &data);
+  void receive(std::initializer_list<uint8_t> data) { this->receive(std::vector<uint8_t>(data)); }
+
+  void write_array(const uint8_t *data, size_t len) override;
+  bool peek_byte(uint8_t *data) override;
+  bool read_array(uint8_t *data, size_t len) override;
+  int available() override;
+  void flush() override {}
+
+  std::vector<TxByte> tx;
+  uint32_t available_calls = 0;
+  uint32_t read_calls = 0;
+
+ protected:
+  std::mutex lock_;
+  std::vector<uint8_t> rx_;
+  size_t rx_pos_ = 0;
+};
+
+}  // namespace host
@@ -0,0 +1,109 @@
+#include "host.h"
+#include <cstdarg>
+#include <cstring>
+#include "test.h"
+#include "helpers.h"
+
+namespace host {
+
+int log_level = ESPHOME_LOG_LEVEL_WARN;
+
+static uint32_t now_us = 0;
+
+void set_time(uint32_t us) { now_us = us; }
+void advance(uint32_t us) { now_us += us; }
+uint32_t time() { return now_us; }
+
+void FakeUART::receive(const std::vector<uint8_t> &data) {
+  std::lock_guard<std::mutex> guard(this->lock_);
+  if (this->rx_pos_ == this->rx_.size()) {
+    this->rx_.clear();
+    this->rx_pos_ = 0;
+  }
+  this->rx_.insert(this->rx_.end(), data.begin(), data.end());
+}
+
+void FakeUART::write_array(const uint8_t *data, size_t len) {
+  std::lock_guard<std::mutex> guard(this->lock_);
+  for (size_t i = 0; i < len; i++) {
+    this->tx.push_back(TxByte{now_us, data[i]});
+  }
+}
+
+bool FakeUART::peek_byte(uint8_t *data) {
+  std::lock_guard<std::mutex> guard(this->lock_);
+  if (this->rx_pos_ >= this->rx_.size()) {
+    return false;
+  }
+  *data = this->rx_[this->rx_pos_];
+  return true;
+}
+
+bool FakeUART::read_array(uint8_t *data, size_t len) {
+  std::lock_guard<std::mutex> guard(this->lock_);
+  this->read_calls++;
+  if (this->rx_.size() - this->rx_pos_ < len) {
+    return false;
+  }
+  memcpy(data, &this->rx_[this->rx_pos_], len);
+  this->rx_pos_ += len;
+  return true;
+}
+
+int FakeUART::available() {
+  std::lock_guard<std::mutex> guard(this->lock_);
+  this->available_calls++;
+  return this->rx_.size() - this->rx_pos_;
+}
+
+std::vector<uint8_t> lin_header(uint8_t pid) {
+  pid &= 0x3F;
+  return {0x00, 0x55, (uint8_t) (pid | (esphome::truma_inetbox::addr_parity(pid) << 6))};
+}
+
+std::vector<uint8_t> lin_frame(uint8_t pid, const std::vector<uint8_t> &data, bool classic, bool from_master) {
+  std::vector<uint8_t> frame = lin_header(pid);
+  frame.insert(frame.end(), data.begin(), data.end());
+  // The listener tells master and slave frames apart by the enhanced checksum seed: PID without or with parity.
+  uint16_t seed = classic ? 0 : (from_master ? (pid & 0x3F) : frame[2]);
+  frame.push_back(esphome::truma_inetbox::data_checksum(data.data(), data.size(), seed));
+  return frame;
+}
+
+}  // namespace host
+
+TaskHandle_t xTaskGetCurrentTaskHandle() {
+  static HostTask task;
+  return &task;
+}
+
+namespace esphome {
+std::string str_snprintf(const char *fmt, size_t len, ...) {
+  std::string str(len, '\0');
+  va_list args;
+  va_start(args, len);
+  size_t out = vsnprintf(&str[0], len + 1, fmt, args);
+  va_end(args);
+  str.resize(out < len ? out : len);
+  return str;
+}
+
+uint32_t micros() { return host::now_us; }
+uint32_t millis() { return host::now_us / 1000; }
+void delay(uint32_t ms) { host::now_us += ms * 1000; }
+void delayMicroseconds(uint32_t us) { host::now_us += us; }
+}  // namespace esphome
+
+namespace test {
+int checks = 0;
+int failures = 0;
+
+int summary(const char *name) {
+  if (failures > 0) {
+    printf("%s: %d of %d checks FAILED\n", name, failures, checks);
+    return 1;
+  }
+  printf("%s: %d checks passed\n", name, checks);
+  return 0;
+}
+}  // namespace test
@@ -0,0 +1,60 @@
+#pragma once
+// Host side of the tests and benchmarks: simulated clock, LIN frame builders and a LIN listener that records the
+// received messages. The in memory UART is in fake_uart.h.
+#include <cstdint>
+#include <vector>
+#include "LinBusListener.h"
+#include "fake_uart.h"
+
+namespace host {
+
+// Run time log filter for the ESP_LOGx stubs.
+extern int log_level;
+
+// Simulated clock behind `micros()`. `delayMicroseconds()` advances it.
+void set_time(uint32_t us);
+void advance(uint32_t us);
+uint32_t time();
+
+// Bytes of a LIN header as sent by the master: BREAK, SYNC, PID with parity bits.
+std::vector<uint8_t> lin_header(uint8_t pid);
+// Header, `data` and checksum (enhanced checksum unless `classic`).
+std::vector<uint8_t> lin_frame(uint8_t pid, const std::vector<uint8_t> &data, bool classic = false,
+                               bool from_master = true);
+
+// Listener recording the LIN messages handed to the LIN message task.
+class TestListener : public esphome::truma_inetbox::LinBusListener {
+ public:
+  struct Message {
+    uint8_t pid;
+    std::vector<uint8_t> data;
+  };
+
+  // Connect to `uart` and run `setup()`.
+  void begin(FakeUART *uart) {
+    this->set_uart_parent(uart);
+    this->setup();
+  }
+
+  using LinBusListener::prepare_lin_response_;
+  using LinBusListener::register_lin_response_;
+
+  // Answer `pid` with `data`.
+  void answer(uint8_t pid, const std::vector<uint8_t> &data) {
+    this->prepare_lin_response_(&this->response_, pid, data.data(), data.size());
+    this->register_lin_response_(pid, [](esphome::truma_inetbox::LinBusListener *listener) {
+      return (const esphome::truma_inetbox::LinBusResponse *) &static_cast<TestListener *>(listener)->response_;
+    });
+  }
+
+  std::vector<Message> messages;
+
+ protected:
+  esphome::truma_inetbox::LinBusResponse response_;
+
+  void lin_message_recieved_(const u_int8_t pid, const u_int8_t *message, u_int8_t length) override {
+    this->messages.push_back(Message{pid, std::vector<uint8_t>(message, message + length)});
+  }
+};
+
+}  // namespace host
@@ -0,0 +1,91 @@
+#include "rp2040_sim.h"
+#include <deque>
+#include <SerialUART.h>
+#include "host.h"
+
+struct RxChar {
+  uint8_t data;
+  bool lin_break;
+};
+
+struct uart_inst {
+  std::deque<RxChar> fifo;
+  // BE of the character last read from DR
+  bool lin_break = false;
+  bool fifo_enabled = true;
+  bool rx_irq_enabled = false;
+  uart_hw_t hw{{this}, {this}};
+};
+
+static uart_inst UART0;
+static uart_inst UART1;
+uart_inst_t *uart0 = &UART0;
+uart_inst_t *uart1 = &UART1;
+
+SerialUART Serial1;
+SerialUART Serial2;
+
+HostUartDr::operator uint32_t() {
+  if (this->uart->fifo.empty()) {
+    return 0;
+  }
+  RxChar rx = this->uart->fifo.front();
+  this->uart->fifo.pop_front();
+  this->uart->lin_break = rx.lin_break;
+  return rx.data;
+}
+
+HostUartRsr::operator uint32_t() { return this->uart->lin_break ? UART_UARTRSR_BE_BITS : 0; }
+
+void hw_clear_bits(HostUartRsr *reg, uint32_t mask) {
+  if (mask & UART_UARTRSR_BE_BITS) {
+    reg->uart->lin_break = false;
+  }
+}
+
+uart_hw_t *uart_get_hw(uart_inst_t *uart) { return &uart->hw; }
+bool uart_is_readable(uart_inst_t *uart) { return !uart->fifo.empty(); }
+void uart_set_fifo_enabled(uart_inst_t *uart, bool enabled) { uart->fifo_enabled = enabled; }
+void uart_set_irq_enables(uart_inst_t *uart, bool rx_has_data, bool tx_needs_data) {
+  (void) tx_needs_data;
+  uart->rx_irq_enabled = rx_has_data;
+}
+
+static irq_handler_t IRQ_HANDLERS[32];
+static bool IRQ_ENABLED[32];
+
+void irq_set_enabled(unsigned int num, bool enabled) { IRQ_ENABLED[num] = enabled; }
+irq_handler_t irq_get_exclusive_handler(unsigned int num) { return IRQ_HANDLERS[num]; }
+void irq_remove_handler(unsigned int num, irq_handler_t handler) {
+  if (IRQ_HANDLERS[num] == handler) {
+    IRQ_HANDLERS[num] = nullptr;
+  }
+}
+void irq_set_exclusive_handler(unsigned int num, irq_handler_t handler) { IRQ_HANDLERS[num] = handler; }
+
+void delay(unsigned long ms) { host::advance(ms * 1000); }
+
+namespace host {
+namespace rp2040 {
+
+void uart_receive(uart_inst_t *uart, const std::vector<uint8_t> &data, bool lin_break) {
+  for (size_t i = 0; i < data.size(); i++) {
+    uart->fifo.push_back(RxChar{data[i], lin_break && i == 0});
+  }
+}
+
+size_t uart_pending(uart_inst_t *uart) { return uart->fifo.size(); }
+
+bool raise_irq(unsigned int irq) {
+  if (!IRQ_ENABLED[irq] || IRQ_HANDLERS[irq] == nullptr) {
+    return false;
+  }
+  IRQ_HANDLERS[irq]();
+  return true;
+}
+
+bool uart_fifo_enabled(uart_inst_t *uart) { return uart->fifo_enabled; }
+bool uart_rx_irq_enabled(uart_inst_t *uart) { return uart->rx_irq_enabled; }
+
+}  // namespace rp2040
+}  // namespace host
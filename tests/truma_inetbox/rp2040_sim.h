@@ -0,0 +1,23 @@
+#pragma once
+// Simulated RP2040 UART and IRQ controller for the USE_RP2040 build of the listener.
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <hardware/irq.h>
+#include <hardware/uart.h>
+
+namespace host {
+namespace rp2040 {
+
+// Put `data` into the receive FIFO of `uart`. `lin_break` sets BE for the first byte (the 0x00 of a LIN BREAK).
+void uart_receive(uart_inst_t *uart, const std::vector<uint8_t> &data, bool lin_break = false);
+// Bytes still in the receive FIFO.
+size_t uart_pending(uart_inst_t *uart);
+// Run the handler of `irq` if it is enabled. Returns false if there is none.
+bool raise_irq(unsigned int irq);
+// FIFO and RX IRQ configuration as set by the listener.
+bool uart_fifo_enabled(uart_inst_t *uart);
+bool uart_rx_irq_enabled(uart_inst_t *uart);
+
+}  // namespace rp2040
+}  // namespace host
@@ -0,0 +1,50 @@
+#pragma once
+// Host stub: UART component interface as used by the component. See `host::FakeUART` for the test implementation.
+#include <cstddef>
+#include <cstdint>
+#include "esphome/core/component.h"
+
+namespace esphome {
+namespace uart {
+
+enum UARTParityOptions { UART_CONFIG_PARITY_NONE, UART_CONFIG_PARITY_EVEN, UART_CONFIG_PARITY_ODD };
+
+class UARTComponent {
+ public:
+  virtual ~UARTComponent() = default;
+  virtual void write_array(const uint8_t *data, size_t len) = 0;
+  virtual bool peek_byte(uint8_t *data) = 0;
+  virtual bool read_array(uint8_t *data, size_t len) = 0;
+  virtual int available() = 0;
+  virtual void flush() = 0;
+  uint32_t get_baud_rate() const { return this->baud_rate_; }
+  void set_baud_rate(uint32_t baud_rate) { this->baud_rate_ = baud_rate; }
+
+ protected:
+  uint32_t baud_rate_ = 9600;
+};
+
+class UARTDevice {
+ public:
+  void set_uart_parent(UARTComponent *parent) { this->parent_ = parent; }
+  void write_byte(uint8_t data) { this->parent_->write_array(&data, 1); }
+  void write_array(const uint8_t *data, size_t len) { this->parent_->write_array(data, len); }
+  void write(uint8_t data) { this->write_byte(data); }
+  bool read_byte(uint8_t *data) { return this->parent_->read_array(data, 1); }
+  bool read_array(uint8_t *data, size_t len) { return this->parent_->read_array(data, len); }
+  int available() { return this->parent_->available(); }
+  void flush() { this->parent_->flush(); }
+  void check_uart_settings(uint32_t baud_rate, uint8_t stop_bits = 1,
+                           UARTParityOptions parity = UART_CONFIG_PARITY_NONE, uint8_t data_bits = 8) {
+    (void) baud_rate;
+    (void) stop_bits;
+    (void) parity;
+    (void) data_bits;
+  }
+
+ protected:
+  UARTComponent *parent_{nullptr};
+};
+
+}  // namespace uart
+}  // namespace esphome
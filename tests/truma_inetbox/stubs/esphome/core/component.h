@@ -0,0 +1,60 @@
+#pragma once
+// Host stub: Component with intervals that the test runs by name (`call_interval`).
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <string>
+#include "esphome/core/hal.h"
+#include "esphome/core/helpers.h"
+
+namespace esphome {
+
+namespace setup_priority {
+const float DATA = 600.0f;
+}  // namespace setup_priority
+
+class GPIOPin {
+ public:
+  virtual ~GPIOPin() = default;
+  virtual void setup() {}
+  virtual bool digital_read() { return true; }
+  virtual void digital_write(bool value) { (void) value; }
+};
+
+class Component {
+ public:
+  virtual ~Component() = default;
+  virtual void setup() {}
+  virtual void loop() {}
+  virtual void dump_config() {}
+  virtual float get_setup_priority() const { return 0.0f; }
+  void mark_failed() { this->failed_ = true; }
+  bool is_failed() const { return this->failed_; }
+
+  // Test helper: run the interval callback registered as `name`. Returns false if there is none.
+  bool call_interval(const std::string &name) {
+    auto it = this->intervals_.find(name);
+    if (it == this->intervals_.end()) {
+      return false;
+    }
+    it->second();
+    return true;
+  }
+
+ protected:
+  void set_interval(const std::string &name, uint32_t interval, std::function<void()> &&f) {
+    (void) interval;
+    this->intervals_[name] = std::move(f);
+  }
+
+  bool failed_ = false;
+  std::map<std::string, std::function<void()>> intervals_;
+};
+
+class PollingComponent : public Component {
+ public:
+  virtual void update() = 0;
+  uint32_t get_update_interval() const { return 0; }
+};
+
+}  // namespace esphome
@@ -0,0 +1,11 @@
+#pragma once
+// Host stub: simulated clock, see `host::set_time` / `host::advance` in host.h.
+#include <cstdint>
+
+namespace esphome {
+uint32_t micros();
+uint32_t millis();
+void delay(uint32_t ms);
+// Advances the simulated clock instead of waiting.
+void delayMicroseconds(uint32_t us);
+}  // namespace esphome
@@ -0,0 +1,14 @@
+#pragma once
+// Host stub: the parts of esphome/core/helpers.h used by the component.
+#include <array>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <sys/types.h>
+#include "esphome/core/hal.h"
+
+namespace esphome {
+std::string str_snprintf(const char *fmt, size_t len, ...);
+}  // namespace esphome
@@ -0,0 +1,40 @@
+#pragma once
+// Host stub: the FreeRTOS API used by the component. Queues work (no blocking), task notifications are recorded
+// on the target handle so a test can check them.
+#include <atomic>
+#include <climits>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+
+typedef uint32_t TickType_t;
+typedef int BaseType_t;
+typedef unsigned int UBaseType_t;
+
+#define pdFALSE 0
+#define pdTRUE 1
+#define pdPASS pdTRUE
+#define pdFAIL pdFALSE
+#define errQUEUE_FULL 0
+#define portMAX_DELAY ((TickType_t) 0xffffffffUL)
+#define pdMS_TO_TICKS(ms) ((TickType_t) (ms))
+
+struct HostQueue {
+  std::mutex lock;
+  uint8_t *storage = nullptr;
+  UBaseType_t length = 0;
+  UBaseType_t item_size = 0;
+  UBaseType_t head = 0;
+  UBaseType_t count = 0;
+};
+typedef HostQueue StaticQueue_t;
+typedef HostQueue *QueueHandle_t;
+
+struct HostTask {
+  std::atomic<uint32_t> notified_bits{0};
+  std::atomic<uint32_t> notify_count{0};
+};
+typedef HostTask *TaskHandle_t;
+
+#include "queue.h"
+#include "task.h"
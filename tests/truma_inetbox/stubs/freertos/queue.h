@@ -0,0 +1,46 @@
+#pragma once
+#include "FreeRTOS.h"
+
+inline QueueHandle_t xQueueCreateStatic(UBaseType_t length, UBaseType_t item_size, uint8_t *storage,
+                                        StaticQueue_t *queue) {
+  queue->storage = storage;
+  queue->length = length;
+  queue->item_size = item_size;
+  queue->head = 0;
+  queue->count = 0;
+  return queue;
+}
+
+inline BaseType_t xQueueSend(QueueHandle_t queue, const void *item, TickType_t ticks_to_wait) {
+  (void) ticks_to_wait;
+  std::lock_guard<std::mutex> guard(queue->lock);
+  if (queue->count >= queue->length) {
+    return errQUEUE_FULL;
+  }
+  UBaseType_t pos = (queue->head + queue->count) % queue->length;
+  memcpy(queue->storage + pos * queue->item_size, item, queue->item_size);
+  queue->count++;
+  return pdPASS;
+}
+
+inline BaseType_t xQueueSendFromISR(QueueHandle_t queue, const void *item, BaseType_t *higher_priority_task_woken) {
+  (void) higher_priority_task_woken;
+  return xQueueSend(queue, item, 0);
+}
+
+inline BaseType_t xQueueReceive(QueueHandle_t queue, void *item, TickType_t ticks_to_wait) {
+  (void) ticks_to_wait;
+  std::lock_guard<std::mutex> guard(queue->lock);
+  if (queue->count == 0) {
+    return pdFALSE;
+  }
+  memcpy(item, queue->storage + queue->head * queue->item_size, queue->item_size);
+  queue->head = (queue->head + 1) % queue->length;
+  queue->count--;
+  return pdPASS;
+}
+
+inline UBaseType_t uxQueueMessagesWaiting(QueueHandle_t queue) {
+  std::lock_guard<std::mutex> guard(queue->lock);
+  return queue->count;
+}
@@ -0,0 +1,41 @@
+#pragma once
+#include "FreeRTOS.h"
+
+enum eNotifyAction { eNoAction, eSetBits, eIncrement };
+
+inline BaseType_t xTaskNotify(TaskHandle_t task, uint32_t value, eNotifyAction action) {
+  if (action == eSetBits) {
+    task->notified_bits.fetch_or(value);
+  }
+  task->notify_count++;
+  return pdPASS;
+}
+
+inline void vTaskNotifyGiveFromISR(TaskHandle_t task, BaseType_t *higher_priority_task_woken) {
+  (void) higher_priority_task_woken;
+  task->notify_count++;
+}
+
+// There is no scheduler: the caller drains what is there and never waits for more.
+inline BaseType_t xTaskNotifyWait(uint32_t clear_on_entry, uint32_t clear_on_exit, uint32_t *value,
+                                  TickType_t ticks_to_wait) {
+  (void) clear_on_entry;
+  (void) clear_on_exit;
+  (void) value;
+  (void) ticks_to_wait;
+  return pdFALSE;
+}
+
+inline void vTaskDelay(TickType_t ticks) { (void) ticks; }
+
+#define portYIELD_FROM_ISR(x) (void) (x)
+
+// The task running the test.
+TaskHandle_t xTaskGetCurrentTaskHandle();
+inline uint32_t ulTaskNotifyTake(BaseType_t clear_on_exit, TickType_t ticks_to_wait) {
+  (void) ticks_to_wait;
+  TaskHandle_t task = xTaskGetCurrentTaskHandle();
+  uint32_t count = task->notify_count;
+  task->notify_count = clear_on_exit ? 0 : (count > 0 ? count - 1 : 0);
+  return count;
+}
@@ -0,0 +1,13 @@
+#pragma once
+// Host stub: arduino-pico hardware serial ports, compared by identity.
+#include <cstdint>
+
+class SerialUART {
+ public:
+  bool operator==(const SerialUART &other) const { return this == &other; }
+};
+extern SerialUART Serial1;
+extern SerialUART Serial2;
+
+// Arduino core
+void delay(unsigned long ms);
@@ -0,0 +1,20 @@
+#pragma once
+// Host stub: ESPHome RP2040 UART component on top of the in memory UART.
+#include <SerialUART.h>
+#include "fake_uart.h"
+
+namespace esphome {
+namespace uart {
+
+class RP2040UartComponent : public host::FakeUART {
+ public:
+  bool is_hw_serial() { return true; }
+  SerialUART *get_hw_serial() { return this->hw_serial_; }
+  void set_hw_serial(SerialUART *hw_serial) { this->hw_serial_ = hw_serial; }
+
+ protected:
+  SerialUART *hw_serial_ = &Serial1;
+};
+
+}  // namespace uart
+}  // namespace esphome
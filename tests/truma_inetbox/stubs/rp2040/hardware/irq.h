@@ -0,0 +1,9 @@
+#pragma once
+// Host stub: pico-sdk IRQ handler registration. `host::rp2040::raise_irq` runs the registered handler.
+typedef void (*irq_handler_t)(void);
+enum { UART0_IRQ = 20, UART1_IRQ = 21 };
+
+void irq_set_enabled(unsigned int num, bool enabled);
+irq_handler_t irq_get_exclusive_handler(unsigned int num);
+void irq_remove_handler(unsigned int num, irq_handler_t handler);
+void irq_set_exclusive_handler(unsigned int num, irq_handler_t handler);
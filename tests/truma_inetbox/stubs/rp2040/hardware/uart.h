@@ -0,0 +1,30 @@
+#pragma once
+// Host stub: pico-sdk UART as used by LinBusListener_rp2040.cpp. The test feeds the receive FIFO
+// (`host::rp2040::uart_receive`); reading DR pops a byte, RSR reports the break flag of the byte just read.
+#include <cstdint>
+
+typedef struct uart_inst uart_inst_t;
+
+struct HostUartDr {
+  uart_inst_t *uart;
+  operator uint32_t();
+};
+struct HostUartRsr {
+  uart_inst_t *uart;
+  operator uint32_t();
+};
+typedef struct {
+  HostUartDr dr;
+  HostUartRsr rsr;
+} uart_hw_t;
+
+#define UART_UARTRSR_BE_BITS 0x00000004
+
+extern uart_inst_t *uart0;
+extern uart_inst_t *uart1;
+
+uart_hw_t *uart_get_hw(uart_inst_t *uart);
+bool uart_is_readable(uart_inst_t *uart);
+void uart_set_fifo_enabled(uart_inst_t *uart, bool enabled);
+void uart_set_irq_enables(uart_inst_t *uart, bool rx_has_data, bool tx_needs_data);
+void hw_clear_bits(HostUartRsr *reg, uint32_t mask);
@@ -0,0 +1,3 @@
+#pragma once
+// Host stub: arduino-pico includes the FreeRTOS headers without the freertos/ prefix.
+#include <freertos/queue.h>
@@ -0,0 +1,31 @@
+#pragma once
+// Minimal checks for the host tests: failures are counted and reported, the test keeps running.
+#include <cstdio>
+
+namespace test {
+extern int checks;
+extern int failures;
+// Print the result, returns the exit code for `main`.
+int summary(const char *name);
+}  // namespace test
+
+#define CHECK(cond) \
+  do { \
+    test::checks++; \
+    if (!(cond)) { \
+      test::failures++; \
+      fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); \
+    } \
+  } while (0)
+
+#define CHECK_EQ(actual, expected) \
+  do { \
+    test::checks++; \
+    long long actual_ = (long long) (actual); \
+    long long expected_ = (long long) (expected); \
+    if (actual_ != expected_) { \
+      test::failures++; \
+      fprintf(stderr, "%s:%d: CHECK_EQ(%s, %s) failed: %lld != %lld\n", __FILE__, __LINE__, #actual, #expected, \
+              actual_, expected_); \
+    } \
+  } while (0)
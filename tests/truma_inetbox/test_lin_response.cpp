@@ -0,0 +1,94 @@
+// Response timing in simulated time: the answer is held until the response space after the PID has passed and the
+// histogram records the offset at which the answer went out.
+#include "host.h"
+#include "test.h"
+
+#define BYTE_US 1146
+#define RESPONSE_SPACE_US 500
+
+static const std::vector<uint8_t> ANSWER = {1, 2, 3, 4, 5, 6, 7, 8};
+
+// One UART event per byte, the reader runs `latency` after the event was taken. Returns the event time of the PID.
+static uint32_t receive_header(host::FakeUART *uart, host::TestListener *listener, uint8_t pid, uint32_t latency) {
+  uint32_t received = 0;
+  for (uint8_t data : host::lin_header(pid)) {
+    uart->receive({data});
+    received = host::time();
+    host::advance(latency);
+    listener->onReceive(received);
+    host::advance(BYTE_US);
+  }
+  return received;
+}
+
+// The response space counts from the UART event of the PID, not from the time the reader got to it.
+static void test_response_space_from_event() {
+  host::FakeUART uart;
+  host::TestListener listener;
+  listener.set_response_space(RESPONSE_SPACE_US);
+  listener.begin(&uart);
+  listener.answer(0x18, ANSWER);
+
+  uint32_t pid_time = receive_header(&uart, &listener, 0x18, 100);
+  CHECK_EQ(uart.tx.size(), 9);
+  CHECK_EQ(uart.tx[0].time, pid_time + RESPONSE_SPACE_US);
+  const esphome::truma_inetbox::LinBusResponseHistogram &hist = listener.get_response_offsets();
+  CHECK_EQ(hist.count, 1);
+  CHECK_EQ(hist.sum_us, RESPONSE_SPACE_US);
+  CHECK_EQ(hist.buckets[RESPONSE_SPACE_US / TRUMA_RESPONSE_HISTOGRAM_BUCKET_US], 1);
+}
+
+// A reader later than the response space answers at once. The histogram shows the real offset.
+static void test_late_reader_recorded() {
+  host::FakeUART uart;
+  host::TestListener listener;
+  listener.set_response_space(RESPONSE_SPACE_US);
+  listener.begin(&uart);
+  listener.answer(0x18, ANSWER);
+
+  uint32_t pid_time = receive_header(&uart, &listener, 0x18, 700);
+  CHECK_EQ(uart.tx.size(), 9);
+  CHECK_EQ(uart.tx[0].time, pid_time + 700);
+  CHECK_EQ(listener.get_response_offsets().count, 1);
+  CHECK_EQ(listener.get_response_offsets().max_us, 700);
+}
+
+// The whole header in one read: the PID is the last waiting byte and arrived at the event time.
+static void test_header_in_one_read() {
+  host::FakeUART uart;
+  host::TestListener listener;
+  listener.set_response_space(RESPONSE_SPACE_US);
+  listener.begin(&uart);
+  listener.answer(0x18, ANSWER);
+
+  host::advance(3 * BYTE_US);
+  uart.receive(host::lin_header(0x18));
+  uint32_t received = host::time();
+  host::advance(200);
+  listener.onReceive(received);
+  CHECK_EQ(uart.tx.size(), 9);
+  CHECK_EQ(uart.tx[0].time, received + RESPONSE_SPACE_US);
+}
+
+// Observer mode never answers and records nothing.
+static void test_observer_silent() {
+  host::FakeUART uart;
+  host::TestListener listener;
+  listener.set_response_space(RESPONSE_SPACE_US);
+  listener.set_observer_mode(true);
+  listener.begin(&uart);
+  listener.answer(0x18, ANSWER);
+
+  receive_header(&uart, &listener, 0x18, 0);
+  CHECK_EQ(uart.tx.size(), 0);
+  CHECK_EQ(listener.get_response_offsets().count, 0);
+}
+
+int main() {
+  host::set_time(1000 * 1000);
+  test_response_space_from_event();
+  test_late_reader_recorded();
+  test_header_in_one_read();
+  test_observer_silent();
+  return test::summary("test_lin_response");
+}
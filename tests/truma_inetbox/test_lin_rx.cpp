@@ -0,0 +1,68 @@
+// Receive path: frames through `onReceive_` / `read_lin_frame_` into the LIN message ring.
+#include "host.h"
+#include "test.h"
+
+// Frame `i` of a multi PDU request: consecutive frame with sequence number in the PCI.
+static std::vector<uint8_t> diag_frame(uint8_t i) {
+  return host::lin_frame(DIAGNOSTIC_FRAME_MASTER, {0x03, (uint8_t) (i == 0 ? 0x10 : 0x20 | (i & 0x0F)), i, i, i, i, i,
+                                                   i}, true);
+}
+
+// A multi PDU request arrives as a burst of 11 frames on 0x3C. None may be lost, also when the UART task reads
+// the whole burst at once.
+static void test_multi_pdu_burst(bool one_read) {
+  host::FakeUART uart;
+  host::TestListener listener;
+  listener.begin(&uart);
+
+  for (uint8_t i = 0; i < 11; i++) {
+    uart.receive(diag_frame(i));
+    if (!one_read) {
+      listener.onReceive();
+    }
+    host::advance(12 * 1146);
+  }
+  if (one_read) {
+    listener.onReceive();
+  }
+  listener.process_lin_msg_queue();
+
+  CHECK_EQ(listener.messages.size(), 11);
+  CHECK_EQ(listener.get_lin_msg_dropped(), 0);
+  for (uint8_t i = 0; i < listener.messages.size(); i++) {
+    CHECK_EQ(listener.messages[i].pid, DIAGNOSTIC_FRAME_MASTER);
+    std::vector<uint8_t> frame = diag_frame(i);
+    CHECK(listener.messages[i].data == std::vector<uint8_t>(frame.begin() + 3, frame.end() - 1));
+  }
+}
+
+// The LIN message task does not keep up: the ring keeps the oldest frames, the rest is counted as dropped.
+static void test_ring_overflow_counted() {
+  host::FakeUART uart;
+  host::TestListener listener;
+  listener.begin(&uart);
+
+  const uint8_t frames = TRUMA_MSG_QUEUE_LENGTH + 4;
+  for (uint8_t i = 0; i < frames; i++) {
+    uart.receive(diag_frame(i));
+    listener.onReceive();
+  }
+  CHECK_EQ(listener.get_lin_msg_dropped(), 4);
+  listener.process_lin_msg_queue();
+  CHECK_EQ(listener.messages.size(), TRUMA_MSG_QUEUE_LENGTH);
+  CHECK_EQ(listener.messages.back().data[2], TRUMA_MSG_QUEUE_LENGTH - 1);
+
+  // Room again after the drain.
+  uart.receive(diag_frame(0));
+  listener.onReceive();
+  listener.process_lin_msg_queue();
+  CHECK_EQ(listener.messages.size(), TRUMA_MSG_QUEUE_LENGTH + 1);
+  CHECK_EQ(listener.get_lin_msg_dropped(), 4);
+}
+
+int main() {
+  test_multi_pdu_burst(false);
+  test_multi_pdu_burst(true);
+  test_ring_overflow_counted();
+  return test::summary("test_lin_rx");
+}
@@ -0,0 +1,148 @@
+// LinBusRingBuffer: single thread semantics and a producer / consumer stress test with flush requests.
+#include <atomic>
+#include <initializer_list>
+#include <thread>
+#include "LinBusRingBuffer.h"
+#include "test.h"
+
+using esphome::truma_inetbox::LinBusRingBuffer;
+
+// Every word carries the sequence number, a torn read shows up as a mismatch.
+struct Item {
+  uint32_t seq;
+  uint32_t payload[15];
+};
+
+static void test_basic() {
+  LinBusRingBuffer<uint32_t, 4> ring;
+  uint32_t v;
+  CHECK(ring.empty());
+  CHECK(!ring.pop(&v));
+  for (uint32_t i = 0; i < 4; i++) {
+    CHECK(ring.push(i));
+  }
+  CHECK(ring.full());
+  CHECK(!ring.push(4));
+  CHECK_EQ(ring.overflow_count(), 1);
+  CHECK_EQ(ring.size(), 4);
+  CHECK(ring.pop(&v));
+  CHECK_EQ(v, 0);
+  CHECK(ring.push(5));
+  for (uint32_t expected : {1, 2, 3, 5}) {
+    CHECK(ring.pop(&v));
+    CHECK_EQ(v, expected);
+  }
+  CHECK(ring.empty());
+}
+
+static void test_flush() {
+  LinBusRingBuffer<uint32_t, 4> ring;
+  uint32_t v;
+  for (uint32_t i = 0; i < 4; i++) {
+    ring.push(i);
+  }
+  ring.flush();
+  // Flushed entries do not count, but keep their slots until the consumer skipped them.
+  CHECK_EQ(ring.size(), 0);
+  CHECK(ring.full());
+  CHECK(!ring.push(10));
+  CHECK_EQ(ring.overflow_count(), 1);
+  CHECK(ring.empty());
+  CHECK(!ring.full());
+  CHECK(ring.push(11));
+  CHECK(ring.push(12));
+  CHECK_EQ(ring.size(), 2);
+  CHECK(ring.pop(&v));
+  CHECK_EQ(v, 11);
+
+  // Flush while the consumer holds a slot: the slot is not handed to the producer before it is released.
+  uint32_t *held = ring.read_slot();
+  CHECK(held != nullptr && *held == 12);
+  ring.flush();
+  CHECK(ring.push(13));
+  CHECK(ring.push(14));
+  CHECK(ring.push(15));
+  CHECK(!ring.push(16));
+  CHECK_EQ(*held, 12);
+  ring.release();
+  for (uint32_t expected : {13, 14, 15}) {
+    CHECK(ring.pop(&v));
+    CHECK_EQ(v, expected);
+  }
+  CHECK(ring.empty());
+}
+
+static void test_stress() {
+  static LinBusRingBuffer<Item, 8> ring;
+  const uint32_t items = 200000;
+  std::atomic<bool> done{false};
+  std::atomic<uint32_t> last_flush{0};
+  uint32_t torn = 0, out_of_order = 0, delivered = 0, flushed_delivered = 0;
+
+  std::thread consumer([&]() {
+    uint32_t last = 0;
+    bool have_last = false;
+    for (;;) {
+      // Sequence numbers below this were flushed before the access below started.
+      uint32_t flushed_below = last_flush.load(std::memory_order_acquire);
+      Item *item = ring.read_slot();
+      if (item == nullptr) {
+        if (done.load(std::memory_order_acquire) && ring.empty()) {
+          break;
+        }
+        std::this_thread::yield();
+        continue;
+      }
+      uint32_t seq = item->seq;
+      for (uint32_t w : item->payload) {
+        if (w != seq) {
+          torn++;
+          break;
+        }
+      }
+      if (have_last && seq <= last) {
+        out_of_order++;
+      }
+      if (seq < flushed_below) {
+        flushed_delivered++;
+      }
+      last = seq;
+      have_last = true;
+      delivered++;
+      ring.release();
+    }
+  });
+
+  uint32_t pushed = 0;
+  for (uint32_t seq = 1; seq <= items; seq++) {
+    Item *slot;
+    while ((slot = ring.write_slot()) == nullptr) {
+      std::this_thread::yield();
+    }
+    slot->seq = seq;
+    for (uint32_t &w : slot->payload) {
+      w = seq;
+    }
+    ring.commit();
+    pushed++;
+    if (seq % 97 == 0) {
+      ring.flush();
+      last_flush.store(seq + 1, std::memory_order_release);
+    }
+  }
+  done.store(true, std::memory_order_release);
+  consumer.join();
+
+  CHECK_EQ(torn, 0);
+  CHECK_EQ(out_of_order, 0);
+  CHECK_EQ(flushed_delivered, 0);
+  CHECK(delivered > 0 && delivered <= pushed);
+  printf("ring stress: %u pushed, %u delivered, %u flushed\n", pushed, delivered, pushed - delivered);
+}
+
+int main() {
+  test_basic();
+  test_flush();
+  test_stress();
+  return test::summary("test_ring_buffer");
+}
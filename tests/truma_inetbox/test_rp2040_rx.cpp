@@ -0,0 +1,139 @@
+// RP2040 receive path: the UART IRQ timestamps the bytes into `rx_ring_`, `loop1` on core 1 runs the LIN state
+// machine. The IRQ is raised by the test, one character time apart, like the UART with the FIFO turned off.
+#include "esphome/components/uart/uart_component_rp2040.h"
+#include "host.h"
+#include "rp2040_sim.h"
+#include "test.h"
+
+void loop1();
+
+#define BYTE_US 1146
+
+class TestPin : public esphome::GPIOPin {
+ public:
+  bool digital_read() override { return this->level; }
+  bool level = true;
+};
+
+// One IRQ per received byte. Returns the time of the IRQ for the last byte.
+static uint32_t irq_bytes(const std::vector<uint8_t> &data, bool lin_break = true) {
+  uint32_t last = 0;
+  for (size_t i = 0; i < data.size(); i++) {
+    host::rp2040::uart_receive(uart0, {data[i]}, lin_break && i == 0);
+    last = host::time();
+    host::rp2040::raise_irq(UART0_IRQ);
+    host::advance(BYTE_US);
+  }
+  return last;
+}
+
+static void test_irq_per_byte() {
+  esphome::uart::RP2040UartComponent uart;
+  host::TestListener listener;
+  listener.begin(&uart);
+  CHECK(!host::rp2040::uart_fifo_enabled(uart0));
+  CHECK(host::rp2040::uart_rx_irq_enabled(uart0));
+
+  loop1();
+  std::vector<uint8_t> frame = host::lin_frame(0x21, {1, 2, 3, 4, 5, 6, 7, 8});
+  irq_bytes(frame);
+  CHECK(xTaskGetCurrentTaskHandle()->notify_count > 0);
+  loop1();
+  CHECK_EQ(xTaskGetCurrentTaskHandle()->notify_count, 0);
+
+  CHECK_EQ(listener.messages.size(), 1);
+  CHECK_EQ(listener.messages[0].pid, 0x21);
+  CHECK(listener.messages[0].data == std::vector<uint8_t>(frame.begin() + 3, frame.end() - 1));
+  CHECK_EQ(listener.get_uart_rx_dropped(), 0);
+}
+
+// The response space counts from the IRQ time of the PID, not from the time core 1 got to it.
+static void test_response_from_irq_time() {
+  esphome::uart::RP2040UartComponent uart;
+  host::TestListener listener;
+  listener.set_response_space(500);
+  listener.begin(&uart);
+  listener.answer(0x18, {1, 2, 3, 4, 5, 6, 7, 8});
+
+  uint32_t pid_time = irq_bytes(host::lin_header(0x18));
+  // Core 1 is busy for a while.
+  host::advance(300 - BYTE_US);
+  loop1();
+  CHECK_EQ(uart.tx.size(), 9);
+  CHECK_EQ(uart.tx[0].time, pid_time + 500);
+}
+
+// Core 1 does not drain the ring: bytes beyond its length are lost and counted.
+static void test_ring_overflow_counted() {
+  esphome::uart::RP2040UartComponent uart;
+  host::TestListener listener;
+  listener.begin(&uart);
+
+  host::rp2040::uart_receive(uart0, std::vector<uint8_t>(TRUMA_RX_RING_LENGTH + 6, 0xFF));
+  host::rp2040::raise_irq(UART0_IRQ);
+  CHECK_EQ(host::rp2040::uart_pending(uart0), 0);
+  CHECK_EQ(listener.get_uart_rx_dropped(), 6);
+  loop1();
+
+  // Room again after the drain.
+  host::advance(10 * 1000);
+  irq_bytes(host::lin_frame(0x21, {1, 2, 3, 4, 5, 6, 7, 8}));
+  loop1();
+  CHECK_EQ(listener.messages.size(), 1);
+  CHECK_EQ(listener.get_uart_rx_dropped(), 6);
+}
+
+// BE on the 0x00 of a BREAK starts a new frame, even within the inter byte timeout of a cut off frame.
+static void test_break_restarts_frame() {
+  esphome::uart::RP2040UartComponent uart;
+  host::TestListener listener;
+  listener.begin(&uart);
+
+  std::vector<uint8_t> cut = host::lin_header(0x21);
+  cut.insert(cut.end(), {1, 2, 3});
+  irq_bytes(cut);
+  std::vector<uint8_t> frame = host::lin_frame(0x21, {8, 7, 6, 5, 4, 3, 2, 1});
+  irq_bytes(frame);
+  loop1();
+
+  CHECK_EQ(listener.messages.size(), 1);
+  CHECK(!listener.messages.empty() &&
+        listener.messages.back().data == std::vector<uint8_t>(frame.begin() + 3, frame.end() - 1));
+}
+
+// Bytes received during a LIN bus fault are flushed by core 1, the IRQ keeps writing to the ring.
+static void test_fault_flushes_ring() {
+  esphome::uart::RP2040UartComponent uart;
+  host::TestListener listener;
+  TestPin fault_pin;
+  listener.set_fault_pin(&fault_pin);
+  listener.begin(&uart);
+
+  fault_pin.level = false;
+  for (int i = 0; i < 4; i++) {
+    listener.update();
+  }
+  CHECK(listener.get_lin_bus_fault());
+  irq_bytes(host::lin_frame(0x21, {1, 2, 3, 4, 5, 6, 7, 8}));
+  loop1();
+
+  fault_pin.level = true;
+  listener.update();
+  CHECK(!listener.get_lin_bus_fault());
+  loop1();
+  CHECK_EQ(listener.messages.size(), 0);
+
+  host::advance(10 * 1000);
+  irq_bytes(host::lin_frame(0x21, {1, 2, 3, 4, 5, 6, 7, 8}));
+  loop1();
+  CHECK_EQ(listener.messages.size(), 1);
+}
+
+int main() {
+  test_irq_per_byte();
+  test_response_from_irq_time();
+  test_ring_overflow_counted();
+  test_break_restarts_frame();
+  test_fault_flushes_ring();
+  return test::summary("test_rp2040_rx");
+}
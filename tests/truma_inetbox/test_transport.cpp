@@ -0,0 +1,182 @@
+// LinBusTransport: segmentation and reassembly for every message length, sequence and timeout errors (N_Cr, N_As),
+// the shared pool buffer for long messages.
+#include <array>
+#include <cstring>
+#include <vector>
+#include "LinBusTransport.h"
+#include "test.h"
+
+using esphome::truma_inetbox::LinBusTransport;
+
+#define NAD 0x03
+// Time between two frames of a message, well below TRUMA_TRANSPORT_TIMEOUT_US.
+#define FRAME_US 10000
+
+static std::vector<u_int8_t> make_message(u_int16_t len) {
+  std::vector<u_int8_t> message(len);
+  for (u_int16_t i = 0; i < len; i++) {
+    message[i] = (u_int8_t) (i * 7 + len);
+  }
+  return message;
+}
+
+// Expected number of frames: single frame up to 6 bytes, otherwise first frame (5 bytes) and consecutive frames.
+static size_t frame_count(u_int16_t len) { return len <= 6 ? 1 : 1 + (len - 5 + 5) / 6; }
+
+// Send `len` bytes through one transport and reassemble them in another. The sender hands its pool buffer back
+// before the receiver takes one, the pool has a single buffer.
+static bool round_trip(LinBusTransport *tx, LinBusTransport *rx, u_int16_t len) {
+  std::vector<u_int8_t> message = make_message(len);
+  std::vector<std::array<u_int8_t, 8>> frames;
+  if (!tx->start_response(NAD, message[0], &message[1], len - 1, 0)) {
+    return false;
+  }
+  std::array<u_int8_t, 8> frame;
+  while (tx->next_response_frame(&frame)) {
+    frames.push_back(frame);
+  }
+  if (!tx->response_generated() || frames.size() != frame_count(len)) {
+    return false;
+  }
+  tx->response_sent();
+  if (tx->has_pool_buffer()) {
+    return false;
+  }
+
+  if (len <= 6) {
+    // Single frame, handled by LinBusProtocol without the transport.
+    return frames[0][0] == NAD && frames[0][1] == len && memcmp(&frames[0][2], message.data(), len) == 0;
+  }
+  bool complete = false;
+  uint32_t now = 0;
+  for (const auto &f : frames) {
+    if (complete) {
+      return false;
+    }
+    if ((f[1] & 0xF0) == 0x10) {
+      rx->on_new_request();
+    }
+    now += FRAME_US;
+    complete = rx->on_request_frame(f.data(), now);
+  }
+  bool ok = complete && rx->message_len() == len && memcmp(rx->message(), message.data(), len) == 0;
+  rx->abort_request();
+  return ok && !rx->has_pool_buffer();
+}
+
+static void test_round_trip() {
+  LinBusTransport tx, rx;
+  u_int16_t failed = 0;
+  for (u_int16_t len = 1; len <= TRUMA_TRANSPORT_MAX_MESSAGE_LENGTH; len++) {
+    if (!round_trip(&tx, &rx, len)) {
+      if (failed == 0) {
+        fprintf(stderr, "round trip of %u bytes failed\n", len);
+      }
+      failed++;
+    }
+  }
+  CHECK_EQ(failed, 0);
+  CHECK_EQ(tx.get_counters().tx_messages, TRUMA_TRANSPORT_MAX_MESSAGE_LENGTH);
+  CHECK_EQ(rx.get_counters().rx_messages, TRUMA_TRANSPORT_MAX_MESSAGE_LENGTH - 6);
+  CHECK_EQ(rx.get_counters().rx_abort_buffer, 0);
+}
+
+static void test_sequence() {
+  LinBusTransport rx;
+  const u_int8_t first[8] = {NAD, 0x10, 20, 1, 2, 3, 4, 5};
+  const u_int8_t second[8] = {NAD, 0x22, 0, 0, 0, 0, 0, 0};
+  CHECK(!rx.on_request_frame(first, 0));
+  CHECK(!rx.on_request_frame(second, FRAME_US));
+  CHECK_EQ(rx.get_counters().rx_abort_sequence, 1);
+  CHECK_EQ(rx.message_len(), 0);
+  // The rest of the dropped request is ignored.
+  const u_int8_t third[8] = {NAD, 0x23, 0, 0, 0, 0, 0, 0};
+  CHECK(!rx.on_request_frame(third, 2 * FRAME_US));
+  CHECK_EQ(rx.get_counters().rx_abort_sequence, 1);
+
+  // 12 bit length, the sequence number wraps after 15.
+  const u_int8_t long_first[8] = {NAD, 0x11, 0x00, 1, 2, 3, 4, 5};
+  CHECK(!rx.on_request_frame(long_first, 0));
+  CHECK(rx.has_pool_buffer());
+  bool complete = false;
+  u_int8_t consecutive = 0;
+  while (!complete && consecutive < 60) {
+    consecutive++;
+    const u_int8_t frame[8] = {NAD, (u_int8_t) (0x20 | (consecutive & 0x0F)), 1, 1, 1, 1, 1, 1};
+    complete = rx.on_request_frame(frame, consecutive * FRAME_US);
+  }
+  CHECK(complete);
+  CHECK_EQ(consecutive, 42);
+  CHECK_EQ(rx.message_len(), 256);
+}
+
+static void test_timeouts() {
+  // N_Cr: consecutive frame too late.
+  LinBusTransport rx;
+  const u_int8_t first[8] = {NAD, 0x10, 20, 1, 2, 3, 4, 5};
+  const u_int8_t second[8] = {NAD, 0x21, 0, 0, 0, 0, 0, 0};
+  CHECK(!rx.on_request_frame(first, 0));
+  CHECK(!rx.on_request_frame(second, TRUMA_TRANSPORT_TIMEOUT_US + 1));
+  CHECK_EQ(rx.get_counters().rx_abort_timeout, 1);
+  CHECK_EQ(rx.message_len(), 0);
+  // In time after a new first frame, also across the 32 bit wrap of `micros()`.
+  const uint32_t start = 0xFFFFFFFF - FRAME_US / 2;
+  CHECK(!rx.on_request_frame(first, start));
+  CHECK(!rx.on_request_frame(second, start + FRAME_US));
+  CHECK_EQ(rx.get_counters().rx_abort_timeout, 1);
+
+  // N_As: the master stops fetching the response. Fetched frames restart the supervision.
+  LinBusTransport tx;
+  std::vector<u_int8_t> message = make_message(20);
+  CHECK(tx.start_response(NAD, 0xFB, message.data(), message.size(), 0));
+  CHECK(!tx.check_response_timeout(TRUMA_TRANSPORT_TIMEOUT_US / 2));
+  tx.response_progress(TRUMA_TRANSPORT_TIMEOUT_US / 2);
+  CHECK(!tx.check_response_timeout(TRUMA_TRANSPORT_TIMEOUT_US));
+  CHECK(tx.response_pending());
+  CHECK(tx.check_response_timeout(TRUMA_TRANSPORT_TIMEOUT_US * 3 / 2 + 1));
+  CHECK(!tx.response_pending());
+  CHECK_EQ(tx.get_counters().tx_abort_timeout, 1);
+  CHECK(!tx.check_response_timeout(TRUMA_TRANSPORT_TIMEOUT_US * 3));
+  CHECK_EQ(tx.get_counters().tx_abort_timeout, 1);
+}
+
+static void test_pool() {
+  LinBusTransport first, second;
+  std::vector<u_int8_t> message = make_message(TRUMA_TRANSPORT_INLINE_LENGTH + 1);
+  // Short messages stay inline.
+  CHECK(first.start_response(NAD, 0xFB, message.data(), TRUMA_TRANSPORT_INLINE_LENGTH - 1, 0));
+  CHECK(!first.has_pool_buffer());
+  // The only pool buffer goes to the first long message.
+  CHECK(first.start_response(NAD, 0xFB, message.data(), message.size(), 0));
+  CHECK(first.has_pool_buffer());
+  CHECK(!second.start_response(NAD, 0xFB, message.data(), message.size(), 0));
+  CHECK(!second.response_pending());
+  CHECK_EQ(second.get_counters().tx_abort_buffer, 1);
+  const u_int8_t long_first[8] = {NAD, 0x11, 0x00, 1, 2, 3, 4, 5};
+  CHECK(!second.on_request_frame(long_first, 0));
+  CHECK_EQ(second.get_counters().rx_abort_buffer, 1);
+  // A new request drops the response and frees the buffer.
+  CHECK(first.on_new_request());
+  CHECK(!first.has_pool_buffer());
+  CHECK(!second.on_request_frame(long_first, 0));
+  CHECK(second.has_pool_buffer());
+  // A long response may be built from the long request in the same buffer.
+  CHECK(second.start_response(NAD, 0xFB, second.message() + 1, 100, 0));
+  CHECK(second.has_pool_buffer());
+  std::array<u_int8_t, 8> frame;
+  CHECK(second.next_response_frame(&frame));
+  CHECK_EQ(frame[1], 0x10);
+  CHECK_EQ(frame[2], 101);
+  CHECK_EQ(frame[3], 0xFB);
+  CHECK_EQ(frame[4], 2);
+  second.reset();
+  CHECK(!second.has_pool_buffer());
+}
+
+int main() {
+  test_round_trip();
+  test_sequence();
+  test_timeouts();
+  test_pool();
+  return test::summary("test_transport");
+}
@@ -0,0 +1,103 @@
+#!/usr/bin/env python3
+"""
+gzip-komprimierte OTA-Images für den LIN-Proxy
+
+  ota_compress.py compress <firmware.bin> <firmware.bin.gz>   (läuft nach jedem Build)
+  ota_compress.py check <firmware.bin.gz> <firmware.bin> [--chunks 1436,16384,...]
+
+Der ESP32 dekomprimiert mit einem festen Fenster von 2^OTA_GZ_WINDOW_BITS Byte
+(config.h, Default 12 = 4 KB). Das Image muss deshalb mit demselben Fenster
+komprimiert werden; gzip/zlib mit Standard-Fenster (32 KB) funktioniert nicht.
+
+"check" dekomprimiert das Image in genau den Stückelungen, die beim Empfang
+auftreten (TCP-Segmente, OTA_BUF_SIZE, Slices), mit dem gleichen Fenster wie
+auf dem Gerät und vergleicht das Ergebnis mit dem Original. Dekodiert wird mit
+zlib; src/ota_gz.c mit dem ROM-tinfl (miniz 1.15) des ESP32 prüft
+tests/ota_gz (make test MINIZ_DIR=...).
+"""
+
+import argparse
+import hashlib
+import sys
+import zlib
+from pathlib import Path
+
+WINDOW_BITS = 12
+# Typische Stückelungen: 1 Byte (Extremfall), TCP-MSS, Slice, OTA_BUF_SIZE
+DEFAULT_CHUNKS = [1, 7, 1436, 4096, 16384]
+
+
+def compress(data, window_bits=WINDOW_BITS):
+    # wbits 16+N: gzip-Container, mtime=0 im Header (reproduzierbar)
+    c = zlib.compressobj(9, zlib.DEFLATED, 16 + window_bits, 9)
+    return c.compress(data) + c.flush()
+
+
+def decompress_chunked(gz, chunk, window_bits=WINDOW_BITS):
+    d = zlib.decompressobj(16 + window_bits)
+    out = bytearray()
+    for off in range(0, len(gz), chunk):
+        out += d.decompress(gz[off:off + chunk])
+    out += d.flush()
+    if not d.eof:
+        raise ValueError("Stream unvollständig")
+    if d.unused_data:
+        raise ValueError(f"{len(d.unused_data)} Byte nach Stream-Ende")
+    return bytes(out)
+
+
+def cmd_compress(src, dst, window_bits):
+    data = Path(src).read_bytes()
+    gz = compress(data, window_bits)
+    Path(dst).write_bytes(gz)
+    print(f"{Path(src).name}: {len(data)} -> {len(gz)} Byte ({100 * len(gz) / len(data):.1f}%, "
+          f"Fenster {1 << window_bits} Byte)")
+    return 0
+
+
+def cmd_check(gz_path, ref_path, chunks, window_bits):
+    gz = Path(gz_path).read_bytes()
+    ref = Path(ref_path).read_bytes()
+    ok = True
+    if gz[:2] != b'\x1f\x8b':
+        print("FEHLER: kein gzip-Magic")
+        return 1
+    for chunk in chunks:
+        try:
+            out = decompress_chunked(gz, chunk, window_bits)
+            status = "OK" if out == ref else "FEHLER: Inhalt weicht ab"
+        except (zlib.error, ValueError) as e:
+            status = f"FEHLER: {e}"
+        ok &= status == "OK"
+        print(f"Stückelung {chunk:6d} Byte: {status}")
+
+    # Trailer wie auf dem Gerät prüfen (CRC32 + ISIZE)
+    crc, isize = int.from_bytes(gz[-8:-4], 'little'), int.from_bytes(gz[-4:], 'little')
+    if crc != zlib.crc32(ref) or isize != len(ref) & 0xFFFFFFFF:
+        print("FEHLER: Trailer (CRC32/ISIZE) passt nicht")
+        ok = False
+    print(f"{len(ref)} -> {len(gz)} Byte ({100 * len(gz) / len(ref):.1f}%), "
+          f"SHA-256 (dekomprimiert) {hashlib.sha256(ref).hexdigest()}")
+    return 0 if ok else 1
+
+
+def main():
+    parser = argparse.ArgumentParser(description="gzip-OTA-Images erzeugen und prüfen")
+    parser.add_argument('--window-bits', type=int, default=WINDOW_BITS, help="muss OTA_GZ_WINDOW_BITS entsprechen")
+    sub = parser.add_subparsers(dest='cmd', required=True)
+    p = sub.add_parser('compress')
+    p.add_argument('src')
+    p.add_argument('dst')
+    p = sub.add_parser('check')
+    p.add_argument('gz')
+    p.add_argument('ref')
+    p.add_argument('--chunks', default=','.join(map(str, DEFAULT_CHUNKS)))
+    args = parser.parse_args()
+
+    if args.cmd == 'compress':
+        return cmd_compress(args.src, args.dst, args.window_bits)
+    return cmd_check(args.gz, args.ref, [int(c) for c in args.chunks.split(',')], args.window_bits)
+
+
+if __name__ == '__main__':
+    sys.exit(main())
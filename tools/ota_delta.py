@@ -0,0 +1,198 @@
+#!/usr/bin/env python3
+"""
+Delta-Updates für den LIN-Proxy (Gegenstück zu ota_delta_update_from_url in ota.c)
+
+  ota_delta.py diff <alt.bin> <neu.bin> <patch.delta>   Patch erzeugen
+  ota_delta.py apply <alt.bin> <patch.delta> <neu.bin>  Patch anwenden (wie der ESP32)
+  ota_delta.py info <patch.delta>                       Kopf und Operationen anzeigen
+
+Der ESP32 lädt den Patch von "<FW_UPDATE_URL>.from-<FW_VERSION>.delta", also z.B.:
+
+  python3 tools/ota_delta.py diff firmware-1.0.0.bin .pio/build/esp32dev/firmware.bin \\
+      .pio/build/esp32dev/firmware.bin.from-1.0.0.delta
+
+Format (Little Endian, siehe ota_delta_hdr_t in ota.h): 80-Byte-Kopf, danach
+COPY (Bytes aus der laufenden Partition) und INSERT (neue Bytes) bis END.
+"""
+
+import hashlib
+import struct
+import sys
+from pathlib import Path
+
+MAGIC = 0x544C444C          # "LDLT"
+VERSION = 1
+HEADER = struct.Struct('<IHHII32s32s')
+
+OP_END = 0
+OP_COPY = 1
+OP_INSERT = 2
+
+BLOCK = 32                  # Mindestlänge eines COPY
+ALIGN = 4                   # Index im alten Image nur an 4-Byte-Grenzen (Code/Daten sind ausgerichtet)
+
+
+def build_index(old):
+    index = {}
+    for off in range(0, len(old) - BLOCK + 1, ALIGN):
+        index.setdefault(old[off:off + BLOCK], off)
+    return index
+
+
+def match_length(old, new, o, n):
+    length = 0
+    limit = min(len(old) - o, len(new) - n)
+    # In 64-Byte-Schritten vergleichen, dann byteweise
+    while length + 64 <= limit and old[o + length:o + length + 64] == new[n + length:n + length + 64]:
+        length += 64
+    while length < limit and old[o + length] == new[n + length]:
+        length += 1
+    return length
+
+
+def diff(old, new):
+    """Liefert Liste von (OP_COPY, offset, len) und (OP_INSERT, bytes)."""
+    index = build_index(old)
+    ops = []
+    literal = bytearray()
+    n = 0
+    # Nächster Treffer liegt meist direkt hinter dem letzten COPY (gleiche Verschiebung)
+    expect = None
+    while n < len(new):
+        best_off, best_len = None, 0
+        if expect is not None and expect < len(old):
+            length = match_length(old, new, expect, n)
+            if length >= BLOCK:
+                best_off, best_len = expect, length
+        if best_off is None and n + BLOCK <= len(new):
+            off = index.get(bytes(new[n:n + BLOCK]))
+            if off is not None:
+                best_off, best_len = off, match_length(old, new, off, n)
+
+        if best_off is None or best_len < BLOCK:
+            literal.append(new[n])
+            n += 1
+            continue
+
+        # Treffer rückwärts in die ausstehenden Literale verlängern
+        back = 0
+        while back < len(literal) and best_off - back > 0 and old[best_off - back - 1] == literal[-back - 1]:
+            back += 1
+        if back:
+            del literal[-back:]
+        if literal:
+            ops.append((OP_INSERT, bytes(literal)))
+            literal.clear()
+        ops.append((OP_COPY, best_off - back, best_len + back))
+        n += best_len
+        expect = best_off + best_len
+    if literal:
+        ops.append((OP_INSERT, bytes(literal)))
+    return ops
+
+
+def encode(old, new, ops):
+    out = bytearray(HEADER.pack(MAGIC, VERSION, 0, len(old), len(new),
+                                hashlib.sha256(old).digest(), hashlib.sha256(new).digest()))
+    for op in ops:
+        if op[0] == OP_COPY:
+            out += struct.pack('<BII', OP_COPY, op[1], op[2])
+        else:
+            out += struct.pack('<BI', OP_INSERT, len(op[1])) + op[1]
+    out += bytes([OP_END])
+    return bytes(out)
+
+
+def parse(patch):
+    magic, version, _flags, src_size, dst_size, src_sha, dst_sha = HEADER.unpack_from(patch)
+    if magic != MAGIC or version != VERSION:
+        raise ValueError(f"Kein Delta-Patch (magic {magic:#x}, v{version})")
+    pos = HEADER.size
+    ops = []
+    while True:
+        op = patch[pos]
+        pos += 1
+        if op == OP_END:
+            break
+        if op == OP_COPY:
+            off, length = struct.unpack_from('<II', patch, pos)
+            pos += 8
+            ops.append((OP_COPY, off, length))
+        elif op == OP_INSERT:
+            (length,) = struct.unpack_from('<I', patch, pos)
+            pos += 4
+            ops.append((OP_INSERT, patch[pos:pos + length]))
+            pos += length
+        else:
+            raise ValueError(f"Unbekannte Operation {op} bei Offset {pos - 1}")
+    return (src_size, dst_size, src_sha, dst_sha), ops
+
+
+def apply(old, patch):
+    (src_size, dst_size, src_sha, dst_sha), ops = parse(patch)
+    if hashlib.sha256(old[:src_size]).digest() != src_sha:
+        raise ValueError("Quell-Image passt nicht zum Patch")
+    out = bytearray()
+    for op in ops:
+        if op[0] == OP_COPY:
+            if op[1] + op[2] > src_size:
+                raise ValueError("COPY außerhalb des Quell-Images")
+            out += old[op[1]:op[1] + op[2]]
+        else:
+            out += op[1]
+    if len(out) != dst_size or hashlib.sha256(out).digest() != dst_sha:
+        raise ValueError("Ziel-Hash stimmt nicht")
+    return bytes(out)
+
+
+def cmd_diff(old_path, new_path, patch_path):
+    old = Path(old_path).read_bytes()
+    new = Path(new_path).read_bytes()
+    patch = encode(old, new, diff(old, new))
+    # Gegenprobe: Patch muss exakt das neue Image ergeben
+    if apply(old, patch) != new:
+        print("FEHLER: Gegenprobe fehlgeschlagen")
+        return 1
+    Path(patch_path).write_bytes(patch)
+    print(f"{Path(new_path).name}: {len(new)} Byte -> Patch {len(patch)} Byte "
+          f"({100 * len(patch) / len(new):.1f}%)")
+    return 0
+
+
+def cmd_apply(old_path, patch_path, out_path):
+    try:
+        new = apply(Path(old_path).read_bytes(), Path(patch_path).read_bytes())
+    except ValueError as e:
+        print(f"FEHLER: {e}")
+        return 1
+    Path(out_path).write_bytes(new)
+    print(f"{out_path}: {len(new)} Byte, SHA-256 {hashlib.sha256(new).hexdigest()}")
+    return 0
+
+
+def cmd_info(patch_path):
+    patch = Path(patch_path).read_bytes()
+    (src_size, dst_size, src_sha, dst_sha), ops = parse(patch)
+    copies = [op for op in ops if op[0] == OP_COPY]
+    inserts = [op for op in ops if op[0] == OP_INSERT]
+    print(f"Quelle: {src_size} Byte, SHA-256 {src_sha.hex()}")
+    print(f"Ziel:   {dst_size} Byte, SHA-256 {dst_sha.hex()}")
+    print(f"COPY:   {len(copies)} Operationen, {sum(op[2] for op in copies)} Byte")
+    print(f"INSERT: {len(inserts)} Operationen, {sum(len(op[1]) for op in inserts)} Byte")
+    print(f"Patch:  {len(patch)} Byte ({100 * len(patch) / max(dst_size, 1):.1f}% des Ziel-Images)")
+    return 0
+
+
+def main():
+    if len(sys.argv) == 5 and sys.argv[1] == 'diff':
+        return cmd_diff(*sys.argv[2:])
+    if len(sys.argv) == 5 and sys.argv[1] == 'apply':
+        return cmd_apply(*sys.argv[2:])
+    if len(sys.argv) == 3 and sys.argv[1] == 'info':
+        return cmd_info(sys.argv[2])
+    print(__doc__)
+    return 2
+
+
+if __name__ == '__main__':
+    sys.exit(main())
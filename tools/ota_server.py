@@ -0,0 +1,166 @@
+#!/usr/bin/env python3
+"""
+Lokaler OTA-Server als Ersatz für den Update-Server (statt python3 -m http.server)
+
+Liefert firmware.bin und firmware.bin.version aus einem Verzeichnis und
+unterstützt, was der ESP32 beim Update nutzt:
+  - ETag / Last-Modified mit If-None-Match / If-Modified-Since (304)
+  - Range / If-Range (206) zum Fortsetzen abgebrochener Downloads
+
+Zum Testen der Fortsetzung bricht --drop-after die ersten --drops Downloads
+nach N Byte ab:
+
+  python3 tools/ota_server.py .pio/build/esp32dev --port 8080 --drop-after 200000 --drops 2
+"""
+
+import argparse
+import hashlib
+import os
+import re
+import time
+from email.utils import formatdate, parsedate_to_datetime
+from functools import partial
+from http.server import SimpleHTTPRequestHandler, ThreadingHTTPServer
+
+CHUNK = 16384
+
+
+class OtaHandler(SimpleHTTPRequestHandler):
+    drop_after = 0
+    drops_left = 0
+    rate_kbps = 0
+
+    def do_HEAD(self):
+        self.serve(head=True)
+
+    def do_GET(self):
+        self.serve(head=False)
+
+    def serve(self, head):
+        path = self.translate_path(self.path)
+        if not os.path.isfile(path):
+            self.send_error(404)
+            return
+
+        st = os.stat(path)
+        size = st.st_size
+        with open(path, 'rb') as f:
+            etag = '"%s"' % hashlib.sha256(f.read()).hexdigest()[:16]
+        last_modified = formatdate(st.st_mtime, usegmt=True)
+
+        if self.not_modified(etag, st.st_mtime):
+            self.send_response(304)
+            self.send_header('ETag', etag)
+            self.send_header('Last-Modified', last_modified)
+            self.end_headers()
+            return
+
+        start, end = self.parse_range(size, etag)
+        partial_resp = (start, end) != (0, size - 1)
+        if start is None:
+            self.send_response(416)
+            self.send_header('Content-Range', f'bytes */{size}')
+            self.end_headers()
+            return
+
+        self.send_response(206 if partial_resp else 200)
+        self.send_header('Content-Type', 'application/octet-stream')
+        self.send_header('Content-Length', str(end - start + 1))
+        self.send_header('Accept-Ranges', 'bytes')
+        self.send_header('ETag', etag)
+        self.send_header('Last-Modified', last_modified)
+        if partial_resp:
+            self.send_header('Content-Range', f'bytes {start}-{end}/{size}')
+        self.end_headers()
+        if head:
+            return
+
+        self.send_body(path, start, end)
+
+    def not_modified(self, etag, mtime):
+        inm = self.headers.get('If-None-Match')
+        if inm is not None:
+            return etag in [t.strip() for t in inm.split(',')] or inm.strip() == '*'
+        ims = self.headers.get('If-Modified-Since')
+        if ims:
+            try:
+                return int(mtime) <= parsedate_to_datetime(ims).timestamp()
+            except (TypeError, ValueError):
+                return False
+        return False
+
+    def parse_range(self, size, etag):
+        rng = self.headers.get('Range')
+        if not rng:
+            return 0, size - 1
+        # If-Range passt nicht mehr: vollständiges (neues) Image liefern
+        if_range = self.headers.get('If-Range')
+        if if_range and if_range.strip() != etag:
+            return 0, size - 1
+        m = re.fullmatch(r'bytes=(\d*)-(\d*)', rng.strip())
+        if not m or (not m.group(1) and not m.group(2)):
+            return 0, size - 1
+        if m.group(1):
+            start = int(m.group(1))
+            end = int(m.group(2)) if m.group(2) else size - 1
+        else:
+            start = max(size - int(m.group(2)), 0)
+            end = size - 1
+        if start >= size or end < start:
+            return None, None
+        return start, min(end, size - 1)
+
+    def send_body(self, path, start, end):
+        remaining = end - start + 1
+        limit = None
+        if self.drop_after and OtaHandler.drops_left > 0 and path.endswith('.bin'):
+            OtaHandler.drops_left -= 1
+            limit = self.drop_after
+        sent = 0
+        with open(path, 'rb') as f:
+            f.seek(start)
+            while remaining > 0:
+                n = min(CHUNK, remaining)
+                if limit is not None and sent + n > limit:
+                    n = limit - sent
+                    self.wfile.write(f.read(n))
+                    self.log_message("Verbindung nach %d Byte absichtlich getrennt", sent + n)
+                    self.close_connection = True
+                    self.connection.shutdown(2)
+                    return
+                self.wfile.write(f.read(n))
+                sent += n
+                remaining -= n
+                if self.rate_kbps:
+                    time.sleep(n / (self.rate_kbps * 1024))
+
+    def log_message(self, fmt, *args):
+        rng = self.headers.get('Range') if hasattr(self, 'headers') and self.headers else None
+        extra = f" [Range {rng}]" if rng else ""
+        print(f"{self.address_string()} - {fmt % args}{extra}")
+
+
+def main():
+    parser = argparse.ArgumentParser(description="OTA-Testserver mit ETag, 304 und Range")
+    parser.add_argument('directory', nargs='?', default='.', help="Verzeichnis mit firmware.bin(.version)")
+    parser.add_argument('--port', type=int, default=8080)
+    parser.add_argument('--drop-after', type=int, default=0, help="Download nach N Byte abbrechen")
+    parser.add_argument('--drops', type=int, default=1, help="Anzahl abgebrochener Downloads")
+    parser.add_argument('--rate', type=int, default=0, help="Senderate in KB/s (0 = unbegrenzt)")
+    args = parser.parse_args()
+
+    OtaHandler.drop_after = args.drop_after
+    OtaHandler.drops_left = args.drops if args.drop_after else 0
+    OtaHandler.rate_kbps = args.rate
+
+    handler = partial(OtaHandler, directory=args.directory)
+    server = ThreadingHTTPServer(('0.0.0.0', args.port), handler)
+    print(f"OTA-Server auf Port {args.port}, Verzeichnis {os.path.abspath(args.directory)}")
+    try:
+        server.serve_forever()
+    except KeyboardInterrupt:
+        print("\nServer wird beendet...")
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,16 @@
+# PlatformIO-Hook (extra_scripts): nach dem Build firmware.bin.gz erzeugen,
+# analog zum ota_image_gz-Target in CMakeLists.txt
+Import("env")
+
+import os
+import subprocess
+import sys
+
+
+def compress_firmware(source, target, env):
+    firmware = str(target[0])
+    tool = os.path.join(env.subst("$PROJECT_DIR"), "tools", "ota_compress.py")
+    subprocess.check_call([sys.executable, tool, "compress", firmware, firmware + ".gz"])
+
+
+env.AddPostAction("$BUILD_DIR/${PROGNAME}.bin", compress_firmware)
@@ -0,0 +1,92 @@
+#!/usr/bin/env python3
+"""
+Asset-Pipeline für das Web-Interface (src/www -> gzip im Flash)
+
+  web_assets.py compress <quelle> <ziel.gz>   wird vom CMake-Build aufgerufen
+  web_assets.py check [<quelle> ...]          prüft die Pipeline auf dem Host
+
+Die Ausgabe ist deterministisch (kein Dateiname, mtime=0 im gzip-Header),
+damit sich ETag und Firmware-Image nur ändern, wenn sich der Inhalt ändert.
+"""
+
+import gzip
+import hashlib
+import io
+import sys
+from pathlib import Path
+
+WWW_DIR = Path(__file__).resolve().parent.parent / "src" / "www"
+
+
+def minify(text):
+    """Einrückung, Leerzeilen und ganzzeilige //-Kommentare entfernen."""
+    lines = []
+    for line in text.splitlines():
+        line = line.strip()
+        if not line or line.startswith('//'):
+            continue
+        lines.append(line)
+    return '\n'.join(lines) + '\n'
+
+
+def compress(data):
+    buf = io.BytesIO()
+    # filename='' und mtime=0: reproduzierbarer Header
+    with gzip.GzipFile(filename='', mode='wb', fileobj=buf, compresslevel=9, mtime=0) as gz:
+        gz.write(data)
+    return buf.getvalue()
+
+
+def build(src):
+    return compress(minify(Path(src).read_text(encoding='utf-8')).encode('utf-8'))
+
+
+def cmd_compress(src, dst):
+    out = build(src)
+    dst = Path(dst)
+    # Nur schreiben wenn geändert, sonst baut CMake unnötig neu
+    if not dst.exists() or dst.read_bytes() != out:
+        dst.write_bytes(out)
+    return 0
+
+
+def cmd_check(sources):
+    if not sources:
+        sources = sorted(WWW_DIR.glob('*.html'))
+    ok = True
+    for src in sources:
+        src = Path(src)
+        raw = src.read_bytes()
+        out = build(src)
+        errors = []
+
+        if out != build(src):
+            errors.append("nicht deterministisch")
+        if out[4:8] != b'\0\0\0\0':
+            errors.append("mtime im gzip-Header gesetzt")
+        text = gzip.decompress(out).decode('utf-8')
+        if text != minify(raw.decode('utf-8')):
+            errors.append("Dekompression ergibt nicht die Quelle")
+        for tag in ('<html', '</html>', '<script>', '</script>'):
+            if text.count(tag) != raw.decode('utf-8').count(tag):
+                errors.append(f"Tag {tag} durch Minify verändert")
+
+        etag = hashlib.sha256(out).hexdigest()[:16]
+        status = "OK" if not errors else "FEHLER: " + ", ".join(errors)
+        print(f"{src.name:<16} {len(raw):6d} -> {len(out):6d} Byte "
+              f"({100 * len(out) / len(raw):4.1f}%)  ETag \"{etag}\"  {status}")
+        ok &= not errors
+    return 0 if ok else 1
+
+
+def main():
+    if len(sys.argv) == 4 and sys.argv[1] == 'compress':
+        return cmd_compress(sys.argv[2], sys.argv[3])
+    if len(sys.argv) >= 2 and sys.argv[1] == 'check':
+        return cmd_check(sys.argv[2:])
+    print(__doc__)
+    return 2
+
+
+if __name__ == '__main__':
+    sys.exit(main())